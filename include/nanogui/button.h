@@ -58,43 +58,43 @@ public:
     const std::string &caption() const { return mCaption; }
 
     /// Sets the caption of this Button.
-    void setCaption(const std::string &caption) { mCaption = caption; }
+    void setCaption(const std::string &caption) { mCaption = caption; invalidateLayout(); markDirty(); }
 
     /// Returns the background color of this Button.
     const Color &backgroundColor() const { return mBackgroundColor; }
 
     /// Sets the background color of this Button.
-    void setBackgroundColor(const Color &backgroundColor) { mBackgroundColor = backgroundColor; }
+    void setBackgroundColor(const Color &backgroundColor) { mBackgroundColor = backgroundColor; markDirty(); }
 
     /// Returns the text color of the caption of this Button.
     const Color &textColor() const { return mTextColor; }
 
     /// Sets the text color of the caption of this Button.
-    void setTextColor(const Color &textColor) { mTextColor = textColor; }
+    void setTextColor(const Color &textColor) { mTextColor = textColor; markDirty(); }
 
     /// Returns the icon of this Button.  See \ref nanogui::Button::mIcon.
     int icon() const { return mIcon; }
 
     /// Sets the icon of this Button.  See \ref nanogui::Button::mIcon.
-    void setIcon(int icon) { mIcon = icon; }
+    void setIcon(int icon) { mIcon = icon; invalidateLayout(); markDirty(); }
 
     /// The current flags of this Button (see \ref nanogui::Button::Flags for options).
     int flags() const { return mFlags; }
 
     /// Sets the flags of this Button (see \ref nanogui::Button::Flags for options).
-    void setFlags(int buttonFlags) { mFlags = buttonFlags; }
+    void setFlags(int buttonFlags) { mFlags = buttonFlags; markDirty(); }
 
     /// The position of the icon for this Button.
     IconPosition iconPosition() const { return mIconPosition; }
 
     /// Sets the position of the icon for this Button.
-    void setIconPosition(IconPosition iconPosition) { mIconPosition = iconPosition; }
+    void setIconPosition(IconPosition iconPosition) { mIconPosition = iconPosition; markDirty(); }
 
     /// Whether or not this Button is currently pushed.
     bool pushed() const { return mPushed; }
 
     /// Sets whether or not this Button is currently pushed.
-    void setPushed(bool pushed) { mPushed = pushed; }
+    void setPushed(bool pushed) { mPushed = pushed; markDirty(); }
 
     /// The current callback to execute (for any type of button).
     std::function<void()> callback() const { return mCallback; }
@@ -52,19 +52,19 @@ public:
     const std::string &caption() const { return mCaption; }
 
     /// Sets the caption of this CheckBox.
-    void setCaption(const std::string &caption) { mCaption = caption; }
+    void setCaption(const std::string &caption) { mCaption = caption; invalidateLayout(); markDirty(); }
 
     /// Whether or not this CheckBox is currently checked.
     const bool &checked() const { return mChecked; }
 
     /// Sets whether or not this CheckBox is currently checked.
-    void setChecked(const bool &checked) { mChecked = checked; }
+    void setChecked(const bool &checked) { mChecked = checked; markDirty(); }
 
     /// Whether or not this CheckBox is currently pushed.  See \ref nanogui::CheckBox::mPushed.
     const bool &pushed() const { return mPushed; }
 
     /// Sets whether or not this CheckBox is currently pushed.  See \ref nanogui::CheckBox::mPushed.
-    void setPushed(const bool &pushed) { mPushed = pushed; }
+    void setPushed(const bool &pushed) { mPushed = pushed; markDirty(); }
 
     /// Returns the current callback of this CheckBox.
     std::function<void(bool)> callback() const { return mCallback; }
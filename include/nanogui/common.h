@@ -131,6 +131,12 @@ enum class Cursor {
     CursorCount ///< Not a cursor --- should always be last: enables a loop over the cursor types.
 };
 
+/// Caching strategies for the drawing output of a widget subtree (see \ref Widget::setCacheMode()).
+enum class CacheMode {
+    Disabled = 0, ///< Draw the subtree from scratch in every frame.
+    Retained      ///< Record the tessellated output once and replay it while the subtree is unchanged.
+};
+
 /* Import some common Eigen types */
 /// Type alias to allow ``Eigen::Vector2f`` to be used as ``nanogui::Vector2f``.
 using Vector2f = Eigen::Vector2f;
@@ -138,6 +144,8 @@ using Vector2f = Eigen::Vector2f;
 using Vector3f = Eigen::Vector3f;
 /// Type alias to allow ``Eigen::Vector4f`` to be used as ``nanogui::Vector4f``.
 using Vector4f = Eigen::Vector4f;
+/// Type alias to allow ``Eigen::Vector2d`` to be used as ``nanogui::Vector2d``.
+using Vector2d = Eigen::Vector2d;
 /// Type alias to allow ``Eigen::Vector2i`` to be used as ``nanogui::Vector2i``.
 using Vector2i = Eigen::Vector2i;
 /// Type alias to allow ``Eigen::Vector3i`` to be used as ``nanogui::Vector3i``.
@@ -371,26 +379,38 @@ class CheckBox;
 class ColorWheel;
 class ColorPicker;
 class ComboBox;
+class DrawCache;
+class FrameProfiler;
 class GLFramebuffer;
 class GLShader;
+class Graph;
 class GridLayout;
 class GroupLayout;
 class ImagePanel;
 class ImageView;
 class Label;
 class Layout;
+class MappedImageSource;
 class MessageDialog;
 class Object;
+class Plot;
 class Popup;
 class PopupButton;
 class ProgressBar;
 class Screen;
 class Serializer;
 class Slider;
+class SpatialIndex;
 class StackedWidget;
 class TabHeader;
 class TabWidget;
 class TextBox;
+class TextMetricsCache;
+class TextureAtlas;
+class ThreadPool;
+class ThumbnailLoader;
+class TileCache;
+class TiledImageSource;
 class GLCanvas;
 class Theme;
 class ToolButton;
@@ -421,9 +441,15 @@ extern NANOGUI_EXPORT void shutdown();
  *
  * \param refresh
  *     NanoGUI issues a redraw call whenever an keyboard/mouse/.. event is
- *     received. In the absence of any external events, it enforces a redraw
- *     once every ``refresh`` milliseconds. To disable the refresh timer,
- *     specify a negative value here.
+ *     received, a widget is dirty (see \ref Widget::markDirty()), an
+ *     animation frame was requested (see \ref Screen::requestAnimationFrame())
+ *     or a scheduled redraw is due (see \ref Widget::scheduleRedrawAt()).
+ *     Animations are drawn at the refresh rate of the display, and the loop
+ *     sleeps while there is nothing to do. Screens without any dirty widgets
+ *     are not redrawn. When ``refresh`` is positive, the loop additionally
+ *     wakes up at least once every ``refresh`` milliseconds, which supports
+ *     applications that modify the user interface from other threads
+ *     without calling ``glfwPostEmptyEvent()``.
  *
  * \param detach
  *     This parameter only exists in the Python bindings. When the active
@@ -452,7 +478,7 @@ extern NANOGUI_EXPORT void shutdown();
  *     wait for the termination of the main loop and then swap the two thread
  *     environments back into their initial configuration.
  */
-extern NANOGUI_EXPORT void mainloop(int refresh = 50);
+extern NANOGUI_EXPORT void mainloop(int refresh = -1);
 
 /// Request the application main loop to terminate (e.g. if you detached mainloop).
 extern NANOGUI_EXPORT void leave();
@@ -517,7 +543,15 @@ extern NANOGUI_EXPORT void chdir_to_bundle_parent();
  */
 extern NANOGUI_EXPORT std::array<char, 8> utf8(int c);
 
-/// Load a directory of PNG images and upload them to the GPU (suitable for use with ImagePanel)
+/// Return the paths of the PNG images in a directory
+extern NANOGUI_EXPORT std::vector<std::string> listImageDirectory(const std::string &path);
+
+/**
+ * \brief Load a directory of PNG images and upload them to the GPU (suitable for use with ImagePanel)
+ *
+ * All images are decoded on the calling thread before the function returns.
+ * See \ref ImagePanel::loadDirectory() for asynchronous loading of thumbnails.
+ */
 extern NANOGUI_EXPORT std::vector<std::pair<int, std::string>>
     loadImageDirectory(NVGcontext *ctx, const std::string &path);
 
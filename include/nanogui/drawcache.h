@@ -0,0 +1,99 @@
+/*
+    nanogui/drawcache.h -- Recording and replay of tessellated NanoVG output
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <array>
+#include <functional>
+
+struct NVGparams;
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class DrawCache drawcache.h nanogui/drawcache.h
+ *
+ * \brief Records the tessellated output of NanoVG draw calls for later replay.
+ *
+ * While recording, the render callbacks of the NanoVG context are
+ * intercepted: the paint, scissor and vertex data of every fill, stroke and
+ * triangle batch (including text) is copied before being passed on to the
+ * renderer as usual. Replaying submits these copies directly to the
+ * renderer, which skips path construction, flattening, tessellation and
+ * text layout altogether.
+ *
+ * The recorded vertices are in absolute coordinates, hence a recording is
+ * tagged with a user-provided \ref Key (e.g. the transform and clip region
+ * that were active while recording) and should only be replayed when the
+ * key still matches. Recording and replaying must happen on the thread that
+ * draws the NanoVG frame; recordings may be nested.
+ *
+ * This is the mechanism behind \ref Widget::setCacheMode().
+ */
+class NANOGUI_EXPORT DrawCache {
+public:
+    /// Identifies the conditions under which a recording was made
+    using Key = std::array<float, 11>;
+
+    DrawCache();
+    ~DrawCache();
+
+    /// Start recording all draw calls issued through \c ctx
+    void begin(NVGcontext *ctx, const Key &key);
+
+    /**
+     * \brief Stop recording
+     *
+     * Returns \c false if the output could not be captured, which is the
+     * case when the NanoVG frame was flushed while recording (e.g. by a
+     * \ref GLCanvas that issues OpenGL calls of its own). Such a cache
+     * stays invalid until \ref clear() is called.
+     */
+    bool end();
+
+    /// Check whether the cache contains a usable recording for the given key
+    bool valid(const Key &key) const { return mValid && key == mKey; }
+
+    /// Check whether an earlier recording with the current contents failed
+    bool failed() const { return mFailed; }
+
+    /**
+     * \brief Submit the recorded draw calls to \c ctx
+     *
+     * Returns \c false without drawing anything if one of the referenced
+     * images (e.g. a font atlas that has since been resized) no longer exists.
+     */
+    bool replay(NVGcontext *ctx) const;
+
+    /// Discard the recording
+    void clear();
+
+    /// Return the number of recorded draw calls
+    size_t size() const { return mCalls.size(); }
+
+protected:
+    friend struct DrawCacheHooks;
+    using Call = std::function<void(NVGparams *)>;
+
+    std::vector<Call> mCalls;
+    std::vector<int> mImages;
+    Key mKey;
+    bool mValid, mFailed;
+
+    /* State while recording */
+    NVGcontext *mContext;
+    NVGparams *mForward;
+    DrawCache *mParent;
+};
+
+NAMESPACE_END(nanogui)
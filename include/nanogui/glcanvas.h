@@ -55,10 +55,10 @@ public:
     const Color &backgroundColor() const { return mBackgroundColor; }
 
     /// Sets the background color.
-    void setBackgroundColor(const Color &backgroundColor) { mBackgroundColor = backgroundColor; }
+    void setBackgroundColor(const Color &backgroundColor) { mBackgroundColor = backgroundColor; markDirty(); }
 
     /// Set whether to draw the widget border or not.
-    void setDrawBorder(const bool bDrawBorder) { mDrawBorder = bDrawBorder; }
+    void setDrawBorder(const bool bDrawBorder) { mDrawBorder = bDrawBorder; markDirty(); }
 
     /// Return whether the widget border gets drawn or not.
     const bool &drawBorder() const { return mDrawBorder; }
@@ -14,7 +14,10 @@
 
 #include <nanogui/opengl.h>
 #include <Eigen/Geometry>
+#include <cstring>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 namespace half_float { class half; }
@@ -25,6 +28,11 @@ namespace half_float { class half; }
     #define GL_HALF_FLOAT 0x140B
 #endif
 
+#if !defined(GL_COMPLETION_STATUS_KHR) || defined(DOXYGEN_DOCUMENTATION_BUILD)
+    /// Query of ``KHR_parallel_shader_compile``, which is not part of all OpenGL headers.
+    #define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
 NAMESPACE_BEGIN(nanogui)
 
 // bypass template specializations
@@ -78,12 +86,33 @@ public:
         GLuint compSize;///< The size (in bytes) of an individual element in this buffer.
         GLuint size;    ///< The total number of elements represented by this buffer.
         int version;    ///< The current version if this buffer.
+        size_t offset;  ///< The byte offset of the current data (nonzero for streamed attributes).
+    };
+
+    /**
+     * \struct UniformHandle glutil.h nanogui/glutil.h
+     *
+     * A pre-resolved reference to a uniform of a linked shader, as returned
+     * by \ref GLShader::uniformHandle.
+     */
+    struct UniformHandle {
+        int index;  ///< The index into the introspected uniforms (-1 if invalid).
+
+        explicit UniformHandle(int index = -1) : index(index) { }
+
+        /// Return whether the handle refers to an active uniform
+        bool valid() const { return index >= 0; }
     };
 
+    /// The number of segments of the ring buffers used by \ref streamAttrib.
+    static constexpr int StreamSegments = 3;
+
     /// Create an unitialized OpenGL shader
     GLShader()
         : mVertexShader(0), mFragmentShader(0), mGeometryShader(0),
-          mProgramShader(0), mVertexArrayObject(0) { }
+          mProgramShader(0), mVertexArrayObject(0), mIndexOffset(0),
+          mCompileTime(0), mLinkTime(0), mLoadedFromBinary(false),
+          mPending(false), mBinaryKey(0) { }
 
     /**
      * \brief Initialize the shader using the specified source strings.
@@ -105,6 +134,30 @@ public:
               const std::string &fragment_str,
               const std::string &geometry_str = "");
 
+    /**
+     * \brief Start compiling and linking the shader without waiting for the result
+     *
+     * Takes the same arguments as \ref init, but does not query the status
+     * of the compilation, which lets the driver process several programs
+     * in parallel (with ``KHR_parallel_shader_compile``) or on a background
+     * thread. The status is checked (and compilation errors are thrown) by
+     * \ref ready once it reports completion, or at the latest when the shader
+     * is first bound or its uniforms or attributes are accessed, which
+     * blocks until the program is linked.
+     */
+    bool initAsync(const std::string &name, const std::string &vertex_str,
+                   const std::string &fragment_str,
+                   const std::string &geometry_str = "");
+
+    /**
+     * \brief Return whether the program is ready to be used without blocking
+     *
+     * Always \c true after \ref init. After \ref initAsync, this polls the
+     * driver if it supports ``KHR_parallel_shader_compile``; otherwise, it
+     * finishes the initialization (which may block) and returns \c true.
+     */
+    bool ready();
+
     /**
      * \brief Initialize the shader using the specified files on disk.
      *
@@ -130,6 +183,35 @@ public:
     /// Return the name of the shader
     const std::string &name() const { return mName; }
 
+    /**
+     * \brief Set the directory of the program binary cache (empty to disable it)
+     *
+     * When enabled, \ref init stores the binary of every linked program in
+     * this directory (which must exist), and later creates programs with
+     * identical sources, definitions and driver (vendor, renderer and
+     * version) from their binaries instead of compiling them. Binaries that
+     * the driver rejects are silently replaced. Requires support for
+     * ``glProgramBinary`` (OpenGL 4.1 or ``ARB_get_program_binary``) and is
+     * ignored on other contexts.
+     */
+    static void setBinaryCacheDirectory(const std::string &path);
+
+    /// Return the directory of the program binary cache (empty if disabled)
+    static const std::string &binaryCacheDirectory();
+
+    /**
+     * \brief Return the time in seconds that the calling thread spent compiling the shaders
+     *
+     * This includes submitting the sources and waiting for the compile status.
+     */
+    double compileTime() const { return mCompileTime; }
+
+    /// Return the time in seconds that the calling thread spent waiting for the link status (or loading the binary)
+    double linkTime() const { return mLinkTime; }
+
+    /// Return whether \ref init created the program from the binary cache
+    bool loadedFromBinary() const { return mLoadedFromBinary; }
+
     /**
      * Set a preprocessor definition.  Custom preprocessor definitions must be
      * added **before** initializing the shader (e.g., via \ref initFromFiles).
@@ -152,7 +234,12 @@ public:
     /// Return the handle of a uniform attribute (-1 if it does not exist)
     GLint uniform(const std::string &name, bool warn = true) const;
 
-    /// Upload an Eigen matrix as a vertex buffer object (refreshing it as needed)
+    /**
+     * \brief Upload an Eigen matrix as a vertex buffer object (refreshing it as needed)
+     *
+     * If the attribute already exists with the same size in bytes, its data
+     * is replaced in place instead of reallocating the buffer.
+     */
     template <typename Matrix> void uploadAttrib(const std::string &name, const Matrix &M, int version = -1) {
         uint32_t compSize = sizeof(typename Matrix::Scalar);
         GLuint glType = (GLuint) detail::type_traits<typename Matrix::Scalar>::type;
@@ -162,6 +249,50 @@ public:
                      glType, integral, M.data(), version);
     }
 
+    /**
+     * \brief Overwrite the columns <tt>[offset, offset + M.cols())</tt> of an attribute
+     *
+     * The attribute must have been uploaded with the same number of rows and
+     * scalar type, and must cover the given columns. Only the affected part
+     * of the buffer is sent to the GPU.
+     */
+    template <typename Matrix> void updateAttrib(const std::string &name, const Matrix &M, size_t offset) {
+        uint32_t compSize = sizeof(typename Matrix::Scalar);
+        GLuint glType = (GLuint) detail::type_traits<typename Matrix::Scalar>::type;
+
+        updateAttrib(name, offset * (size_t) M.rows(), (size_t) M.size(), (int) M.rows(),
+                     compSize, glType, M.data());
+    }
+
+    /**
+     * \brief Upload data that changes on every frame through a streaming ring buffer
+     *
+     * The buffer of a streamed attribute is divided into \ref StreamSegments
+     * segments that are used in turn. Each segment is protected by a fence,
+     * so that new data never overwrites what the GPU may still read for a
+     * previous frame, and the driver neither reallocates storage nor waits
+     * for in-flight draw calls. With OpenGL 4.4 or \c ARB_buffer_storage, the
+     * buffer is persistently mapped and the data is copied into it directly;
+     * otherwise each segment is mapped without synchronization. The buffer
+     * grows when the data does not fit into a segment.
+     *
+     * Streamed attributes cannot be modified with \ref updateAttrib; calling
+     * \ref uploadAttrib turns them back into regular ones.
+     */
+    template <typename Matrix> void streamAttrib(const std::string &name, const Matrix &M) {
+        uint32_t compSize = sizeof(typename Matrix::Scalar);
+        GLuint glType = (GLuint) detail::type_traits<typename Matrix::Scalar>::type;
+        bool integral = (bool) detail::type_traits<typename Matrix::Scalar>::integral;
+
+        streamAttrib(name, (size_t) M.size(), (int) M.rows(), compSize, glType, integral,
+                     M.data());
+    }
+
+    /// Upload an index buffer that changes on every frame (see \ref streamAttrib)
+    template <typename Matrix> void streamIndices(const Matrix &M) {
+        streamAttrib("indices", M);
+    }
+
     /// Download a vertex buffer object into an Eigen matrix
     template <typename Matrix> void downloadAttrib(const std::string &name, Matrix &M) {
         uint32_t compSize = sizeof(typename Matrix::Scalar);
@@ -214,89 +345,197 @@ public:
             it->second.version = -1;
     }
 
+    /**
+     * \brief Set the rate at which an attribute advances during instanced draw calls
+     *
+     * With a divisor of \c n, the attribute advances once per \c n instances
+     * instead of once per vertex (the default, which corresponds to 0). The
+     * setting persists when the attribute is uploaded, streamed or shared
+     * again. The shader must be bound.
+     */
+    void setAttribDivisor(const std::string &name, uint32_t divisor);
+
+    /// Return the instance divisor of an attribute (0 if it advances per vertex)
+    uint32_t attribDivisor(const std::string &name) const {
+        auto it = mAttribDivisors.find(name);
+        return it == mAttribDivisors.end() ? 0 : it->second;
+    }
+
     /// Draw a sequence of primitives
     void drawArray(int type, uint32_t offset, uint32_t count);
 
     /// Draw a sequence of primitives using a previously uploaded index buffer
     void drawIndexed(int type, uint32_t offset, uint32_t count);
 
+    /// Draw a sequence of primitives \c instanceCount times (see \ref setAttribDivisor)
+    void drawArrayInstanced(int type, uint32_t offset, uint32_t count, uint32_t instanceCount);
+
+    /// Draw a sequence of indexed primitives \c instanceCount times (see \ref setAttribDivisor)
+    void drawIndexedInstanced(int type, uint32_t offset, uint32_t count, uint32_t instanceCount);
+
+    /**
+     * \brief Draw several sequences of primitives with a single call
+     *
+     * Equivalent to calling \ref drawArray for every pair of offset and
+     * count, but submitted with ``glMultiDrawArrays``.
+     */
+    void drawArrayMulti(int type, const std::vector<uint32_t> &offsets,
+                        const std::vector<uint32_t> &counts);
+
+    /**
+     * \brief Draw several sequences of indexed primitives with a single call
+     *
+     * Equivalent to calling \ref drawIndexed for every pair of offset and
+     * count (in primitives), but submitted with ``glMultiDrawElements``.
+     */
+    void drawIndexedMulti(int type, const std::vector<uint32_t> &offsets,
+                          const std::vector<uint32_t> &counts);
+
     /// Initialize a uniform parameter with a 4x4 matrix (float)
     template <typename T>
     void setUniform(const std::string &name, const Eigen::Matrix<T, 4, 4> &mat, bool warn = true) {
-        glUniformMatrix4fv(uniform(name, warn), 1, GL_FALSE, mat.template cast<float>().data());
+        setUniform(uniformHandle(name, warn), mat);
     }
 
     /// Initialize a uniform parameter with a 3x3 affine transform (float)
     template <typename T>
     void setUniform(const std::string &name, const Eigen::Transform<T, 3, 3> &affine, bool warn = true) {
-        glUniformMatrix4fv(uniform(name, warn), 1, GL_FALSE, affine.template cast<float>().data());
+        setUniform(uniformHandle(name, warn), affine);
     }
 
     /// Initialize a uniform parameter with a 3x3 matrix (float)
     template <typename T>
     void setUniform(const std::string &name, const Eigen::Matrix<T, 3, 3> &mat, bool warn = true) {
-        glUniformMatrix3fv(uniform(name, warn), 1, GL_FALSE, mat.template cast<float>().data());
+        setUniform(uniformHandle(name, warn), mat);
     }
 
     /// Initialize a uniform parameter with a 2x2 affine transform (float)
     template <typename T>
     void setUniform(const std::string &name, const Eigen::Transform<T, 2, 2> &affine, bool warn = true) {
-        glUniformMatrix3fv(uniform(name, warn), 1, GL_FALSE, affine.template cast<float>().data());
+        setUniform(uniformHandle(name, warn), affine);
     }
 
     /// Initialize a uniform parameter with a boolean value
     void setUniform(const std::string &name, bool value, bool warn = true) {
-        glUniform1i(uniform(name, warn), (int)value);
+        setUniform(uniformHandle(name, warn), value);
     }
 
     /// Initialize a uniform parameter with an integer value
     template <typename T, typename std::enable_if<detail::type_traits<T>::integral == 1, int>::type = 0>
     void setUniform(const std::string &name, T value, bool warn = true) {
-        glUniform1i(uniform(name, warn), (int) value);
+        setUniform(uniformHandle(name, warn), value);
     }
 
     /// Initialize a uniform parameter with a floating point value
     template <typename T, typename std::enable_if<detail::type_traits<T>::integral == 0, int>::type = 0>
     void setUniform(const std::string &name, T value, bool warn = true) {
-        glUniform1f(uniform(name, warn), (float) value);
+        setUniform(uniformHandle(name, warn), value);
     }
 
-    /// Initialize a uniform parameter with a 2D vector (int)
-    template <typename T, typename std::enable_if<detail::type_traits<T>::integral == 1, int>::type = 0>
-    void setUniform(const std::string &name, const Eigen::Matrix<T, 2, 1>  &v, bool warn = true) {
-        glUniform2i(uniform(name, warn), (int) v.x(), (int) v.y());
+    /// Initialize a uniform parameter with a 2D, 3D or 4D vector (int or float)
+    template <typename T, int Size, typename std::enable_if<Size >= 2 && Size <= 4, int>::type = 0>
+    void setUniform(const std::string &name, const Eigen::Matrix<T, Size, 1> &v, bool warn = true) {
+        setUniform(uniformHandle(name, warn), v);
     }
 
-    /// Initialize a uniform parameter with a 2D vector (float)
-    template <typename T, typename std::enable_if<detail::type_traits<T>::integral == 0, int>::type = 0>
-    void setUniform(const std::string &name, const Eigen::Matrix<T, 2, 1>  &v, bool warn = true) {
-        glUniform2f(uniform(name, warn), (float) v.x(), (float) v.y());
+    /**
+     * \brief Return a handle of a uniform that can be passed to \ref setUniform
+     * instead of its name
+     *
+     * The active uniforms of the program are enumerated once after linking,
+     * hence this function merely looks up a hash table. Handles remain valid
+     * until the shader is freed or initialized again. The handle of a
+     * uniform that does not exist is invalid, and setting it has no effect.
+     */
+    UniformHandle uniformHandle(const std::string &name, bool warn = true);
+
+    /// Set a uniform parameter to a 4x4 matrix (float)
+    template <typename T>
+    void setUniform(UniformHandle handle, const Eigen::Matrix<T, 4, 4> &mat) {
+        Eigen::Matrix4f value = mat.template cast<float>();
+        if (cacheUniform(handle, value.data(), sizeof(value)))
+            glUniformMatrix4fv(uniformLocation(handle), 1, GL_FALSE, value.data());
     }
 
-    /// Initialize a uniform parameter with a 3D vector (int)
-    template <typename T, typename std::enable_if<detail::type_traits<T>::integral == 1, int>::type = 0>
-    void setUniform(const std::string &name, const Eigen::Matrix<T, 3, 1>  &v, bool warn = true) {
-        glUniform3i(uniform(name, warn), (int) v.x(), (int) v.y(), (int) v.z());
+    /// Set a uniform parameter to a 3x3 affine transform (float)
+    template <typename T>
+    void setUniform(UniformHandle handle, const Eigen::Transform<T, 3, 3> &affine) {
+        setUniform(handle, affine.matrix());
     }
 
-    /// Initialize a uniform parameter with a 3D vector (float)
-    template <typename T, typename std::enable_if<detail::type_traits<T>::integral == 0, int>::type = 0>
-    void setUniform(const std::string &name, const Eigen::Matrix<T, 3, 1>  &v, bool warn = true) {
-        glUniform3f(uniform(name, warn), (float) v.x(), (float) v.y(), (float) v.z());
+    /// Set a uniform parameter to a 3x3 matrix (float)
+    template <typename T>
+    void setUniform(UniformHandle handle, const Eigen::Matrix<T, 3, 3> &mat) {
+        Eigen::Matrix3f value = mat.template cast<float>();
+        if (cacheUniform(handle, value.data(), sizeof(value)))
+            glUniformMatrix3fv(uniformLocation(handle), 1, GL_FALSE, value.data());
     }
 
-    /// Initialize a uniform parameter with a 4D vector (int)
+    /// Set a uniform parameter to a 2x2 affine transform (float)
+    template <typename T>
+    void setUniform(UniformHandle handle, const Eigen::Transform<T, 2, 2> &affine) {
+        setUniform(handle, affine.matrix());
+    }
+
+    /// Set a uniform parameter to a boolean value
+    void setUniform(UniformHandle handle, bool value) {
+        setUniform(handle, (int) value);
+    }
+
+    /// Set a uniform parameter to an integer value
     template <typename T, typename std::enable_if<detail::type_traits<T>::integral == 1, int>::type = 0>
-    void setUniform(const std::string &name, const Eigen::Matrix<T, 4, 1>  &v, bool warn = true) {
-        glUniform4i(uniform(name, warn), (int) v.x(), (int) v.y(), (int) v.z(), (int) v.w());
+    void setUniform(UniformHandle handle, T value_) {
+        int value = (int) value_;
+        if (cacheUniform(handle, &value, sizeof(int)))
+            glUniform1i(uniformLocation(handle), value);
     }
 
-    /// Initialize a uniform parameter with a 4D vector (float)
+    /// Set a uniform parameter to a floating point value
     template <typename T, typename std::enable_if<detail::type_traits<T>::integral == 0, int>::type = 0>
-    void setUniform(const std::string &name, const Eigen::Matrix<T, 4, 1>  &v, bool warn = true) {
-        glUniform4f(uniform(name, warn), (float) v.x(), (float) v.y(), (float) v.z(), (float) v.w());
+    void setUniform(UniformHandle handle, T value_) {
+        float value = (float) value_;
+        if (cacheUniform(handle, &value, sizeof(float)))
+            glUniform1f(uniformLocation(handle), value);
+    }
+
+    /// Set a uniform parameter to a 2D, 3D or 4D vector (int)
+    template <typename T, int Size, typename std::enable_if<detail::type_traits<T>::integral == 1 &&
+                                                            Size >= 2 && Size <= 4, int>::type = 0>
+    void setUniform(UniformHandle handle, const Eigen::Matrix<T, Size, 1> &v) {
+        Eigen::Matrix<int, Size, 1> value = v.template cast<int>();
+        if (!cacheUniform(handle, value.data(), sizeof(value)))
+            return;
+        switch (Size) {
+            case 2: glUniform2iv(uniformLocation(handle), 1, value.data()); break;
+            case 3: glUniform3iv(uniformLocation(handle), 1, value.data()); break;
+            case 4: glUniform4iv(uniformLocation(handle), 1, value.data()); break;
+        }
     }
 
+    /// Set a uniform parameter to a 2D, 3D or 4D vector (float)
+    template <typename T, int Size, typename std::enable_if<detail::type_traits<T>::integral == 0 &&
+                                                            Size >= 2 && Size <= 4, int>::type = 0>
+    void setUniform(UniformHandle handle, const Eigen::Matrix<T, Size, 1> &v) {
+        Eigen::Matrix<float, Size, 1> value = v.template cast<float>();
+        if (!cacheUniform(handle, value.data(), sizeof(value)))
+            return;
+        switch (Size) {
+            case 2: glUniform2fv(uniformLocation(handle), 1, value.data()); break;
+            case 3: glUniform3fv(uniformLocation(handle), 1, value.data()); break;
+            case 4: glUniform4fv(uniformLocation(handle), 1, value.data()); break;
+        }
+    }
+
+    /**
+     * \brief Forget the cached values of all uniforms
+     *
+     * \ref setUniform skips OpenGL calls that would not change the value of a
+     * uniform. Call this function after modifying uniforms of the program
+     * without going through this class (e.g. with ``glUniform*()`` and the
+     * location returned by \ref uniform).
+     */
+    void invalidateUniforms();
+
     /// Initialize a uniform buffer with a uniform buffer object
     void setUniform(const std::string &name, const GLUniformBuffer &buf, bool warn = true);
 
@@ -353,8 +592,59 @@ public:
                        const void *data, int version = -1);
     void downloadAttrib(const std::string &name, size_t size, int dim,
                        uint32_t compSize, GLuint glType, void *data);
+    void updateAttrib(const std::string &name, size_t offset, size_t size, int dim,
+                      uint32_t compSize, GLuint glType, const void *data);
+    void streamAttrib(const std::string &name, size_t size, int dim,
+                      uint32_t compSize, GLuint glType, bool integral, const void *data);
+
+    /// Return the location of a uniform (-1 if the handle is invalid)
+    GLint uniformLocation(UniformHandle handle) const {
+        return handle.valid() ? mUniforms[handle.index].location : -1;
+    }
+
+    /**
+     * \brief Record the value of a uniform and return whether it changed
+     *
+     * Returns \c false if the handle is invalid or the value equals the one
+     * that was recorded last, in which case the OpenGL call can be skipped.
+     */
+    bool cacheUniform(UniformHandle handle, const void *value, uint32_t size) {
+        if (!handle.valid())
+            return false;
+        Uniform &uniform = mUniforms[handle.index];
+        if (uniform.valueSize == size && memcmp(uniform.value, value, size) == 0)
+            return false;
+        if (size <= sizeof(uniform.value)) {
+            memcpy(uniform.value, value, size);
+            uniform.valueSize = size;
+        } else {
+            uniform.valueSize = 0;
+        }
+        return true;
+    }
 
 protected:
+    /// An active uniform of the linked program and its last value.
+    struct Uniform {
+        GLint location;         ///< The location returned by ``glGetUniformLocation``.
+        uint32_t valueSize;     ///< The size of the cached value in bytes (0 if unknown).
+        uint8_t value[64];      ///< The cached value (large enough for a 4x4 float matrix).
+    };
+
+    /// Enumerate the active uniforms, attributes and uniform blocks of the linked program.
+    void introspect();
+
+    /// Wait for the program submitted by \ref initAsync and check its status.
+    void finishInit();
+
+    /// The ring buffer of a streamed attribute (see \ref streamAttrib).
+    struct StreamBuffer {
+        size_t segmentSize;             ///< The capacity of each segment in bytes.
+        int segment;                    ///< The segment holding the current data.
+        void *mapped;                   ///< The persistent mapping of the buffer (if supported).
+        GLsync fences[StreamSegments];  ///< Signalled once the GPU no longer reads a segment.
+    };
+
     /// The registered name of this GLShader.
     std::string mName;
 
@@ -379,6 +669,45 @@ protected:
      */
     std::map<std::string, Buffer> mBufferObjects;
 
+    /// The ring buffers of the attributes that were uploaded with \ref streamAttrib.
+    std::map<std::string, StreamBuffer> mStreamBuffers;
+
+    /// The byte offset of the current indices within the index buffer.
+    size_t mIndexOffset;
+
+    /// The map of attribute names to instance divisors (see \ref setAttribDivisor).
+    std::map<std::string, uint32_t> mAttribDivisors;
+
+    /// The active uniforms of the program, indexed by \ref UniformHandle.
+    std::vector<Uniform> mUniforms;
+
+    /// The map of uniform names to indices into \ref mUniforms.
+    std::unordered_map<std::string, int> mUniformIndices;
+
+    /// The map of active attribute names to their locations.
+    std::unordered_map<std::string, GLint> mAttribLocations;
+
+    /// The map of active uniform block names to their indices.
+    std::unordered_map<std::string, GLuint> mUniformBlocks;
+
+    /// The time in seconds spent compiling the shaders.
+    double mCompileTime;
+
+    /// The time in seconds spent linking the program or loading its binary.
+    double mLinkTime;
+
+    /// Whether the program was created from the binary cache.
+    bool mLoadedFromBinary;
+
+    /// Whether the status of the program submitted by \ref initAsync has not been checked yet.
+    bool mPending;
+
+    /// The file of the program in the binary cache (empty if disabled).
+    std::string mBinaryFile;
+
+    /// The key of the program in the binary cache.
+    uint64_t mBinaryKey;
+
     /**
      * \rst
      * The map of preprocessor names to values (if any have been created).  If
@@ -506,6 +835,12 @@ public:
     /// Return the number of MSAA samples
     int samples() const { return mSamples; }
 
+    /// Return the size of the framebuffer object
+    const Vector2i &size() const { return mSize; }
+
+    /// Return the handle of the underlying OpenGL framebuffer object
+    GLuint framebuffer() const { return mFramebuffer; }
+
     /// Quick and dirty method to write a TGA (32bpp RGBA) file of the framebuffer contents for debugging
     void downloadTGA(const std::string &filename);
 protected:
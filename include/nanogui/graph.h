@@ -13,6 +13,7 @@
 #pragma once
 
 #include <nanogui/widget.h>
+#include <atomic>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -20,32 +21,111 @@ NAMESPACE_BEGIN(nanogui)
  * \class Graph graph.h nanogui/graph.h
  *
  * \brief Simple graph widget for showing a function plot.
+ *
+ * The plotted values are either specified all at once using \ref
+ * setValues(), or streamed into a ring buffer that retains the most recent
+ * \ref capacity() samples (see \ref push()). Producer threads can hand
+ * samples to the user interface thread through a lock-free queue (see
+ * \ref enqueue()).
+ *
+ * Long series are decimated to a minimum and maximum per pixel column
+ * before drawing, which preserves peaks. The ring buffer maintains a
+ * min/max pyramid that is updated incrementally on every append, so that
+ * the cost of drawing it depends on the width of the widget rather than
+ * on the number of samples.
  */
 class NANOGUI_EXPORT Graph : public Widget {
 public:
     Graph(Widget *parent, const std::string &caption = "Untitled");
 
     const std::string &caption() const { return mCaption; }
-    void setCaption(const std::string &caption) { mCaption = caption; }
+    void setCaption(const std::string &caption) { mCaption = caption; markDirty(); }
 
     const std::string &header() const { return mHeader; }
-    void setHeader(const std::string &header) { mHeader = header; }
+    void setHeader(const std::string &header) { mHeader = header; markDirty(); }
 
     const std::string &footer() const { return mFooter; }
-    void setFooter(const std::string &footer) { mFooter = footer; }
+    void setFooter(const std::string &footer) { mFooter = footer; markDirty(); }
 
     const Color &backgroundColor() const { return mBackgroundColor; }
-    void setBackgroundColor(const Color &backgroundColor) { mBackgroundColor = backgroundColor; }
+    void setBackgroundColor(const Color &backgroundColor) { mBackgroundColor = backgroundColor; markDirty(); }
 
     const Color &foregroundColor() const { return mForegroundColor; }
-    void setForegroundColor(const Color &foregroundColor) { mForegroundColor = foregroundColor; }
+    void setForegroundColor(const Color &foregroundColor) { mForegroundColor = foregroundColor; markDirty(); }
 
     const Color &textColor() const { return mTextColor; }
-    void setTextColor(const Color &textColor) { mTextColor = textColor; }
+    void setTextColor(const Color &textColor) { mTextColor = textColor; markDirty(); }
 
+    /// Return the values that are plotted when the ring buffer is disabled
     const VectorXf &values() const { return mValues; }
     VectorXf &values() { return mValues; }
-    void setValues(const VectorXf &values) { mValues = values; }
+
+    /// Set the plotted values (replaces the contents of the ring buffer, if enabled)
+    void setValues(const VectorXf &values);
+
+    /**
+     * \brief Plot the last \c capacity samples passed to \ref push()
+     *
+     * The samples are kept in a preallocated ring buffer, hence appending
+     * them never allocates or moves the others. The retained samples are
+     * preserved as far as possible. A capacity of zero disables the ring
+     * buffer and plots \ref values() instead.
+     */
+    void setCapacity(size_t capacity);
+
+    /// Return the capacity of the ring buffer (zero if disabled)
+    size_t capacity() const { return mRing.size(); }
+
+    /// Append a sample to the ring buffer, discarding the oldest one if it is full
+    void push(float value) { pushBatch(&value, 1); }
+
+    /// Append \c count samples to the ring buffer
+    void pushBatch(const float *values, size_t count);
+
+    /// Return the number of plotted samples
+    size_t sampleCount() const;
+
+    /// Return the plotted sample with index \c i (the oldest one has index 0)
+    float sample(size_t i) const;
+
+    /**
+     * \brief Compute the minimum and maximum of the plotted samples with
+     * indices in <tt>[begin, end)</tt>
+     *
+     * Takes logarithmic time in the ring buffer and linear time otherwise.
+     */
+    void sampleRange(size_t begin, size_t end, float &min, float &max) const;
+
+    /**
+     * \brief Allocate a queue that transfers up to \c capacity samples from
+     * a producer thread to the ring buffer
+     *
+     * Samples that are not yet transferred are discarded. Call this on the
+     * user interface thread before starting the producer.
+     */
+    void setQueueCapacity(size_t capacity);
+
+    /// Return the capacity of the producer queue (rounded up to a power of two)
+    size_t queueCapacity() const { return mQueue.size(); }
+
+    /**
+     * \brief Hand a sample from a producer thread to the user interface thread
+     *
+     * This function is wait-free and may be called concurrently with the
+     * user interface thread, but only from a single producer thread at a
+     * time. The samples are appended to the ring buffer before the next
+     * frame is drawn, and the main loop is woken up if necessary. Returns
+     * \c false and drops the sample if the queue is full. Samples that
+     * arrive while the ring buffer is disabled (\ref capacity() is zero)
+     * are removed from the queue but not plotted.
+     */
+    bool enqueue(float value) { return enqueueBatch(&value, 1) == 1; }
+
+    /// Hand \c count samples to the user interface thread and return how many fit into the queue
+    size_t enqueueBatch(const float *values, size_t count);
+
+    /// Move the samples waiting in the queue into the ring buffer and return how many were kept
+    size_t drainQueue();
 
     virtual Vector2i preferredSize(NVGcontext *ctx) const override;
     virtual void draw(NVGcontext *ctx) override;
@@ -56,6 +136,46 @@ protected:
     std::string mCaption, mHeader, mFooter;
     Color mBackgroundColor, mForegroundColor, mTextColor;
     VectorXf mValues;
+
+    /* Ring buffer of streamed samples: the oldest one is at mRingStart */
+    std::vector<float> mRing;
+    size_t mRingStart, mRingCount;
+    /* Number of samples ever appended, i.e. the absolute position of the
+       next sample (used to align the blocks of the pyramid) */
+    size_t mRingTotal;
+
+    /* Min/max pyramid over the ring buffer. Level l summarizes aligned
+       blocks of 8 * 4^l samples, which are stored modulo the number of
+       blocks that fit into the ring buffer. */
+    struct PyramidLevel {
+        size_t blockSize;
+        std::vector<float> min, max;
+    };
+    std::vector<PyramidLevel> mPyramid;
+
+    /* Single-producer/single-consumer queue. The indices increase
+       monotonically and are reduced modulo the power-of-two capacity. */
+    std::vector<float> mQueue;
+    std::atomic<size_t> mQueueRead, mQueueWrite;
+    /* Set while an animation frame will drain the queue */
+    std::atomic<bool> mDrainRequested;
+    /* Screen that drains the queue (known once the graph was drawn) */
+    std::atomic<Screen *> mQueueScreen;
+
+    /// Ask \ref mQueueScreen to drain the queue before the next frame
+    void requestDrain();
+
+    /// Allocate the pyramid levels for the current capacity and fill them
+    void rebuildPyramid();
+
+    /// Summarize the blocks that were completed by samples appended since absolute position \c from
+    void updatePyramid(size_t from);
+
+    /// Min/max of the ring buffer samples with absolute positions in <tt>[begin, end)</tt>
+    void rawRange(size_t begin, size_t end, float &min, float &max) const;
+
+    /// Min/max of absolute positions <tt>[begin, end)</tt> using pyramid levels up to \c level
+    void pyramidRange(int level, size_t begin, size_t end, float &min, float &max) const;
 public:
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
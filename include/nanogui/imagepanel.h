@@ -14,6 +14,7 @@
 #pragma once
 
 #include <nanogui/widget.h>
+#include <nanogui/glutil.h>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -21,16 +22,44 @@ NAMESPACE_BEGIN(nanogui)
  * \class ImagePanel imagepanel.h nanogui/imagepanel.h
  *
  * \brief Image panel widget which shows a number of square-shaped icons.
+ *
+ * Entries whose image is 0 are drawn as placeholders. This is used while
+ * \ref loadDirectory() fills in the thumbnails of a directory. Those are
+ * packed into texture atlases (see \ref TextureAtlas) instead of separate
+ * NanoVG images, so that all visible thumbnails of an atlas, including their
+ * shadows and borders, are drawn with a single draw call.
  */
 class NANOGUI_EXPORT ImagePanel : public Widget {
 public:
     typedef std::vector<std::pair<int, std::string>> Images;
 public:
     ImagePanel(Widget *parent);
+    virtual ~ImagePanel();
 
-    void setImages(const Images &data) { mImages = data; }
+    void setImages(const Images &data);
     const Images& images() const { return mImages; }
 
+    /**
+     * \brief Asynchronously load the PNG images of a directory as thumbnails
+     *
+     * The entries are added immediately as placeholders and filled in as
+     * their images are decoded on worker threads (see \ref ThumbnailLoader),
+     * starting with the visible ones. The images are downscaled until their
+     * smaller side does not exceed \c thumbnailSize pixels (by default twice
+     * the size of the icons, for high-DPI displays), cropped to a square and
+     * packed into texture atlases owned by the panel. The image of all
+     * entries is 0.
+     */
+    void loadDirectory(const std::string &path, int thumbnailSize = -1);
+
+    /// Return whether \ref loadDirectory() is still filling in thumbnails
+    bool loading() const { return mLoader != nullptr; }
+
+    /// Return the time in seconds that may be spent creating thumbnail images per frame
+    double uploadBudget() const { return mUploadBudget; }
+    /// Set the time in seconds that may be spent creating thumbnail images per frame
+    void setUploadBudget(double budget) { mUploadBudget = budget; }
+
     std::function<void(int)> callback() const { return mCallback; }
     void setCallback(const std::function<void(int)> &callback) { mCallback = callback; }
 
@@ -41,6 +70,19 @@ public:
 protected:
     Vector2i gridSize() const;
     int indexForPosition(const Vector2i &p) const;
+    /// Return the range of entries that are not clipped by the ancestors of the panel
+    std::pair<size_t, size_t> visibleRange() const;
+    /// Return the part of the panel that is not clipped by its ancestors (in absolute coordinates)
+    void clipRect(Vector2i &lower, Vector2i &upper) const;
+    /// Add decoded thumbnails to the atlases and keep redrawing until all are done
+    void updateThumbnails();
+    /// Add a thumbnail to the current atlas (or a new one) after cropping it to a square
+    void addThumbnail(size_t index, const Vector2i &size, const uint8_t *data);
+    /// Draw the visible entries of a loaded directory from the atlases
+    void drawThumbnails(NVGcontext *ctx, const std::pair<size_t, size_t> &range);
+    /// Check for decoded thumbnails on the next frame
+    void requestPoll();
+    void pollThumbnails();
 protected:
     Images mImages;
     std::function<void(int)> mCallback;
@@ -48,6 +90,14 @@ protected:
     int mSpacing;
     int mMargin;
     int mMouseIndex;
+    ThumbnailLoader *mLoader;
+    double mUploadBudget;
+    bool mPollRequested;
+    /* The atlases of a loaded directory, and the atlas and image of each
+       entry (-1 while it is being loaded) */
+    std::vector<TextureAtlas *> mAtlases;
+    std::vector<std::pair<int, int>> mThumbnails;
+    GLShader mShader;
 public:
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
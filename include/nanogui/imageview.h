@@ -20,18 +20,89 @@
 
 NAMESPACE_BEGIN(nanogui)
 
+class TiledImageSource;
+class TileCache;
+
 /**
  * \class ImageView imageview.h nanogui/imageview.h
  *
  * \brief Widget used to display images.
+ *
+ * The image is either an OpenGL texture (see \ref bindImage()), or a tiled
+ * image pyramid (see \ref bindTiledImage()) that is streamed to the GPU
+ * as needed for the current view.
+ *
+ * Textures may have any format that can be sampled as floating point values,
+ * including half and single precision float textures of high dynamic range
+ * images. Exposure, gamma, channel selection and false color mapping are
+ * applied by the fragment shader, hence changing them only requires a redraw.
  */
 class NANOGUI_EXPORT ImageView : public Widget {
 public:
+    /// The channels that can be displayed.
+    enum class Channel {
+        RGBA,      ///< All channels.
+        Red,       ///< The red channel as a grayscale image.
+        Green,     ///< The green channel as a grayscale image.
+        Blue,      ///< The blue channel as a grayscale image.
+        Alpha,     ///< The alpha channel as a grayscale image.
+        Luminance  ///< The luminance of the red, green and blue channels.
+    };
+
     ImageView(Widget* parent, GLuint imageID);
     ~ImageView();
 
     void bindImage(GLuint imageId);
 
+    /**
+     * \brief Display a tiled image pyramid instead of a texture
+     *
+     * Only the tiles that cover the visible part of the image are loaded,
+     * from the level of the pyramid that matches the current scale. They
+     * are requested from a background thread and uploaded incrementally
+     * (see \ref setTileUploadBudget()). Until a tile is available, the
+     * corresponding part of a coarser level is shown instead.
+     */
+    void bindTiledImage(TiledImageSource *source);
+
+    /// Return the tiled image pyramid that is displayed (if any)
+    TiledImageSource *tiledImage();
+
+    /// Return the maximum number of bytes of GPU memory used by the tiles of a tiled image
+    size_t tileMemoryBudget() const { return mTileMemoryBudget; }
+    /// Set the maximum number of bytes of GPU memory used by the tiles of a tiled image
+    void setTileMemoryBudget(size_t budget);
+
+    /// Return the time in seconds that may be spent uploading tiles per frame
+    double tileUploadBudget() const { return mTileUploadBudget; }
+    /// Set the time in seconds that may be spent uploading tiles per frame
+    void setTileUploadBudget(double budget) { mTileUploadBudget = budget; }
+
+    /// Return the exposure in stops, i.e. the values are scaled by <tt>2^exposure</tt>
+    float exposure() const { return mExposure; }
+    /// Set the exposure in stops, i.e. the values are scaled by <tt>2^exposure</tt>
+    void setExposure(float exposure) { mExposure = exposure; markDirty(); }
+
+    /// Return the gamma that is applied to the scaled values
+    float gamma() const { return mGamma; }
+    /// Set the gamma that is applied to the scaled values (e.g. 2.2 for linear images)
+    void setGamma(float gamma) { mGamma = gamma; markDirty(); }
+
+    /// Return the displayed channel(s)
+    Channel channel() const { return mChannel; }
+    /// Set the displayed channel(s)
+    void setChannel(Channel channel) { mChannel = channel; markDirty(); }
+
+    /// Return whether the selected channel (or the luminance) is mapped to colors
+    bool falseColor() const { return mFalseColor; }
+    /**
+     * \brief Set whether the selected channel (or the luminance) is mapped to colors
+     *
+     * The scaled values in <tt>[0, 1]</tt> are mapped to the colors of the
+     * Turbo colormap, from dark blue to dark red. Gamma is not applied.
+     */
+    void setFalseColor(bool falseColor) { mFalseColor = falseColor; markDirty(); }
+
     GLShader& imageShader() { return mShader; }
 
     Vector2f positionF() const { return mPos.cast<float>(); }
@@ -43,9 +114,9 @@ public:
     Vector2f scaledImageSizeF() const { return (mScale * mImageSize.cast<float>()); }
 
     const Vector2f& offset() const { return mOffset; }
-    void setOffset(const Vector2f& offset) { mOffset = offset; }
+    void setOffset(const Vector2f& offset) { mOffset = offset; markDirty(); }
     float scale() const { return mScale; }
-    void setScale(float scale) { mScale = scale > 0.01f ? scale : 0.01f; }
+    void setScale(float scale) { mScale = scale > 0.01f ? scale : 0.01f; markDirty(); }
 
     bool fixedOffset() const { return mFixedOffset; }
     void setFixedOffset(bool fixedOffset) { mFixedOffset = fixedOffset; }
@@ -56,21 +127,53 @@ public:
     void setZoomSensitivity(float zoomSensitivity) { mZoomSensitivity = zoomSensitivity; }
 
     float gridThreshold() const { return mGridThreshold; }
-    void setGridThreshold(float gridThreshold) { mGridThreshold = gridThreshold; }
+    void setGridThreshold(float gridThreshold) { mGridThreshold = gridThreshold; markDirty(); }
 
     float pixelInfoThreshold() const { return mPixelInfoThreshold; }
-    void setPixelInfoThreshold(float pixelInfoThreshold) { mPixelInfoThreshold = pixelInfoThreshold; }
+    void setPixelInfoThreshold(float pixelInfoThreshold) { mPixelInfoThreshold = pixelInfoThreshold; markDirty(); }
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
     void setPixelInfoCallback(const std::function<std::pair<std::string, Color>(const Vector2i&)>& callback) {
         mPixelInfoCallback = callback;
+        invalidatePixelInfo();
     }
     const std::function<std::pair<std::string, Color>(const Vector2i&)>& pixelInfoCallback() const {
         return mPixelInfoCallback;
     }
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
-    void setFontScaleFactor(float fontScaleFactor) { mFontScaleFactor = fontScaleFactor; }
+    /**
+     * \brief Callback that provides the pixel information of a block of pixels
+     *
+     * Receives the first pixel and the size of the block, and returns one
+     * entry per pixel in row-major order. This allows reading the values
+     * from a CPU-side copy of the image or from the texture in bulk.
+     */
+    typedef std::function<std::vector<std::pair<std::string, Color>>(const Vector2i&, const Vector2i&)>
+        PixelInfoBatchCallback;
+
+    /**
+     * \brief Set a callback that provides the pixel information of all visible pixels at once
+     *
+     * Takes precedence over the per-pixel callback. It is only invoked when
+     * the range of visible pixels changes, or after \ref invalidatePixelInfo().
+     */
+    void setPixelInfoBatchCallback(const PixelInfoBatchCallback& callback) {
+        mPixelInfoBatchCallback = callback;
+        invalidatePixelInfo();
+    }
+    const PixelInfoBatchCallback& pixelInfoBatchCallback() const { return mPixelInfoBatchCallback; }
+
+    /**
+     * \brief Discard the cached pixel information
+     *
+     * The pixel information is requested once per visible pixel and reused
+     * until that pixel leaves the view. Call this function when the values
+     * of the image have changed.
+     */
+    void invalidatePixelInfo() { mPixelInfoCount = Vector2i::Zero(); markDirty(); }
+
+    void setFontScaleFactor(float fontScaleFactor) { mFontScaleFactor = fontScaleFactor; markDirty(); }
     float fontScaleFactor() const { return mFontScaleFactor; }
 
     // Image transformation functions.
@@ -136,15 +239,22 @@ private:
     // Helper image methods.
     void updateImageParameters();
 
+    // Draws the visible tiles of a tiled image and requests the missing ones.
+    void drawTiles(const Vector2f& screenSize, float pixelRatio);
+    // Redraws the widget once loaded tiles are waiting for their upload.
+    void pollTiles();
+
     // Helper drawing methods.
     void drawWidgetBorder(NVGcontext* ctx) const;
     void drawImageBorder(NVGcontext* ctx) const;
-    void drawHelpers(NVGcontext* ctx) const;
-    static void drawPixelGrid(NVGcontext* ctx, const Vector2f& upperLeftCorner,
-                              const Vector2f& lowerRightCorner, float stride);
-    void drawPixelInfo(NVGcontext* ctx, float stride) const;
-    void writePixelInfo(NVGcontext* ctx, const Vector2f& cellPosition,
-                        const Vector2i& pixel, float stride, float fontSize) const;
+    void drawHelpers(const Vector2f& screenSize, float pixelRatio);
+    void drawPixelGrid(const Vector2f& screenSize, float pixelRatio, const Vector2f& imageOrigin,
+                       float stride);
+    void drawPixelInfo(const Vector2f& screenSize, const Vector2f& imageOrigin, float stride);
+    // Requests the pixel information of the given pixels, reusing the cached ones.
+    void updatePixelInfo(const Vector2i& first, const Vector2i& count);
+    // Lays out the glyph quads of all cached pixel information.
+    void updatePixelInfoQuads(float fontScale);
 
     // Image parameters.
     GLShader mShader;
@@ -160,13 +270,43 @@ private:
     // Fine-tuning parameters.
     float mZoomSensitivity = 1.1f;
 
+    // Tone mapping parameters.
+    float mExposure = 0.f;
+    float mGamma = 1.f;
+    Channel mChannel = Channel::RGBA;
+    bool mFalseColor = false;
+
     // Image info parameters.
     float mGridThreshold = -1;
     float mPixelInfoThreshold = -1;
 
     // Image pixel data display members.
     std::function<std::pair<std::string, Color>(const Vector2i&)> mPixelInfoCallback;
+    PixelInfoBatchCallback mPixelInfoBatchCallback;
     float mFontScaleFactor = 0.2f;
+
+    // Cached pixel information of the pixels [mPixelInfoFirst, mPixelInfoFirst + mPixelInfoCount).
+    struct PixelInfo {
+        std::vector<std::string> rows;
+        Color color;
+    };
+    std::vector<PixelInfo> mPixelInfo;
+    Vector2i mPixelInfoFirst = Vector2i::Zero();
+    Vector2i mPixelInfoCount = Vector2i::Zero();
+
+    // Overlay rendering members: the glyph quads of the cached pixel information
+    // (in units of image pixels) and the shader that draws the pixel grid.
+    GLShader mGridShader;
+    GLShader mPixelInfoShader;
+    GLuint mGlyphTexture = 0;
+    uint32_t mPixelInfoQuads = 0;
+    float mPixelInfoFontScale = 0;
+
+    // Tiled image streaming members.
+    TileCache* mTileCache = nullptr;
+    size_t mTileMemoryBudget = (size_t) 256 * 1024 * 1024;
+    double mTileUploadBudget = 0.004;
+    bool mTilePollRequested = false;
 public:
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
@@ -68,9 +68,23 @@ public:
      */
     virtual Vector2i preferredSize(NVGcontext *ctx, const Widget *widget) const = 0;
 
+    /**
+     * \brief Discard the cached layout information of all widgets using this layout
+     *
+     * The setters of the layout parameters call this function, so that the
+     * next \ref Widget::performLayout() of an ancestor takes the change into
+     * account (see \ref Widget::invalidateLayout()).
+     */
+    void invalidate();
+
 protected:
+    friend class Widget;
+
     /// Default destructor (exists for inheritance).
     virtual ~Layout() { }
+
+    /// The widgets whose layout is generated by this instance (see \ref Widget::setLayout())
+    std::vector<Widget *> mWidgets;
 };
 
 /**
@@ -106,25 +120,25 @@ public:
     Orientation orientation() const { return mOrientation; }
 
     /// Sets the Orientation of this BoxLayout.
-    void setOrientation(Orientation orientation) { mOrientation = orientation; }
+    void setOrientation(Orientation orientation) { mOrientation = orientation; invalidate(); }
 
     /// The Alignment of this BoxLayout.
     Alignment alignment() const { return mAlignment; }
 
     /// Sets the Alignment of this BoxLayout.
-    void setAlignment(Alignment alignment) { mAlignment = alignment; }
+    void setAlignment(Alignment alignment) { mAlignment = alignment; invalidate(); }
 
     /// The margin of this BoxLayout.
     int margin() const { return mMargin; }
 
     /// Sets the margin of this BoxLayout.
-    void setMargin(int margin) { mMargin = margin; }
+    void setMargin(int margin) { mMargin = margin; invalidate(); }
 
     /// The spacing this BoxLayout is using to pad in between widgets.
     int spacing() const { return mSpacing; }
 
     /// Sets the spacing of this BoxLayout.
-    void setSpacing(int spacing) { mSpacing = spacing; }
+    void setSpacing(int spacing) { mSpacing = spacing; invalidate(); }
 
     /* Implementation of the layout interface */
     /// See \ref Layout::preferredSize.
@@ -185,25 +199,25 @@ public:
     int margin() const { return mMargin; }
 
     /// Sets the margin of this GroupLayout.
-    void setMargin(int margin) { mMargin = margin; }
+    void setMargin(int margin) { mMargin = margin; invalidate(); }
 
     /// The spacing between widgets of this GroupLayout.
     int spacing() const { return mSpacing; }
 
     /// Sets the spacing between widgets of this GroupLayout.
-    void setSpacing(int spacing) { mSpacing = spacing; }
+    void setSpacing(int spacing) { mSpacing = spacing; invalidate(); }
 
     /// The indent of widgets in a group (underneath a Label) of this GroupLayout.
     int groupIndent() const { return mGroupIndent; }
 
     /// Sets the indent of widgets in a group (underneath a Label) of this GroupLayout.
-    void setGroupIndent(int groupIndent) { mGroupIndent = groupIndent; }
+    void setGroupIndent(int groupIndent) { mGroupIndent = groupIndent; invalidate(); }
 
     /// The spacing between groups of this GroupLayout.
     int groupSpacing() const { return mGroupSpacing; }
 
     /// Sets the spacing between groups of this GroupLayout.
-    void setGroupSpacing(int groupSpacing) { mGroupSpacing = groupSpacing; }
+    void setGroupSpacing(int groupSpacing) { mGroupSpacing = groupSpacing; invalidate(); }
 
     /* Implementation of the layout interface */
     /// See \ref Layout::preferredSize.
@@ -271,28 +285,29 @@ public:
     /// Sets the Orientation of this GridLayout.
     void setOrientation(Orientation orientation) {
         mOrientation = orientation;
+        invalidate();
     }
 
     /// The number of rows or columns (depending on the Orientation) of this GridLayout.
     int resolution() const { return mResolution; }
 
     /// Sets the number of rows or columns (depending on the Orientation) of this GridLayout.
-    void setResolution(int resolution) { mResolution = resolution; }
+    void setResolution(int resolution) { mResolution = resolution; invalidate(); }
 
     /// The spacing at the specified axis (row or column number, depending on the Orientation).
     int spacing(int axis) const { return mSpacing[axis]; }
 
     /// Sets the spacing for a specific axis.
-    void setSpacing(int axis, int spacing) { mSpacing[axis] = spacing; }
+    void setSpacing(int axis, int spacing) { mSpacing[axis] = spacing; invalidate(); }
 
     /// Sets the spacing for all axes.
-    void setSpacing(int spacing) { mSpacing[0] = mSpacing[1] = spacing; }
+    void setSpacing(int spacing) { mSpacing[0] = mSpacing[1] = spacing; invalidate(); }
 
     /// The margin around this GridLayout.
     int margin() const { return mMargin; }
 
     /// Sets the margin of this GridLayout.
-    void setMargin(int margin) { mMargin = margin; }
+    void setMargin(int margin) { mMargin = margin; invalidate(); }
 
     /**
      * The Alignment of the specified axis (row or column number, depending on
@@ -306,16 +321,16 @@ public:
     }
 
     /// Sets the Alignment of the columns.
-    void setColAlignment(Alignment value) { mDefaultAlignment[0] = value; }
+    void setColAlignment(Alignment value) { mDefaultAlignment[0] = value; invalidate(); }
 
     /// Sets the Alignment of the rows.
-    void setRowAlignment(Alignment value) { mDefaultAlignment[1] = value; }
+    void setRowAlignment(Alignment value) { mDefaultAlignment[1] = value; invalidate(); }
 
     /// Use this to set variable Alignment for columns.
-    void setColAlignment(const std::vector<Alignment> &value) { mAlignment[0] = value; }
+    void setColAlignment(const std::vector<Alignment> &value) { mAlignment[0] = value; invalidate(); }
 
     /// Use this to set variable Alignment for rows.
-    void setRowAlignment(const std::vector<Alignment> &value) { mAlignment[1] = value; }
+    void setRowAlignment(const std::vector<Alignment> &value) { mAlignment[1] = value; invalidate(); }
 
     /* Implementation of the layout interface */
     /// See \ref Layout::preferredSize.
@@ -433,7 +448,7 @@ public:
     int margin() const { return mMargin; }
 
     /// Sets the margin of this AdvancedGridLayout.
-    void setMargin(int margin) { mMargin = margin; }
+    void setMargin(int margin) { mMargin = margin; invalidate(); }
 
     /// Return the number of cols
     int colCount() const { return (int) mCols.size(); }
@@ -442,19 +457,19 @@ public:
     int rowCount() const { return (int) mRows.size(); }
 
     /// Append a row of the given size (and stretch factor)
-    void appendRow(int size, float stretch = 0.f) { mRows.push_back(size); mRowStretch.push_back(stretch); };
+    void appendRow(int size, float stretch = 0.f) { mRows.push_back(size); mRowStretch.push_back(stretch); invalidate(); }
 
     /// Append a column of the given size (and stretch factor)
-    void appendCol(int size, float stretch = 0.f) { mCols.push_back(size); mColStretch.push_back(stretch); };
+    void appendCol(int size, float stretch = 0.f) { mCols.push_back(size); mColStretch.push_back(stretch); invalidate(); }
 
     /// Set the stretch factor of a given row
-    void setRowStretch(int index, float stretch) { mRowStretch.at(index) = stretch; }
+    void setRowStretch(int index, float stretch) { mRowStretch.at(index) = stretch; invalidate(); }
 
     /// Set the stretch factor of a given column
-    void setColStretch(int index, float stretch) { mColStretch.at(index) = stretch; }
+    void setColStretch(int index, float stretch) { mColStretch.at(index) = stretch; invalidate(); }
 
     /// Specify the anchor data structure for a given widget
-    void setAnchor(const Widget *widget, const Anchor &anchor) { mAnchor[widget] = anchor; }
+    void setAnchor(const Widget *widget, const Anchor &anchor) { mAnchor[widget] = anchor; invalidate(); }
 
     /// Retrieve the anchor data structure for a given widget
     Anchor anchor(const Widget *widget) const {
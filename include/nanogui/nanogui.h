@@ -30,12 +30,20 @@
 #include <nanogui/textbox.h>
 #include <nanogui/slider.h>
 #include <nanogui/imagepanel.h>
+#include <nanogui/thumbnailloader.h>
+#include <nanogui/textureatlas.h>
 #include <nanogui/imageview.h>
+#include <nanogui/tiledimage.h>
 #include <nanogui/vscrollpanel.h>
+#include <nanogui/virtuallist.h>
 #include <nanogui/colorwheel.h>
 #include <nanogui/graph.h>
+#include <nanogui/profiler.h>
+#include <nanogui/textmetrics.h>
+#include <nanogui/threadpool.h>
 #include <nanogui/formhelper.h>
 #include <nanogui/stackedwidget.h>
 #include <nanogui/tabheader.h>
 #include <nanogui/tabwidget.h>
 #include <nanogui/glcanvas.h>
+#include <nanogui/plot.h>
@@ -0,0 +1,158 @@
+/*
+    nanogui/plot.h -- Plot of many long time series that are rendered with
+    OpenGL
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/glcanvas.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class Plot plot.h nanogui/plot.h
+ *
+ * \brief Plot of many long series of uniformly spaced samples.
+ *
+ * Unlike \ref Graph, which builds a NanoVG path on every frame, the samples
+ * of each series reside in an OpenGL vertex buffer and are drawn as a line
+ * strip. Only the modified samples are uploaded (see \ref setSeriesData()
+ * and \ref appendSeries()), and panning or zooming merely changes shader
+ * uniforms. Axes, grid lines and the legend are drawn with NanoVG on top of
+ * the series, which are composited like the contents of any other \ref
+ * GLCanvas.
+ *
+ * Sample \c i of a series lies at <tt>x = start + i * step</tt> (see \ref
+ * setSeriesSampling()), where \c i counts all samples ever appended. The
+ * view can be panned by dragging and zoomed horizontally with the scroll
+ * wheel. Positions on the x axis are kept in double precision, so that long
+ * recordings can be inspected at the resolution of single samples; only
+ * offsets relative to the view are passed to the shader.
+ *
+ * The buffers are created and updated immediately, hence all functions that
+ * modify series must be called while the OpenGL context of the screen is
+ * current (i.e. on the user interface thread).
+ */
+class NANOGUI_EXPORT Plot : public GLCanvas {
+public:
+    Plot(Widget *parent);
+    virtual ~Plot();
+
+    /// Add a series that retains up to \c capacity samples and return its index
+    int addSeries(const std::string &name, size_t capacity, const Color &color);
+
+    /// Remove a series (the indices of the following ones decrease by one)
+    void removeSeries(int index);
+
+    /// Return the number of series
+    int seriesCount() const { return (int) mSeries.size(); }
+
+    /// Return the name of a series
+    const std::string &seriesName(int index) const { return series(index).name; }
+
+    /// Return the color of a series
+    const Color &seriesColor(int index) const { return series(index).color; }
+    /// Set the color of a series
+    void setSeriesColor(int index, const Color &color) { series(index).color = color; markDirty(); }
+
+    /// Return whether a series is drawn
+    bool seriesVisible(int index) const { return series(index).visible; }
+    /// Set whether a series is drawn
+    void setSeriesVisible(int index, bool visible) { series(index).visible = visible; markDirty(); }
+
+    /// Return the maximum number of samples that a series retains
+    size_t seriesCapacity(int index) const { return series(index).capacity; }
+
+    /// Return the number of samples that a series currently holds
+    size_t seriesSize(int index) const { return series(index).size; }
+
+    /// Set the position of the first sample and the spacing of samples on the x axis
+    void setSeriesSampling(int index, double start, double step);
+
+    /**
+     * \brief Overwrite the samples with indices <tt>[offset, offset + count)</tt>
+     *
+     * Indices are relative to the oldest retained sample. Only the affected
+     * part of the vertex buffer is uploaded. Writing past the current size
+     * grows the series up to its capacity.
+     */
+    void setSeriesData(int index, size_t offset, const float *values, size_t count);
+
+    /// Append samples to a series, discarding the oldest ones once it is full
+    void appendSeries(int index, const float *values, size_t count);
+
+    /// Return the visible range of the x axis
+    const Vector2d &xRange() const { return mXRange; }
+    /// Set the visible range of the x axis
+    void setXRange(const Vector2d &range) { mXRange = range; markDirty(); }
+
+    /// Return the visible range of the y axis
+    const Vector2f &yRange() const { return mYRange; }
+    /// Set the visible range of the y axis
+    void setYRange(const Vector2f &range) { mYRange = range; markDirty(); }
+
+    /// Return whether the x axis follows the most recent sample
+    bool autoScroll() const { return mAutoScroll; }
+    /// Set whether the x axis follows the most recent sample (disabled by panning)
+    void setAutoScroll(bool autoScroll) { mAutoScroll = autoScroll; markDirty(); }
+
+    /// Set the visible ranges to the extent of the visible series
+    void fitView();
+
+    /// Return the color of the axes, grid lines and labels
+    const Color &axisColor() const { return mAxisColor; }
+    /// Set the color of the axes, grid lines and labels
+    void setAxisColor(const Color &color) { mAxisColor = color; markDirty(); }
+
+    virtual bool mouseDragEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) override;
+    virtual bool scrollEvent(const Vector2i &p, const Vector2f &rel) override;
+    virtual void draw(NVGcontext *ctx) override;
+    virtual void drawGL() override;
+    virtual void save(Serializer &s) const override;
+    virtual bool load(Serializer &s) override;
+
+protected:
+    struct Series {
+        std::string name;
+        Color color;
+        bool visible;
+        /* The buffer holds 'capacity' samples and a copy of the first one,
+           which joins the two pieces of the line strip when it wraps around */
+        GLuint buffer;
+        size_t capacity, start, size;
+        /* Number of samples ever appended, i.e. the index of the next one */
+        size_t total;
+        double xStart, xStep;
+        /* Extent of all samples uploaded so far (used by fitView()) */
+        float min, max;
+    };
+
+    Series &series(int index);
+    const Series &series(int index) const;
+
+    /// Upload samples to consecutive buffer positions starting at \c pos (wrapping around)
+    void upload(Series &series, size_t pos, const float *values, size_t count);
+
+    /// Draw the grid lines and tick labels of both axes
+    void drawAxes(NVGcontext *ctx);
+
+protected:
+    std::vector<Series> mSeries;
+    GLShader mShader;
+    Vector2d mXRange;
+    Vector2f mYRange;
+    Color mAxisColor;
+    bool mAutoScroll;
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+NAMESPACE_END(nanogui)
@@ -33,17 +33,17 @@ public:
     Popup(Widget *parent, Window *parentWindow);
 
     /// Return the anchor position in the parent window; the placement of the popup is relative to it
-    void setAnchorPos(const Vector2i &anchorPos) { mAnchorPos = anchorPos; }
+    void setAnchorPos(const Vector2i &anchorPos) { mAnchorPos = anchorPos; invalidateLayout(); }
     /// Set the anchor position in the parent window; the placement of the popup is relative to it
     const Vector2i &anchorPos() const { return mAnchorPos; }
 
     /// Set the anchor height; this determines the vertical shift relative to the anchor position
-    void setAnchorHeight(int anchorHeight) { mAnchorHeight = anchorHeight; }
+    void setAnchorHeight(int anchorHeight) { mAnchorHeight = anchorHeight; invalidateLayout(); }
     /// Return the anchor height; this determines the vertical shift relative to the anchor position
     int anchorHeight() const { return mAnchorHeight; }
 
     /// Set the side of the parent window at which popup will appear
-    void setSide(Side popupSide) { mSide = popupSide; }
+    void setSide(Side popupSide) { mSide = popupSide; invalidateLayout(); }
     /// Return the side of the parent window at which popup will appear
     Side side() const { return mSide; }
 
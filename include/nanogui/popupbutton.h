@@ -34,7 +34,7 @@ public:
                 int buttonIcon = 0);
     virtual ~PopupButton();
 
-    void setChevronIcon(int icon) { mChevronIcon = icon; }
+    void setChevronIcon(int icon) { mChevronIcon = icon; markDirty(); }
     int chevronIcon() const { return mChevronIcon; }
 
     void setSide(Popup::Side popupSide);
@@ -0,0 +1,161 @@
+/*
+    nanogui/profiler.h -- Frame time measurements for a Screen
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <algorithm>
+#include <chrono>
+#include <typeindex>
+#include <unordered_map>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \struct FrameTimings profiler.h nanogui/profiler.h
+ *
+ * \brief CPU time (in milliseconds) spent on the stages of a single frame.
+ *
+ * OpenGL executes commands asynchronously, hence GPU work shows up in the
+ * stage that waits for it (usually the buffer swap).
+ */
+struct FrameTimings {
+    /// \ref Screen::performLayout() calls since the previous frame
+    double layout = 0.0;
+    /// \ref Screen::drawContents()
+    double contents = 0.0;
+    /// Building the NanoVG frame, i.e. \ref Widget::draw() and tooltips
+    double widgets = 0.0;
+    /// Rendering the NanoVG frame in \c nvgEndFrame()
+    double flush = 0.0;
+    /// Presenting the frame (buffer swap)
+    double swap = 0.0;
+    /// The complete \ref Screen::drawAll() call
+    double total = 0.0;
+};
+
+/**
+ * \struct WidgetClassStats profiler.h nanogui/profiler.h
+ *
+ * \brief Accumulated draw statistics of all widgets of one class.
+ */
+struct WidgetClassStats {
+    /// Class name
+    std::string name;
+    /// Time spent in \ref Widget::draw() in milliseconds, excluding child widgets
+    double time = 0.0;
+    /// Number of \ref Widget::draw() calls
+    size_t calls = 0;
+};
+
+/**
+ * \class FrameProfiler profiler.h nanogui/profiler.h
+ *
+ * \brief Records the timings of the last frames drawn by a \ref Screen.
+ *
+ * Frame timings are kept in a ring buffer of fixed capacity. Optionally,
+ * every \ref Widget::draw() call is timed as well and accumulated per
+ * widget class (see \ref setWidgetInstrumentation()). See \ref
+ * Screen::setProfiling().
+ */
+class NANOGUI_EXPORT FrameProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Create a profiler that retains the timings of the last \c capacity frames
+    FrameProfiler(size_t capacity = 240);
+
+    /// Return the number of frames that are retained
+    size_t capacity() const { return mFrames.size(); }
+
+    /// Set the number of frames that are retained (discards all recorded frames)
+    void setCapacity(size_t capacity);
+
+    /// Return the number of frames in the ring buffer
+    size_t frameCount() const { return std::min(mTotalFrames, mFrames.size()); }
+
+    /// Return the number of frames recorded since the last call to \ref clear()
+    size_t totalFrames() const { return mTotalFrames; }
+
+    /// Return the timings of a frame in the ring buffer (0 is the oldest)
+    const FrameTimings &frame(size_t index) const;
+
+    /// Return the timings of all frames in the ring buffer, oldest first
+    std::vector<FrameTimings> frames() const;
+
+    /// Return the average timings of the frames in the ring buffer
+    FrameTimings average() const;
+
+    /// Return the largest timings of the frames in the ring buffer (per stage)
+    FrameTimings peak() const;
+
+    /// Return whether \ref Widget::draw() calls are timed
+    bool widgetInstrumentation() const { return mWidgetInstrumentation; }
+
+    /**
+     * \brief Time every \ref Widget::draw() call
+     *
+     * Adds the overhead of two clock queries per drawn widget. Note that
+     * this only measures the construction of NanoVG paths and text, the
+     * actual rendering happens during the \ref FrameTimings::flush stage.
+     */
+    void setWidgetInstrumentation(bool value) { mWidgetInstrumentation = value; }
+
+    /// Return the per-class draw statistics since \ref clear(), most expensive first
+    std::vector<WidgetClassStats> widgetStats() const;
+
+    /// Discard all recorded frames and widget statistics
+    void clear();
+
+    /// Return the number of milliseconds that passed since \c start
+    static double elapsed(const Clock::time_point &start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+public:
+    /********* Interface used by Screen and Widget *********/
+
+    /// Return the timings of the frame that is currently being drawn
+    FrameTimings &current() { return mCurrent; }
+
+    /// Add the timings of \ref current() to the ring buffer and reset it
+    void commitFrame();
+
+    /// Return the profiler that instruments \ref Widget::draw() calls (if any)
+    static FrameProfiler *active() { return sActive; }
+
+    /// Set the profiler that instruments \ref Widget::draw() calls
+    static void setActive(FrameProfiler *profiler);
+
+    /// Called before drawing a widget while this profiler is \ref active()
+    void beginWidget() { mStack.push_back({ Clock::now(), 0.0 }); }
+
+    /// Called after drawing a widget while this profiler is \ref active()
+    void endWidget(const Widget *widget);
+
+protected:
+    struct Scope {
+        Clock::time_point start;
+        double children;
+    };
+
+    std::vector<FrameTimings> mFrames;
+    size_t mTotalFrames;
+    FrameTimings mCurrent;
+    bool mWidgetInstrumentation;
+    std::unordered_map<std::type_index, WidgetClassStats> mWidgetStats;
+    std::vector<Scope> mStack;
+
+    static FrameProfiler *sActive;
+};
+
+NAMESPACE_END(nanogui)
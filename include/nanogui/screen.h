@@ -15,6 +15,7 @@
 #pragma once
 
 #include <nanogui/widget.h>
+#include <mutex>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -96,7 +97,7 @@ public:
     const Color &background() const { return mBackground; }
 
     /// Set the screen's background color
-    void setBackground(const Color &background) { mBackground = background; }
+    void setBackground(const Color &background) { mBackground = background; markDirty(); }
 
     /// Set the top-level window visibility (no effect on full-screen windows)
     void setVisible(bool visible);
@@ -104,9 +105,106 @@ public:
     /// Set window size
     void setSize(const Vector2i& size);
 
-    /// Draw the Screen contents
+    /**
+     * \brief Draw the Screen contents
+     *
+     * Rendering and the buffer swap are skipped when no widget has been
+     * marked as dirty since the previous frame (see \ref Widget::markDirty()).
+     */
     virtual void drawAll();
 
+    /// Return the number of \ref drawAll() calls that were skipped because nothing changed
+    size_t skippedFrames() const { return mSkippedFrames; }
+
+    /**
+     * \brief Invoke a callback once before the next frame is drawn
+     *
+     * The callback receives the current time (see \c glfwGetTime()) and is
+     * expected to update the animated state, e.g. by calling setters that
+     * mark widgets as dirty. Animations that should continue must request
+     * another frame from within the callback. While frames are requested,
+     * \ref mainloop() draws at the refresh rate of the display; otherwise,
+     * it sleeps until the next input event or scheduled redraw.
+     *
+     * This function (unlike most others) may be called from any thread, in
+     * which case it wakes up \ref mainloop(). The callback is always invoked
+     * on the thread that calls \ref drawAll().
+     *
+     * Returns an identifier that can be passed to \ref cancelAnimationFrame().
+     */
+    int requestAnimationFrame(const std::function<void(double)> &callback);
+
+    /// Cancel a callback registered with \ref requestAnimationFrame()
+    void cancelAnimationFrame(int id);
+
+    /**
+     * \brief Mark \c widget as dirty once the clock reaches \c time
+     *
+     * \c time is specified in seconds on the \c glfwGetTime() clock. Only
+     * the earliest pending redraw is retained per widget. See \ref
+     * Widget::scheduleRedrawAt().
+     */
+    void scheduleRedraw(Widget *widget, double time);
+
+    /**
+     * \brief Return when \ref drawAll() next has work to do
+     *
+     * The result is a time on the \c glfwGetTime() clock, which lies in the
+     * past if a frame is due immediately (dirty widgets or animation frame
+     * requests) and is infinite if the screen is idle.
+     */
+    double nextFrameTime() const;
+
+    /**
+     * \brief Enable or disable partial redraws
+     *
+     * When enabled, \ref drawAll() only repaints the regions covered by
+     * widgets that were marked as dirty since the previous frame (see \ref
+     * Widget::markDirty()) and skips all subtrees that don't intersect them.
+     * Changes to the screen itself (e.g. resizing or input events) still
+     * cause a full repaint. The last frame is retained in an offscreen
+     * framebuffer, hence this requires a default framebuffer without
+     * multisampling.
+     *
+     * \ref drawContents() is invoked once per damaged region, with the
+     * scissor test set up accordingly.
+     */
+    void setPartialRedraw(bool partialRedraw);
+
+    /// Return whether partial redraws are enabled (see \ref setPartialRedraw())
+    bool partialRedraw() const { return mPartialRedraw; }
+
+    /**
+     * \brief Enable or disable the frame time profiler
+     *
+     * While enabled, the timings of every frame drawn by \ref drawAll() are
+     * recorded by the \ref FrameProfiler returned by \ref profiler().
+     * Disabling the profiler discards all measurements.
+     */
+    void setProfiling(bool profiling);
+
+    /// Return whether the frame time profiler is enabled (see \ref setProfiling())
+    bool profiling() const { return mProfiler != nullptr; }
+
+    /// Return the frame time profiler, or \c nullptr if profiling is disabled
+    FrameProfiler *profiler() { return mProfiler; }
+
+    /// Return the cache of text measurements shared by all widgets (see \ref textBounds())
+    TextMetricsCache *textMetrics() { return mTextMetrics; }
+
+    /**
+     * \brief Show a \ref Graph of recent frame times in the top right corner
+     *
+     * The graph is scaled so that its top corresponds to twice the 16.7 ms
+     * budget of a 60 Hz display. It is refreshed whenever the screen is
+     * redrawn anyway and does not cause any redraws of its own. Enabling
+     * the overlay also enables profiling.
+     */
+    void setProfilerOverlay(bool overlay);
+
+    /// Return whether the frame time overlay is shown (see \ref setProfilerOverlay())
+    bool profilerOverlay() const { return mProfilerOverlay != nullptr; }
+
     /// Draw the window contents --- put your OpenGL draw calls here
     virtual void drawContents() { /* To be overridden */ }
 
@@ -135,6 +233,21 @@ public:
     /// Return a pointer to the underlying GLFW window data structure
     GLFWwindow *glfwWindow() { return mGLFWWindow; }
 
+    /// Return whether this screen renders offscreen (see \ref initializeHeadless())
+    bool headless() const { return mEGLContext != nullptr; }
+
+    /// Return the size of the framebuffer in hardware pixels
+    const Vector2i &framebufferSize() const { return mFBSize; }
+
+    /**
+     * \brief Read back the most recently drawn frame
+     *
+     * Returns \ref framebufferSize().prod() RGBA pixels with 8 bits per
+     * component, ordered from the top left to the bottom right. Headless
+     * screens read the back buffer, all others the front buffer.
+     */
+    std::vector<uint8_t> readPixels();
+
     /// Return a pointer to the underlying nanoVG draw context
     NVGcontext *nvgContext() { return mNVGContext; }
 
@@ -144,9 +257,31 @@ public:
     using Widget::performLayout;
 
     /// Compute the layout of all widgets
-    void performLayout() {
-        Widget::performLayout(mNVGContext);
-    }
+    void performLayout();
+
+    /**
+     * \brief Lay out independent subtrees concurrently
+     *
+     * When enabled, \ref performLayout() lays out the windows of the screen
+     * on the threads of \ref ThreadPool::shared(). Nested containers whose
+     * children are independent (\ref GridLayout, \ref StackedWidget and
+     * thereby \ref TabWidget) distribute their children in the same way
+     * (see \ref Widget::performLayouts()). Text is measured through the
+     * thread-safe \ref TextMetricsCache, which does not require the OpenGL
+     * context.
+     *
+     * Custom widgets must then only modify their own subtree in \ref
+     * Widget::preferredSize() and \ref Widget::performLayout(), and measure
+     * text via \ref textBounds() and related functions instead of calling
+     * NanoVG directly. Methods overridden in Python hold the interpreter
+     * lock and therefore still run one at a time.
+     * Since the damaged regions are not tracked during a parallel layout,
+     * the next frame is always a complete redraw.
+     */
+    void setParallelLayout(bool parallelLayout) { mParallelLayout = parallelLayout; }
+
+    /// Return whether independent subtrees are laid out concurrently (see \ref setParallelLayout())
+    bool parallelLayout() const { return mParallelLayout; }
 
 public:
     /********* API for applications which manage GLFW themselves *********/
@@ -168,6 +303,26 @@ public:
     /// Initialize the \ref Screen
     void initialize(GLFWwindow *window, bool shutdownGLFWOnDestruct);
 
+    /**
+     * \brief Initialize the \ref Screen without a window
+     *
+     * Creates an OpenGL 3.3 core profile context that renders into an
+     * offscreen EGL pbuffer surface of the given size (at 96 dpi), which
+     * requires neither a display server nor \ref nanogui::init(). This is
+     * meant for automated tests, screenshots and benchmarks: call \ref
+     * drawAll() to render a frame and \ref readPixels() to retrieve it.
+     *
+     * Input is delivered through the event handlers below, with the same
+     * conventions as the GLFW callbacks they normally receive. A call to
+     * \ref resizeCallbackEvent() takes the new framebuffer size. Unless GLFW
+     * was initialized, \c glfwGetTime() always returns zero, hence tooltips
+     * never appear and the output only depends on the events.
+     *
+     * Only available when NanoGUI was compiled with the \c NANOGUI_HEADLESS
+     * CMake option, throws \c std::runtime_error otherwise.
+     */
+    void initializeHeadless(const Vector2i &size, float pixelRatio = 1.f);
+
     /* Event handlers */
     bool cursorPosCallbackEvent(double x, double y);
     bool mouseButtonCallbackEvent(int button, int action, int modifiers);
@@ -184,6 +339,32 @@ public:
     void moveWindowToFront(Window *window);
     void drawWidgets();
 
+protected:
+    /// Record the bounds of a widget (at absolute position \c pos) as damaged
+    void addDamage(const Widget *widget, const Vector2i &pos);
+
+    /// Merge the damaged regions, returns \c false when a full repaint is needed
+    bool updateRedrawRegions();
+
+    /// Flag all subtrees of \c widget that don't intersect \ref mRedrawRegion
+    void cullWidgets(Widget *widget, const Vector2i &offset,
+                     std::vector<Widget *> &culled);
+
+    /// Create the NanoVG context and set up the state shared by all backends
+    void initializeContext();
+
+    /// Make the OpenGL context of this screen current on the calling thread
+    void makeContextCurrent();
+
+    /// Refresh the frame time overlay with the latest measurements
+    void updateProfilerOverlay();
+
+    /// Run pending animation frame callbacks and scheduled redraws that are due
+    void runScheduled();
+
+    /// (Re-)create the offscreen surface of a headless screen to match \ref mFBSize
+    void createHeadlessSurface();
+
 protected:
     GLFWwindow *mGLFWWindow;
     NVGcontext *mNVGContext;
@@ -203,6 +384,27 @@ protected:
     bool mShutdownGLFWOnDestruct;
     bool mFullscreen;
     std::function<void(Vector2i)> mResizeCallback;
+    size_t mSkippedFrames;
+    bool mPartialRedraw;
+    bool mParallelLayout;
+    bool mDamageAll;
+    std::vector<Vector4i, Eigen::aligned_allocator<Vector4i>> mDamage;
+    std::vector<Vector4i, Eigen::aligned_allocator<Vector4i>> mRedrawRegions;
+    Vector4i mRedrawRegion;
+    GLFramebuffer *mRetainedFrame;
+    FrameProfiler *mProfiler;
+    Graph *mProfilerOverlay;
+    TextMetricsCache *mTextMetrics;
+    /* Guards the animation frame requests, which may arrive from other threads */
+    mutable std::mutex mAnimationFramesMutex;
+    std::vector<std::pair<int, std::function<void(double)>>> mAnimationFrames;
+    int mNextAnimationFrame;
+    /* Pending redraws requested via scheduleRedraw(), at most one per widget.
+       The screen itself is tracked separately to avoid a reference cycle. */
+    std::vector<std::pair<double, ref<Widget>>> mScheduledRedraws;
+    double mRedrawTime;
+    /* EGL handles of a headless screen (EGLDisplay, EGLConfig, ..) */
+    void *mEGLDisplay, *mEGLConfig, *mEGLContext, *mEGLSurface;
 public:
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
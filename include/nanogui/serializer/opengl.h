@@ -45,11 +45,11 @@ struct serialization_helper<GLShader> {
 
                 if (item.first == "indices") {
                     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buf.id);
-                    glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, totalSize,
+                    glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, buf.offset, totalSize,
                                        temp.data());
                 } else {
                     glBindBuffer(GL_ARRAY_BUFFER, buf.id);
-                    glGetBufferSubData(GL_ARRAY_BUFFER, 0, totalSize, temp.data());
+                    glGetBufferSubData(GL_ARRAY_BUFFER, buf.offset, totalSize, temp.data());
                 }
                 s.set("data", temp);
                 s.pop();
@@ -74,6 +74,9 @@ struct serialization_helper<GLShader> {
             }
             value->bind();
             for (auto key : keys) {
+                /* Streamed attributes are restored as regular ones */
+                if (value->mStreamBuffers.find(key) != value->mStreamBuffers.end())
+                    value->freeAttrib(key);
                 if (value->mBufferObjects.find(key) == value->mBufferObjects.end()) {
                     GLuint bufferID;
                     glGenBuffers(1, &bufferID);
@@ -90,12 +93,14 @@ struct serialization_helper<GLShader> {
                 s.get("version", buf.version);
                 s.get("data", data);
                 s.pop();
+                buf.offset = 0;
 
                 size_t totalSize = (size_t) buf.size * (size_t) buf.compSize;
                 if (key == "indices") {
                     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buf.id);
                     glBufferData(GL_ELEMENT_ARRAY_BUFFER, totalSize,
                                  (void *) data.data(), GL_DYNAMIC_DRAW);
+                    value->mIndexOffset = 0;
                 } else {
                     int attribID = value->attrib(key);
                     glEnableVertexAttribArray(attribID);
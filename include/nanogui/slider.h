@@ -26,16 +26,16 @@ public:
     Slider(Widget *parent);
 
     float value() const { return mValue; }
-    void setValue(float value) { mValue = value; }
+    void setValue(float value) { mValue = value; markDirty(); }
 
     const Color &highlightColor() const { return mHighlightColor; }
-    void setHighlightColor(const Color &highlightColor) { mHighlightColor = highlightColor; }
+    void setHighlightColor(const Color &highlightColor) { mHighlightColor = highlightColor; markDirty(); }
 
     std::pair<float, float> range() const { return mRange; }
-    void setRange(std::pair<float, float> range) { mRange = range; }
+    void setRange(std::pair<float, float> range) { mRange = range; markDirty(); }
 
     std::pair<float, float> highlightedRange() const { return mHighlightedRange; }
-    void setHighlightedRange(std::pair<float, float> highlightedRange) { mHighlightedRange = highlightedRange; }
+    void setHighlightedRange(std::pair<float, float> highlightedRange) { mHighlightedRange = highlightedRange; markDirty(); }
 
     std::function<void(float)> callback() const { return mCallback; }
     void setCallback(const std::function<void(float)> &callback) { mCallback = callback; }
@@ -0,0 +1,65 @@
+/*
+    nanogui/spatialindex.h -- Uniform grid over the bounds of child widgets
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class SpatialIndex spatialindex.h nanogui/spatialindex.h
+ *
+ * \brief Accelerates hit tests against a large number of child widgets.
+ *
+ * The bounding box of all children is subdivided into a uniform grid with
+ * roughly one cell per child, and each cell lists the (indices of the)
+ * children overlapping it in drawing order. A hit test then only needs to
+ * look at the children of a single cell instead of all of them.
+ *
+ * This is the mechanism behind \ref Widget::setSpatialIndex().
+ */
+class NANOGUI_EXPORT SpatialIndex {
+public:
+    /// A range of child indices in ascending (i.e. back to front) order
+    struct Range {
+        const uint32_t *first, *last;
+        const uint32_t *begin() const { return first; }
+        const uint32_t *end() const { return last; }
+        bool empty() const { return first == last; }
+    };
+
+    /// Rebuild the grid from the current bounds of the given widgets
+    void build(const std::vector<Widget *> &children);
+
+    /**
+     * \brief Return the children whose bounds overlap the cell containing \c p
+     *
+     * \c p is specified in the coordinate system of the children's
+     * positions. This is a superset of the children containing \c p,
+     * regardless of their visibility.
+     */
+    Range query(const Vector2i &p) const;
+
+    /// Return the number of grid cells
+    size_t cellCount() const { return mCellStart.empty() ? 0 : mCellStart.size() - 1; }
+
+protected:
+    Vector2i mOrigin = Vector2i::Zero();
+    Vector2i mCellSize = Vector2i::Ones();
+    Vector2i mCells = Vector2i::Zero();
+    /* Cell i holds mItems[mCellStart[i]] .. mItems[mCellStart[i + 1] - 1] */
+    std::vector<uint32_t> mCellStart;
+    std::vector<uint32_t> mItems;
+};
+
+NAMESPACE_END(nanogui)
@@ -46,22 +46,22 @@ public:
     void setEditable(bool editable);
 
     bool spinnable() const { return mSpinnable; }
-    void setSpinnable(bool spinnable) { mSpinnable = spinnable; }
+    void setSpinnable(bool spinnable) { mSpinnable = spinnable; invalidateLayout(); markDirty(); }
 
     const std::string &value() const { return mValue; }
-    void setValue(const std::string &value) { mValue = value; }
+    void setValue(const std::string &value) { mValue = value; invalidateLayout(); markDirty(); }
 
     const std::string &defaultValue() const { return mDefaultValue; }
     void setDefaultValue(const std::string &defaultValue) { mDefaultValue = defaultValue; }
 
     Alignment alignment() const { return mAlignment; }
-    void setAlignment(Alignment align) { mAlignment = align; }
+    void setAlignment(Alignment align) { mAlignment = align; markDirty(); }
 
     const std::string &units() const { return mUnits; }
-    void setUnits(const std::string &units) { mUnits = units; }
+    void setUnits(const std::string &units) { mUnits = units; invalidateLayout(); markDirty(); }
 
     int unitsImage() const { return mUnitsImage; }
-    void setUnitsImage(int image) { mUnitsImage = image; }
+    void setUnitsImage(int image) { mUnitsImage = image; invalidateLayout(); markDirty(); }
 
     /// Return the underlying regular expression specifying valid formats
     const std::string &format() const { return mFormat; }
@@ -71,7 +71,7 @@ public:
     /// Return the placeholder text to be displayed while the text box is empty.
     const std::string &placeholder() const { return mPlaceholder; }
     /// Specify a placeholder text to be displayed while the text box is empty.
-    void setPlaceholder(const std::string &placeholder) { mPlaceholder = placeholder; }
+    void setPlaceholder(const std::string &placeholder) { mPlaceholder = placeholder; markDirty(); }
 
     /// Set the \ref Theme used to draw this widget
     virtual void setTheme(Theme *theme) override;
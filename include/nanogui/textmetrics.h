@@ -0,0 +1,246 @@
+/*
+    nanogui/textmetrics.h -- Cache for the results of NanoVG text
+    measurements
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class TextMetricsCache textmetrics.h nanogui/textmetrics.h
+ *
+ * \brief Least recently used cache of text bounds and glyph positions.
+ *
+ * Measuring a string with NanoVG runs the font shaper over the complete
+ * string, and widgets do so on every layout and often on every frame,
+ * although their text rarely changes. Every \ref Screen owns a cache for
+ * its NanoVG context, which is used by the free functions \ref
+ * textBounds(), \ref textBoxBounds() and \ref textGlyphPositions().
+ *
+ * Entries are keyed on the font face, font size, alignment, line height,
+ * wrap width and the string itself. Measurements are performed at the
+ * origin and translated to the requested position.
+ *
+ * The cache is thread-safe, which allows \ref Screen::setParallelLayout().
+ * Text is measured with private NanoVG contexts that have no renderer and
+ * only contain the fonts registered with \ref addFont() (the \ref Theme
+ * registers its fonts automatically). Each thread that measures text
+ * concurrently uses a context of its own, hence misses are neither
+ * serialized nor do they touch the state of the context that draws the user
+ * interface, which is only used for fonts that were not registered.
+ */
+class NANOGUI_EXPORT TextMetricsCache {
+public:
+    /// Create a cache that holds up to \c capacity measurements
+    TextMetricsCache(size_t capacity = 4096);
+
+    /// Release the measurement contexts
+    ~TextMetricsCache();
+
+    /**
+     * \brief Register font data for measurements
+     *
+     * The data (e.g. the contents of a TrueType file) must remain valid for
+     * the lifetime of the cache. Fonts that are created directly with \c
+     * nvgCreateFont() and not registered here are measured through the
+     * NanoVG context passed to the measurement functions, one at a time.
+     */
+    void addFont(const std::string &name, const unsigned char *data, size_t size);
+
+    /// Return the ratio of framebuffer to window pixels at which text is measured
+    float pixelRatio() const {
+        std::lock_guard<std::mutex> guard(mContextMutex);
+        return mPixelRatio;
+    }
+
+    /// Set the ratio of framebuffer to window pixels at which text is measured (clears the cache if it changes)
+    void setPixelRatio(float pixelRatio);
+
+    /// Return the maximum number of cached measurements
+    size_t capacity() const {
+        std::lock_guard<std::mutex> guard(mMutex);
+        return mCapacity;
+    }
+
+    /// Set the maximum number of cached measurements (evicts the oldest ones)
+    void setCapacity(size_t capacity);
+
+    /// Return the number of cached measurements
+    size_t size() const {
+        std::lock_guard<std::mutex> guard(mMutex);
+        return mEntries.size();
+    }
+
+    /// Return the number of measurements that were answered from the cache
+    size_t hits() const {
+        std::lock_guard<std::mutex> guard(mMutex);
+        return mHits;
+    }
+
+    /// Return the number of measurements that had to be performed by NanoVG
+    size_t misses() const {
+        std::lock_guard<std::mutex> guard(mMutex);
+        return mMisses;
+    }
+
+    /// Reset the hit and miss counters
+    void resetStatistics() {
+        std::lock_guard<std::mutex> guard(mMutex);
+        mHits = mMisses = 0;
+    }
+
+    /// Discard all cached measurements (e.g. after fonts or the pixel ratio changed)
+    void clear();
+
+    /// Cached equivalent of \c nvgTextBounds()
+    float textBounds(NVGcontext *ctx, const std::string &font, float size,
+                     int align, float x, float y, const std::string &text,
+                     float *bounds);
+
+    /// Cached equivalent of \c nvgTextBoxBounds()
+    void textBoxBounds(NVGcontext *ctx, const std::string &font, float size,
+                       int align, float lineHeight, float x, float y,
+                       float breakWidth, const std::string &text, float *bounds);
+
+    /// Cached equivalent of \c nvgTextGlyphPositions()
+    int textGlyphPositions(NVGcontext *ctx, const std::string &font, float size,
+                           int align, float x, float y, const std::string &text,
+                           NVGglyphPosition *positions, int maxPositions);
+
+    /// Return the cache that is registered for a NanoVG context (if any)
+    static TextMetricsCache *find(NVGcontext *ctx);
+
+    /// Register the cache for a NanoVG context (\c nullptr unregisters it)
+    static void registerCache(NVGcontext *ctx, TextMetricsCache *cache);
+
+protected:
+    enum class Kind { Bounds, BoxBounds, Glyphs };
+
+    struct Glyph {
+        size_t offset;
+        float x, minx, maxx;
+    };
+
+    /* The strings are referenced instead of copied, so that lookups don't
+       need to allocate. Keys stored in the map point into their entry. */
+    struct Key {
+        Kind kind;
+        int align;
+        float size, lineHeight, breakWidth;
+        const std::string *font, *text;
+        size_t hash;
+
+        bool operator==(const Key &k) const;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key &k) const { return k.hash; }
+    };
+
+    struct Entry {
+        std::string font, text;
+        Key key;
+        float advance;
+        float bounds[4];
+        std::vector<Glyph> glyphs;
+    };
+
+    struct Font {
+        std::string name;
+        const unsigned char *data;
+        size_t size;
+    };
+
+    /* A NanoVG context without renderer that is used by one thread at a time */
+    struct MeasureContext {
+        NVGcontext *ctx;
+        size_t generation, uses;
+    };
+
+    /**
+     * \brief Return the entry for a key, measuring the text if necessary
+     *
+     * \c guard must hold \ref mMutex, which is released while the text is
+     * measured. The entry remains valid until \ref mMutex is released.
+     */
+    const Entry &lookup(NVGcontext *ctx, Key key, std::unique_lock<std::mutex> &guard);
+
+    /// Measure the text of an entry (does not require \ref mMutex)
+    void measure(NVGcontext *ctx, Entry &entry);
+
+    /// Create a measurement context containing the given fonts
+    static NVGcontext *createContext(const std::vector<Font> &fonts);
+
+    /// Take an idle measurement context that contains the given font (or create one)
+    bool acquireContext(const std::string &font, MeasureContext &context, float &pixelRatio);
+
+    /// Return a measurement context to the idle ones
+    void releaseContext(MeasureContext &context);
+
+    static size_t hashKey(const Key &key);
+
+protected:
+    /* Protects the measurements, but is not held while measuring */
+    mutable std::mutex mMutex;
+    size_t mCapacity;
+    size_t mHits, mMisses;
+    /* Incremented by clear(), so that measurements which were in progress
+       at that time are not stored */
+    size_t mGeneration;
+    /* Most recently used entries first */
+    std::list<Entry> mEntries;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> mIndex;
+
+    /* Protects the fonts and the measurement contexts */
+    mutable std::mutex mContextMutex;
+    std::vector<Font> mFonts;
+    float mPixelRatio;
+    /* Incremented whenever the fonts change, which outdates the contexts */
+    size_t mContextGeneration;
+    std::vector<MeasureContext> mIdleContexts;
+
+    /* Serializes measurements through the NanoVG context of the caller */
+    std::mutex mSharedMutex;
+};
+
+/**
+ * \brief Measure a single line of text like \c nvgTextBounds()
+ *
+ * The font state is specified explicitly, and the state of the NanoVG
+ * context is left unchanged. Uses the \ref TextMetricsCache of the \ref
+ * Screen that owns \c ctx when there is one. Returns the horizontal advance
+ * and optionally stores <tt>[xmin, ymin, xmax, ymax]</tt> in \c bounds.
+ */
+extern NANOGUI_EXPORT float textBounds(NVGcontext *ctx, const std::string &font,
+                                       float size, int align, float x, float y,
+                                       const std::string &text,
+                                       float *bounds = nullptr);
+
+/// Measure a text box like \c nvgTextBoxBounds() (see \ref textBounds())
+extern NANOGUI_EXPORT void textBoxBounds(NVGcontext *ctx, const std::string &font,
+                                         float size, int align, float lineHeight,
+                                         float x, float y, float breakWidth,
+                                         const std::string &text, float *bounds);
+
+/// Compute glyph positions like \c nvgTextGlyphPositions() (see \ref textBounds())
+extern NANOGUI_EXPORT int textGlyphPositions(NVGcontext *ctx, const std::string &font,
+                                             float size, int align, float x, float y,
+                                             const std::string &text,
+                                             NVGglyphPosition *positions,
+                                             int maxPositions);
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,110 @@
+/*
+    nanogui/textureatlas.h -- Packs many small images into a single texture
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/opengl.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class TextureAtlas textureatlas.h nanogui/textureatlas.h
+ *
+ * \brief Packs small RGBA8 images (icons, thumbnails, ..) into one OpenGL texture.
+ *
+ * Images that share an atlas can be drawn with a single draw call. They are
+ * placed with the skyline bottom-left heuristic. Removed images leave holes
+ * that are reclaimed by \ref defragment(), which repacks all images (from a
+ * copy of their pixels that the atlas retains) and is invoked automatically
+ * when an image does not fit otherwise. The regions of all images may change
+ * in the process, which is signalled by a new \ref version().
+ *
+ * All functions must be called while the OpenGL context is current.
+ */
+class NANOGUI_EXPORT TextureAtlas {
+public:
+    /// Create an empty atlas texture
+    TextureAtlas(const Vector2i &size = Vector2i(2048, 2048), int padding = 1);
+
+    /// Release the texture
+    ~TextureAtlas();
+
+    /// Return the size of the atlas texture
+    const Vector2i &size() const { return mSize; }
+
+    /// Return the OpenGL texture
+    GLuint texture() const { return mTexture; }
+
+    /**
+     * \brief Add an image and return its identifier, or -1 if the atlas is full
+     *
+     * \c stride is the distance of consecutive rows in bytes (by default
+     * <tt>4 * size.x()</tt>), which allows adding a part of a larger image.
+     */
+    int add(const Vector2i &size, const uint8_t *data, size_t stride = 0);
+
+    /// Remove an image (its region may be reused by images that are added later)
+    void remove(int id);
+
+    /// Return the region <tt>(x, y, width, height)</tt> of an image within the atlas texture
+    Vector4i region(int id) const;
+
+    /// Return the number of images in the atlas
+    size_t imageCount() const { return mImageCount; }
+
+    /// Return the fraction of the texture that is covered by images
+    float occupancy() const;
+
+    /// Return a counter that is incremented whenever the regions of the images change
+    size_t version() const { return mVersion; }
+
+    /// Repack all images to reclaim the space of removed ones (the layout is kept if they don't fit)
+    void defragment();
+
+protected:
+    struct Image {
+        Vector2i position, size;
+        std::vector<uint8_t> data;
+        bool valid;
+    };
+
+    /* A horizontal segment of the upper boundary of the occupied area */
+    struct SkylineNode {
+        int x, y, width;
+    };
+
+    /// Find a position for a rectangle of the given size (including padding)
+    bool allocate(const Vector2i &size, Vector2i &position);
+
+    /// Return the lowest position of a rectangle of width \c width at skyline node \c i, or -1
+    int fit(size_t i, int width, int height) const;
+
+    /// Copy the pixels of an image into the texture
+    void upload(const Image &image);
+
+protected:
+    Vector2i mSize;
+    int mPadding;
+    GLuint mTexture;
+    std::vector<SkylineNode> mSkyline;
+    std::vector<Image> mImages;
+    /* Identifiers of removed images */
+    std::vector<int> mFreeIds;
+    size_t mImageCount;
+    /* Area of the removed images that has not been reclaimed yet */
+    size_t mWastedArea;
+    size_t mVersion;
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+NAMESPACE_END(nanogui)
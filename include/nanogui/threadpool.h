@@ -0,0 +1,76 @@
+/*
+    nanogui/threadpool.h -- Pool of worker threads for data-parallel loops
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class ThreadPool threadpool.h nanogui/threadpool.h
+ *
+ * \brief Executes the iterations of loops on a fixed set of worker threads.
+ *
+ * Iterations are claimed one at a time by the calling thread and all idle
+ * workers, which balances loops whose iterations differ greatly in cost
+ * (e.g. the layouts of windows with few and many widgets). Loops may be
+ * nested: idle workers pick up the iterations of the most recently started
+ * loop first. This is used by \ref Screen::setParallelLayout().
+ */
+class NANOGUI_EXPORT ThreadPool {
+public:
+    /// Create a pool with the given number of worker threads (0: run everything on the caller)
+    ThreadPool(size_t threadCount);
+
+    /// Wait for the workers to finish and release them
+    ~ThreadPool();
+
+    /// Return the number of worker threads
+    size_t threadCount() const { return mThreads.size(); }
+
+    /**
+     * \brief Invoke \c func(i) for every \c i in <tt>[0, count)</tt>
+     *
+     * The calling thread participates and the function returns once all
+     * iterations have completed. If iterations throw, the first exception
+     * is rethrown after the remaining iterations have completed.
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)> &func);
+
+    /// Return the pool shared by NanoGUI (one worker per additional CPU core)
+    static ThreadPool *shared();
+
+protected:
+    struct Loop;
+
+    /// Run iterations of \c loop until none are left
+    void work(Loop &loop);
+
+    /// Main function of the worker threads
+    void workerMain();
+
+protected:
+    std::vector<std::thread> mThreads;
+    std::mutex mMutex;
+    std::condition_variable mWorkAvailable, mLoopFinished;
+    /* Loops with iterations that have not been claimed yet */
+    std::deque<std::shared_ptr<Loop>> mLoops;
+    bool mShutdown;
+};
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,103 @@
+/*
+    nanogui/thumbnailloader.h -- Decodes images into thumbnails on worker
+    threads
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class ThumbnailLoader thumbnailloader.h nanogui/thumbnailloader.h
+ *
+ * \brief Decodes a list of image files into RGBA8 thumbnails.
+ *
+ * The files are decoded and downscaled on a dedicated \ref ThreadPool,
+ * starting with the range of files passed to \ref prioritize() (e.g. the
+ * visible ones). It uses at most half of the CPU cores, so that decoding
+ * does not delay the loops of \ref ThreadPool::shared(). The resulting thumbnails are handed
+ * to the thread that draws the user interface by \ref fetch(), which limits
+ * the work per call (e.g. uploading them to the GPU) to a time budget. This
+ * is used by \ref ImagePanel::loadDirectory().
+ */
+class NANOGUI_EXPORT ThumbnailLoader {
+public:
+    /**
+     * \brief Start decoding the given files
+     *
+     * Images are downscaled (preserving their aspect ratio) until their
+     * smaller side does not exceed \c thumbnailSize pixels.
+     */
+    ThumbnailLoader(const std::vector<std::string> &filenames, int thumbnailSize);
+
+    /// Cancel decoding and wait for the worker threads
+    ~ThumbnailLoader();
+
+    /// Return the number of files
+    size_t size() const { return mFilenames.size(); }
+
+    /// Decode the files with indices in <tt>[begin, end)</tt> before all others
+    void prioritize(size_t begin, size_t end);
+
+    /**
+     * \brief Pass decoded thumbnails to \c callback until \c budget seconds have passed
+     *
+     * Invokes \c callback with the index of each file, the size of its
+     * thumbnail and its RGBA8 pixels, which are \c nullptr if the file could
+     * not be decoded. At least one thumbnail is processed if any are
+     * waiting. Returns the number of processed files.
+     */
+    size_t fetch(double budget,
+                 const std::function<void(size_t, const Vector2i &, const uint8_t *)> &callback);
+
+    /// Return whether decoded thumbnails are waiting for \ref fetch()
+    bool hasDecoded() const;
+
+    /// Return whether all files have been processed by \ref fetch()
+    bool finished() const { return mFetched == mFilenames.size(); }
+
+protected:
+    struct Thumbnail {
+        size_t index;
+        int width, height;
+        std::vector<uint8_t> data;
+    };
+
+    /// Claim the next file to decode, returns \c false if none are left
+    bool claim(size_t &index);
+
+    /// Decode and downscale a file
+    Thumbnail decode(size_t index) const;
+
+protected:
+    std::vector<std::string> mFilenames;
+    int mThumbnailSize;
+    size_t mFetched;
+
+    /* State shared with the worker threads */
+    mutable std::mutex mMutex;
+    std::vector<bool> mClaimed;
+    /* All files before mNext have been claimed */
+    size_t mNext;
+    size_t mPriorityBegin, mPriorityEnd;
+    std::deque<Thumbnail> mDecoded;
+    std::atomic<bool> mCancelled;
+    /* Runs the parallel loop over the files on the shared thread pool */
+    std::thread mThread;
+};
+
+NAMESPACE_END(nanogui)
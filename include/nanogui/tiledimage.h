@@ -0,0 +1,241 @@
+/*
+    nanogui/tiledimage.h -- Tiled image pyramids that are streamed to the
+    GPU on demand
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/object.h>
+#include <nanogui/opengl.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class TiledImageSource tiledimage.h nanogui/tiledimage.h
+ *
+ * \brief Image that is divided into a pyramid of square RGBA8 tiles.
+ *
+ * Level 0 holds the image at full resolution, and every further level
+ * halves its width and height (rounding up) until it fits into a single
+ * tile. The tiles of each level form a row-major grid; tiles on the right
+ * and bottom borders are only partially covered by the image.
+ *
+ * Tiles are obtained through \ref loadTile(), which is invoked on a
+ * background thread by \ref TileCache. This allows displaying images that
+ * exceed both the maximum texture size and the available memory with \ref
+ * ImageView::bindTiledImage().
+ */
+class NANOGUI_EXPORT TiledImageSource : public Object {
+public:
+    /**
+     * \brief Callback that fills a tile with <tt>tileSize * tileSize</tt>
+     * RGBA8 pixels (row by row, top to bottom)
+     *
+     * Receives the level and the position of the tile within the grid of
+     * its level, and returns \c false if the tile is not available.
+     */
+    typedef std::function<bool(int, const Vector2i &, uint8_t *)> Loader;
+
+    /// Create a source of the given size whose tiles are provided by a callback
+    TiledImageSource(const Vector2i &size, int tileSize, const Loader &loader = Loader());
+
+    /// Return the size of the image at full resolution
+    const Vector2i &size() const { return mSize; }
+
+    /// Return the width and height of the tiles in pixels
+    int tileSize() const { return mTileSize; }
+
+    /// Return the number of levels of the pyramid
+    int levelCount() const { return mLevelCount; }
+
+    /// Return the size of the image at the given level
+    Vector2i levelSize(int level) const;
+
+    /// Return the number of tiles along each axis at the given level
+    Vector2i tileCount(int level) const;
+
+    /// Return the number of bytes of a tile
+    size_t tileBytes() const { return (size_t) mTileSize * (size_t) mTileSize * 4; }
+
+    /**
+     * \brief Fill \c data with the pixels of a tile (see \ref Loader)
+     *
+     * Called from a background thread, hence implementations must be
+     * thread-safe. The default implementation invokes the loader callback.
+     */
+    virtual bool loadTile(int level, const Vector2i &tile, uint8_t *data);
+
+protected:
+    virtual ~TiledImageSource() = default;
+
+protected:
+    Vector2i mSize;
+    int mTileSize;
+    int mLevelCount;
+    Loader mLoader;
+};
+
+/**
+ * \class MappedImageSource tiledimage.h nanogui/tiledimage.h
+ *
+ * \brief Tiled image pyramid that is read from a memory-mapped file.
+ *
+ * The file contains the tiles of all levels (see \ref TiledImageSource)
+ * as raw RGBA8 pixels, starting with level 0 at the given byte offset.
+ * Within a level, the tiles are stored in row-major order, and each tile
+ * occupies <tt>tileSize * tileSize * 4</tt> bytes (including the parts of
+ * border tiles that lie outside of the image). Pages of the file are only
+ * read when the corresponding tiles are requested.
+ */
+class NANOGUI_EXPORT MappedImageSource : public TiledImageSource {
+public:
+    /// Map a file that holds a pyramid of the given image and tile size
+    MappedImageSource(const std::string &filename, const Vector2i &size,
+                      int tileSize, size_t offset = 0);
+
+    /// Copy a tile from the mapped file
+    virtual bool loadTile(int level, const Vector2i &tile, uint8_t *data) override;
+
+    /// Return the size of a file that holds a pyramid of the given image and tile size (excluding the offset)
+    static size_t fileSize(const Vector2i &size, int tileSize);
+
+protected:
+    virtual ~MappedImageSource();
+
+protected:
+    const uint8_t *mData;
+    size_t mMappedSize;
+    size_t mOffset;
+    /* Byte offset of the first tile of every level */
+    std::vector<size_t> mLevelOffsets;
+#if defined(_WIN32)
+    void *mFile, *mMapping;
+#endif
+};
+
+/**
+ * \class TileCache tiledimage.h nanogui/tiledimage.h
+ *
+ * \brief Streams the tiles of a \ref TiledImageSource into OpenGL textures.
+ *
+ * Requested tiles are loaded on a background thread, most recent requests
+ * first, and uploaded by \ref upload() within a time budget per frame. The
+ * least recently used textures are evicted to keep the GPU memory below a
+ * budget. Tiles that were used during the current frame are never evicted,
+ * hence the budget is exceeded if they don't fit into it.
+ * Except for the loader itself, all functions must be called on the thread
+ * that owns the OpenGL context.
+ */
+class NANOGUI_EXPORT TileCache {
+public:
+    /// Start loading tiles from \c source (the cache keeps a reference to it)
+    TileCache(TiledImageSource *source);
+
+    /// Stop the loader thread and release all textures
+    ~TileCache();
+
+    /// Return the image source
+    TiledImageSource *source() { return mSource.get(); }
+
+    /**
+     * \brief Start a new frame
+     *
+     * Discards requests that have not been loaded yet, since the tiles
+     * that are still needed will be requested again while drawing.
+     */
+    void beginFrame();
+
+    /// Return the texture of a tile if it is resident (and mark it as used), or 0
+    GLuint texture(int level, const Vector2i &tile);
+
+    /**
+     * \brief Ask the loader thread for a tile that is not resident yet
+     *
+     * Tiles that failed to load are only requested again after a few
+     * seconds.
+     */
+    void request(int level, const Vector2i &tile);
+
+    /**
+     * \brief Upload loaded tiles until \c budget seconds have passed
+     *
+     * At least one tile is uploaded if any are waiting. Returns the number
+     * of uploaded tiles.
+     */
+    size_t upload(double budget);
+
+    /// Return whether loaded tiles are waiting for \ref upload()
+    bool hasLoadedTiles() const;
+
+    /// Return whether any requested tiles are still being loaded or uploaded
+    bool busy() const;
+
+    /// Return the maximum number of bytes of GPU memory used by the tiles
+    size_t memoryBudget() const { return mMemoryBudget; }
+    /// Set the maximum number of bytes of GPU memory used by the tiles
+    void setMemoryBudget(size_t budget) { mMemoryBudget = budget; }
+
+    /// Return the number of bytes of GPU memory currently used by the tiles
+    size_t memoryUsage() const { return mResident.size() * textureBytes(); }
+
+protected:
+    struct Resident {
+        GLuint texture;
+        size_t lastUsed;
+        std::list<uint64_t>::iterator lruEntry;
+    };
+
+    struct Loaded {
+        uint64_t key;
+        std::vector<uint8_t> data;
+    };
+
+    static uint64_t key(int level, const Vector2i &tile) {
+        return ((uint64_t) level << 48) | ((uint64_t) tile.x() << 24) | (uint64_t) tile.y();
+    }
+
+    /// Bytes occupied by the texture of a tile, including its mipmaps
+    size_t textureBytes() const { return mSource->tileBytes() * 4 / 3; }
+
+    /// Main function of the loader thread
+    void loaderMain();
+
+protected:
+    ref<TiledImageSource> mSource;
+    size_t mMemoryBudget;
+    size_t mFrame;
+
+    /* Resident tiles, most recently used first, and their textures */
+    std::list<uint64_t> mLRU;
+    std::unordered_map<uint64_t, Resident> mResident;
+
+    /* State shared with the loader thread */
+    mutable std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::deque<uint64_t> mRequests;
+    /* Tiles that are requested, being loaded, or waiting for upload */
+    std::unordered_set<uint64_t> mPending;
+    std::deque<Loaded> mLoaded;
+    /* Tiles that the source could not provide, and when they failed */
+    std::unordered_map<uint64_t, double> mFailed;
+    bool mShutdown;
+    std::thread mThread;
+};
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,142 @@
+/*
+    nanogui/virtuallist.h -- Scrollable list that only creates widgets for
+    the rows that are currently visible
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/widget.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class VirtualList virtuallist.h nanogui/virtuallist.h
+ *
+ * \brief Scrollable list of uniformly sized rows for very large item counts.
+ *
+ * Unlike a \ref VScrollPanel around a long list of widgets, the list only
+ * knows the number of items and obtains their contents from a callback. It
+ * creates just enough row widgets to cover the visible area and rebinds
+ * them to other items while scrolling, so memory usage and frame time do
+ * not depend on the number of items.
+ *
+ * By default, rows are \ref Label instances whose caption is provided by
+ * \ref setTextCallback(). Arbitrary row widgets are supported through \ref
+ * setRowFactory() and \ref setRowBinder(). The row widgets are the only
+ * children of the list and should not be modified otherwise.
+ *
+ * Clicking a row selects it; when the list has the focus, the arrow, page
+ * up/down, home and end keys move the selection.
+ */
+class NANOGUI_EXPORT VirtualList : public Widget {
+public:
+    VirtualList(Widget *parent);
+
+    /// Return the number of items
+    int itemCount() const { return mItemCount; }
+    /// Set the number of items (rebinds all visible rows)
+    void setItemCount(int itemCount);
+
+    /// Return the height of each row in pixels
+    int rowHeight() const { return mRowHeight; }
+    /// Set the height of each row in pixels
+    void setRowHeight(int rowHeight);
+
+    /// Return the callback that provides the text of an item (used by the default rows)
+    std::function<std::string(int)> textCallback() const { return mTextCallback; }
+    /// Set the callback that provides the text of an item (used by the default rows)
+    void setTextCallback(const std::function<std::string(int)> &callback);
+
+    /// Return the callback that creates a new row widget
+    std::function<Widget *(VirtualList *)> rowFactory() const { return mRowFactory; }
+    /**
+     * \brief Set the callback that creates a new row widget
+     *
+     * The callback receives the list and must return a new widget that has
+     * the list as its parent. The list takes care of its position and size.
+     */
+    void setRowFactory(const std::function<Widget *(VirtualList *)> &factory);
+
+    /// Return the callback that fills a row widget with the contents of an item
+    std::function<void(Widget *, int)> rowBinder() const { return mRowBinder; }
+    /// Set the callback that fills a row widget with the contents of an item
+    void setRowBinder(const std::function<void(Widget *, int)> &binder);
+
+    /// Return the index of the selected item, or -1 if none is selected
+    int selectedIndex() const { return mSelectedIndex; }
+    /// Select an item (-1 clears the selection), without invoking the callback
+    void setSelectedIndex(int index);
+
+    /// Return the callback that is invoked when the user selects an item
+    std::function<void(int)> callback() const { return mCallback; }
+    /// Set the callback that is invoked when the user selects an item
+    void setCallback(const std::function<void(int)> &callback) { mCallback = callback; }
+
+    /// Return the current scroll amount as a value between 0 and 1. 0 means scrolled to the top and 1 to the bottom.
+    float scroll() const;
+    /// Set the scroll amount to a value between 0 and 1. 0 means scrolled to the top and 1 to the bottom.
+    void setScroll(float scroll);
+
+    /// Scroll by the smallest amount that makes an item completely visible
+    void scrollToItem(int index);
+
+    /// Return the index of the item at a vertical position relative to the list, or -1
+    int itemAt(int y) const;
+
+    /// Bind all rows again, e.g. after the contents of the items changed
+    void refresh();
+
+    /// Return the number of row widgets that currently exist
+    int rowCount() const { return (int) mRows.size(); }
+
+    virtual Vector2i preferredSize(NVGcontext *ctx) const override;
+    virtual void performLayout(NVGcontext *ctx) override;
+    virtual bool mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) override;
+    virtual bool mouseDragEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) override;
+    virtual bool scrollEvent(const Vector2i &p, const Vector2f &rel) override;
+    virtual bool keyboardEvent(int key, int scancode, int action, int modifiers) override;
+    virtual void draw(NVGcontext *ctx) override;
+    virtual void save(Serializer &s) const override;
+    virtual bool load(Serializer &s) override;
+
+protected:
+    /// Create, position and bind just enough rows to cover the visible area
+    void updateRows(NVGcontext *ctx);
+
+    /// Scroll to an absolute offset in pixels (clamped to the valid range)
+    void setOffset(double offset);
+
+    /// Move the selection in response to user input and invoke the callback
+    void selectItem(int index);
+
+    /// Return the height of all items in pixels
+    double contentHeight() const { return (double) mItemCount * mRowHeight; }
+
+protected:
+    int mItemCount;
+    int mRowHeight;
+    int mSelectedIndex;
+    /// Distance between the top of the first item and the top of the list in pixels
+    double mOffset;
+    bool mDragScrollbar;
+    /// Row widgets, item \c i is shown by row <tt>i % mRows.size()</tt>
+    std::vector<Widget *> mRows;
+    /// Item currently bound to each row (-1 if none)
+    std::vector<int> mRowItems;
+    std::function<std::string(int)> mTextCallback;
+    std::function<Widget *(VirtualList *)> mRowFactory;
+    std::function<void(Widget *, int)> mRowBinder;
+    std::function<void(int)> mCallback;
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+NAMESPACE_END(nanogui)
@@ -30,7 +30,7 @@ public:
     /// Return the current scroll amount as a value between 0 and 1. 0 means scrolled to the top and 1 to the bottom.
     float scroll() const { return mScroll; }
     /// Set the scroll amount to a value between 0 and 1. 0 means scrolled to the top and 1 to the bottom.
-    void setScroll(float scroll) { mScroll = scroll; }
+    void setScroll(float scroll) { mScroll = scroll; markDirty(); }
 
     virtual void performLayout(NVGcontext *ctx) override;
     virtual Vector2i preferredSize(NVGcontext *ctx) const override;
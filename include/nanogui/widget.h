@@ -30,6 +30,7 @@ enum class Cursor;// do not put a docstring, this is already documented
  * widgets using a layout generator (see \ref Layout).
  */
 class NANOGUI_EXPORT Widget : public Object {
+    friend class Screen;
 public:
     /// Construct a new widget with the given parent widget
     Widget(Widget *parent);
@@ -46,7 +47,7 @@ public:
     /// Return the used \ref Layout generator
     const Layout *layout() const { return mLayout.get(); }
     /// Set the used \ref Layout generator
-    void setLayout(Layout *layout) { mLayout = layout; }
+    void setLayout(Layout *layout);
 
     /// Return the \ref Theme used to draw this widget
     Theme *theme() { return mTheme; }
@@ -58,7 +59,14 @@ public:
     /// Return the position relative to the parent widget
     const Vector2i &position() const { return mPos; }
     /// Set the position relative to the parent widget
-    void setPosition(const Vector2i &pos) { mPos = pos; }
+    void setPosition(const Vector2i &pos) {
+        if (pos == mPos)
+            return;
+        markMoved(); /* Damage the previously covered region as well */
+        mPos = pos;
+        markMoved();
+        invalidateParentIndex();
+    }
 
     /// Return the absolute position on screen
     Vector2i absolutePosition() const {
@@ -69,17 +77,25 @@ public:
     /// Return the size of the widget
     const Vector2i &size() const { return mSize; }
     /// set the size of the widget
-    void setSize(const Vector2i &size) { mSize = size; }
+    void setSize(const Vector2i &size) {
+        if (size == mSize)
+            return;
+        markDirty();
+        mSize = size;
+        mLayoutValid = false; /* The children must be arranged again */
+        markDirty();
+        invalidateParentIndex();
+    }
 
     /// Return the width of the widget
     int width() const { return mSize.x(); }
     /// Set the width of the widget
-    void setWidth(int width) { mSize.x() = width; }
+    void setWidth(int width) { setSize(Vector2i(width, mSize.y())); }
 
     /// Return the height of the widget
     int height() const { return mSize.y(); }
     /// Set the height of the widget
-    void setHeight(int height) { mSize.y() = height; }
+    void setHeight(int height) { setSize(Vector2i(mSize.x(), height)); }
 
     /**
      * \brief Set the fixed size of this widget
@@ -90,7 +106,7 @@ public:
      * size; this is done with a call to \ref setSize or a call to \ref performLayout()
      * in the parent widget.
      */
-    void setFixedSize(const Vector2i &fixedSize) { mFixedSize = fixedSize; }
+    void setFixedSize(const Vector2i &fixedSize) { mFixedSize = fixedSize; invalidateLayout(); }
 
     /// Return the fixed size (see \ref setFixedSize())
     const Vector2i &fixedSize() const { return mFixedSize; }
@@ -100,14 +116,14 @@ public:
     // Return the fixed height (see \ref setFixedSize())
     int fixedHeight() const { return mFixedSize.y(); }
     /// Set the fixed width (see \ref setFixedSize())
-    void setFixedWidth(int width) { mFixedSize.x() = width; }
+    void setFixedWidth(int width) { mFixedSize.x() = width; invalidateLayout(); }
     /// Set the fixed height (see \ref setFixedSize())
-    void setFixedHeight(int height) { mFixedSize.y() = height; }
+    void setFixedHeight(int height) { mFixedSize.y() = height; invalidateLayout(); }
 
     /// Return whether or not the widget is currently visible (assuming all parents are visible)
     bool visible() const { return mVisible; }
     /// Set whether or not the widget is currently visible (assuming all parents are visible)
-    void setVisible(bool visible) { mVisible = visible; }
+    void setVisible(bool visible) { mVisible = visible; invalidateLayout(); markDirty(); }
 
     /// Check if this widget is currently visible, taking parent widgets into account
     bool visibleRecursive() const {
@@ -174,22 +190,22 @@ public:
     /// Return whether or not this widget is currently enabled
     bool enabled() const { return mEnabled; }
     /// Set whether or not this widget is currently enabled
-    void setEnabled(bool enabled) { mEnabled = enabled; }
+    void setEnabled(bool enabled) { mEnabled = enabled; markDirty(); }
 
     /// Return whether or not this widget is currently focused
     bool focused() const { return mFocused; }
     /// Set whether or not this widget is currently focused
-    void setFocused(bool focused) { mFocused = focused; }
+    void setFocused(bool focused) { mFocused = focused; markDirty(); }
     /// Request the focus to be moved to this widget
     void requestFocus();
 
     const std::string &tooltip() const { return mTooltip; }
-    void setTooltip(const std::string &tooltip) { mTooltip = tooltip; }
+    void setTooltip(const std::string &tooltip) { mTooltip = tooltip; markDirty(); }
 
     /// Return current font size. If not set the default of the current theme will be returned
     int fontSize() const;
     /// Set the font size of this widget
-    void setFontSize(int fontSize) { mFontSize = fontSize; }
+    void setFontSize(int fontSize) { mFontSize = fontSize; invalidateLayout(); markDirty(); }
     /// Return whether the font size is explicitly specified for this widget
     bool hasFontSize() const { return mFontSize > 0; }
 
@@ -203,13 +219,28 @@ public:
      * Sets the amount of extra scaling applied to *icon* fonts.
      * See \ref nanogui::Widget::mIconExtraScale.
      */
-    void setIconExtraScale(float scale) { mIconExtraScale = scale; }
+    void setIconExtraScale(float scale) { mIconExtraScale = scale; invalidateLayout(); markDirty(); }
 
     /// Return a pointer to the cursor of the widget
     Cursor cursor() const { return mCursor; }
     /// Set the cursor of the widget
     void setCursor(Cursor cursor) { mCursor = cursor; }
 
+    /// Return how the drawing output of this widget and its children is cached
+    CacheMode cacheMode() const { return mCacheMode; }
+
+    /**
+     * \brief Set how the drawing output of this widget and its children is cached
+     *
+     * With \ref CacheMode::Retained, the tessellated NanoVG output of the
+     * whole subtree is recorded once (see \ref DrawCache) and replayed in
+     * subsequent frames until \ref markDirty() is called on any widget of the
+     * subtree, or until the subtree is moved or clipped differently. This is
+     * meant for large static panels; subtrees that issue OpenGL calls of their
+     * own (e.g. \ref GLCanvas) are always drawn from scratch.
+     */
+    void setCacheMode(CacheMode mode);
+
     /// Check if the widget contains a certain position
     bool contains(const Vector2i &p) const {
         auto d = (p-mPos).array();
@@ -219,6 +250,21 @@ public:
     /// Determine the widget located at the given position value (recursive)
     Widget *findWidget(const Vector2i &p);
 
+    /// Return whether hit tests against the children use a \ref SpatialIndex
+    bool spatialIndex() const { return mSpatialIndex != nullptr; }
+
+    /**
+     * \brief Accelerate hit tests against the children of this widget
+     *
+     * When enabled, \ref findWidget() and the default mouse event handlers
+     * look up the children under the cursor in a \ref SpatialIndex instead
+     * of testing every child. The index is rebuilt lazily on the next hit
+     * test after children were added, removed, moved or resized (e.g. by
+     * \ref performLayout()). This pays off for containers with hundreds of
+     * children or more.
+     */
+    void setSpatialIndex(bool enabled);
+
     /// Handle a mouse button event (default implementation: propagate to children)
     virtual bool mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers);
 
@@ -246,12 +292,110 @@ public:
     /// Compute the preferred size of the widget
     virtual Vector2i preferredSize(NVGcontext *ctx) const;
 
+    /**
+     * \brief Return the preferred size, computing it only if necessary
+     *
+     * The result of \ref preferredSize() is memoized until the layout of
+     * this widget or one of its descendants is invalidated (see \ref
+     * invalidateLayout()). Layouts use this function to query the sizes of
+     * child widgets, so that each widget is measured once per change rather
+     * than once per ancestor.
+     */
+    Vector2i cachedPreferredSize(NVGcontext *ctx) const;
+
     /// Invoke the associated layout generator to properly place child widgets, if any
     virtual void performLayout(NVGcontext *ctx);
 
+    /**
+     * \brief Invoke \ref performLayout() unless nothing changed since the last time
+     *
+     * Layouts use this function for child widgets, hence an explicit call to
+     * \ref performLayout() only revisits the subtrees that were invalidated.
+     */
+    void performLayoutIfNeeded(NVGcontext *ctx);
+
+    /**
+     * \brief Compute the preferred sizes of several widgets ahead of time
+     *
+     * During a parallel layout (see \ref Screen::setParallelLayout()), the
+     * widgets are measured concurrently and the results are memoized for
+     * \ref cachedPreferredSize(). Does nothing otherwise. The widgets must
+     * not be ancestors of each other.
+     */
+    static void cachePreferredSizes(NVGcontext *ctx, const std::vector<Widget *> &widgets);
+
+    /**
+     * \brief Invoke \ref performLayoutIfNeeded() on several widgets
+     *
+     * During a parallel layout (see \ref Screen::setParallelLayout()), the
+     * widgets are laid out concurrently. The widgets must not be ancestors
+     * of each other.
+     */
+    static void performLayouts(NVGcontext *ctx, const std::vector<Widget *> &widgets);
+
+    /// Return whether a parallel layout is in progress (see \ref Screen::setParallelLayout())
+    static bool parallelLayoutActive() { return sParallelLayout; }
+
+protected:
+    /**
+     * \brief Invoke \c func on several widgets concurrently during a parallel layout
+     *
+     * The layouts of the parents are invalidated and the parents are marked
+     * dirty first, and changes made by each task are not propagated beyond
+     * its widget (see \ref invalidateLayout() and \ref markDirty()), so
+     * that the tasks never write to shared ancestors.
+     */
+    static void parallelLayoutFor(const std::vector<Widget *> &widgets,
+                                  const std::function<void(Widget *)> &func);
+
+public:
+
+    /**
+     * \brief Discard the cached layout information of this widget and its ancestors
+     *
+     * The setters that affect the preferred size of a widget (e.g. its
+     * caption, font, font size, theme, fixed size, visibility or children)
+     * do this automatically, and so do the setters of \ref Layout (for all
+     * widgets using the layout). Call it after changing something that
+     * affects the preferred size or layout of the widget by other means.
+     * Unlike \ref markDirty(), purely visual changes don't require it.
+     */
+    void invalidateLayout();
+
     /// Draw the widget (and all child widgets)
     virtual void draw(NVGcontext *ctx);
 
+    /**
+     * \brief Flag this widget as requiring a redraw
+     *
+     * The flag propagates to all parent widgets up to the \ref Screen, which
+     * skips rendering entirely (see \ref Screen::drawAll()) as long as no
+     * widget in its hierarchy is dirty. The widget's current bounds are also
+     * reported to the screen as a damaged region, which is used for partial
+     * redraws (see \ref Screen::setPartialRedraw()). The cached layout
+     * information is left untouched, so that e.g. hovering over a widget
+     * does not cause its ancestors to be measured again; changes that affect
+     * the size of the widget must call \ref invalidateLayout() as well. The
+     * setters of \ref Widget and its subclasses call this function
+     * automatically; custom widgets should call it whenever their visual
+     * state changes.
+     */
+    void markDirty();
+
+    /**
+     * \brief Mark this widget as dirty at a later point in time
+     *
+     * \c time is specified in seconds on the \c glfwGetTime() clock. This
+     * is meant for widgets whose appearance changes after a delay (e.g. a
+     * notification that expires), and allows \ref mainloop() to sleep until
+     * then. Has no effect if the widget is not attached to a \ref Screen.
+     * For continuous animations, see \ref Screen::requestAnimationFrame().
+     */
+    void scheduleRedrawAt(double time);
+
+    /// Return whether this widget (or one of its children) must be redrawn
+    bool dirty() const { return mDirty; }
+
     /// Save the state of the widget into the given \ref Serializer instance
     virtual void save(Serializer &s) const;
 
@@ -274,6 +418,31 @@ protected:
      */
     inline float icon_scale() const { return mTheme->mIconScale * mIconExtraScale; }
 
+    /// Reset the dirty flag of this widget and all dirty children
+    virtual void clearDirty();
+
+    /**
+     * \brief Flag the ancestors of this widget as requiring a redraw and
+     * damage its current bounds, but keep the widget itself clean
+     *
+     * Used when the widget is merely translated, so that its own cached
+     * contents (e.g. the layer of a \ref Window) remain valid.
+     */
+    void markMoved();
+
+    /// Draw the widget by replaying (or recording) its \ref DrawCache
+    void drawCached(NVGcontext *ctx);
+
+    /// Tell the parent that the bounds of this widget changed (see \ref setSpatialIndex())
+    void invalidateParentIndex() {
+        /* Only write on change, see Screen::setParallelLayout() */
+        if (mParent && mParent->mSpatialIndexValid)
+            mParent->mSpatialIndexValid = false;
+    }
+
+    /// Return the up-to-date spatial index over the children, if enabled
+    const SpatialIndex *updateSpatialIndex();
+
 protected:
     Widget *mParent;
     ref<Theme> mTheme;
@@ -335,6 +504,36 @@ protected:
      */
     float mIconExtraScale;
     Cursor mCursor;
+
+    /// Whether this widget or one of its children must be redrawn (see \ref markDirty())
+    bool mDirty;
+
+    /// Set by the \ref Screen while drawing to skip subtrees outside of the redrawn region
+    bool mCulled;
+
+    /// Caching strategy for the drawing output (see \ref setCacheMode())
+    CacheMode mCacheMode;
+
+    /// Recorded drawing output of this widget and its children
+    DrawCache *mDrawCache;
+
+    /// Acceleration structure for hit tests (see \ref setSpatialIndex())
+    SpatialIndex *mSpatialIndex;
+
+    /// Whether \ref mSpatialIndex reflects the current children and their bounds
+    bool mSpatialIndexValid;
+
+    /// Memoized result of \ref preferredSize() (see \ref cachedPreferredSize())
+    mutable Vector2i mPreferredSize;
+
+    /// Whether \ref mPreferredSize is up to date
+    mutable bool mPreferredSizeValid;
+
+    /// Whether the children are placed according to the current state (see \ref performLayoutIfNeeded())
+    bool mLayoutValid;
+
+    /// Whether a parallel layout is in progress (see \ref Screen::setParallelLayout())
+    static bool sParallelLayout;
 public:
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
@@ -14,6 +14,8 @@
 
 #include <nanogui/widget.h>
 
+struct NVGLUframebuffer;
+
 NAMESPACE_BEGIN(nanogui)
 
 /**
@@ -29,7 +31,7 @@ public:
     /// Return the window title
     const std::string &title() const { return mTitle; }
     /// Set the window title
-    void setTitle(const std::string &title) { mTitle = title; }
+    void setTitle(const std::string &title) { mTitle = title; invalidateLayout(); markDirty(); }
 
     /// Is this a model dialog?
     bool modal() const { return mModal; }
@@ -45,6 +47,25 @@ public:
     /// Center the window in the current \ref Screen
     void center();
 
+    /// Return whether the window is cached in an offscreen layer
+    bool layerCaching() const { return mLayerCaching; }
+
+    /**
+     * \brief Enable caching the window in an offscreen layer
+     *
+     * When enabled, the window and its children are rendered into a texture
+     * at the resolution given by \ref Screen::pixelRatio(), which is then
+     * composited as a single textured quad. The layer is only rendered again
+     * once a widget of the window has been marked as dirty (see \ref
+     * Widget::markDirty()), hence dragging the window around does not redraw
+     * any of its children. Windows containing widgets that issue OpenGL calls
+     * of their own (e.g. \ref GLCanvas) should not enable this.
+     */
+    void setLayerCaching(bool layerCaching);
+
+    /// Render the cached layer if it is out of date (called by \ref Screen before each frame)
+    void updateLayer(NVGcontext *ctx, float pixelRatio);
+
     /// Draw the window
     virtual void draw(NVGcontext *ctx) override;
     /// Handle window drag events
@@ -60,13 +81,21 @@ public:
     virtual void save(Serializer &s) const override;
     virtual bool load(Serializer &s) override;
 protected:
+    /// Release the cached layer
+    virtual ~Window();
     /// Internal helper function to maintain nested window position values; overridden in \ref Popup
     virtual void refreshRelativePlacement();
+    /// Invalidate the cached layer when anything in the window changed
+    virtual void clearDirty() override;
 protected:
     std::string mTitle;
     Widget *mButtonPanel;
     bool mModal;
     bool mDrag;
+    bool mLayerCaching, mLayerValid, mDrawingLayer;
+    NVGLUframebuffer *mLayer;
+    Vector2i mLayerSize;
+    float mLayerPixelRatio;
 public:
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
@@ -6,6 +6,7 @@ DECLARE_WIDGET(Label);
 DECLARE_WIDGET(Popup);
 DECLARE_WIDGET(MessageDialog);
 DECLARE_WIDGET(VScrollPanel);
+DECLARE_WIDGET(VirtualList);
 DECLARE_WIDGET(ComboBox);
 DECLARE_WIDGET(ProgressBar);
 DECLARE_WIDGET(Slider);
@@ -62,6 +63,29 @@ void register_basics(py::module &m) {
         .def("scroll", &VScrollPanel::scroll, D(VScrollPanel, scroll))
         .def("setScroll", &VScrollPanel::setScroll, D(VScrollPanel, setScroll));
 
+    py::class_<VirtualList, Widget, ref<VirtualList>, PyVirtualList>(m, "VirtualList", D(VirtualList))
+        .def(py::init<Widget *>(), py::arg("parent"), D(VirtualList, VirtualList))
+        .def("itemCount", &VirtualList::itemCount, D(VirtualList, itemCount))
+        .def("setItemCount", &VirtualList::setItemCount, D(VirtualList, setItemCount))
+        .def("rowHeight", &VirtualList::rowHeight, D(VirtualList, rowHeight))
+        .def("setRowHeight", &VirtualList::setRowHeight, D(VirtualList, setRowHeight))
+        .def("textCallback", &VirtualList::textCallback, D(VirtualList, textCallback))
+        .def("setTextCallback", &VirtualList::setTextCallback, D(VirtualList, setTextCallback))
+        .def("rowFactory", &VirtualList::rowFactory, D(VirtualList, rowFactory))
+        .def("setRowFactory", &VirtualList::setRowFactory, D(VirtualList, setRowFactory))
+        .def("rowBinder", &VirtualList::rowBinder, D(VirtualList, rowBinder))
+        .def("setRowBinder", &VirtualList::setRowBinder, D(VirtualList, setRowBinder))
+        .def("selectedIndex", &VirtualList::selectedIndex, D(VirtualList, selectedIndex))
+        .def("setSelectedIndex", &VirtualList::setSelectedIndex, D(VirtualList, setSelectedIndex))
+        .def("callback", &VirtualList::callback, D(VirtualList, callback))
+        .def("setCallback", &VirtualList::setCallback, D(VirtualList, setCallback))
+        .def("scroll", &VirtualList::scroll, D(VirtualList, scroll))
+        .def("setScroll", &VirtualList::setScroll, D(VirtualList, setScroll))
+        .def("scrollToItem", &VirtualList::scrollToItem, D(VirtualList, scrollToItem))
+        .def("itemAt", &VirtualList::itemAt, D(VirtualList, itemAt))
+        .def("refresh", &VirtualList::refresh, D(VirtualList, refresh))
+        .def("rowCount", &VirtualList::rowCount, D(VirtualList, rowCount));
+
     py::class_<ComboBox, Widget, ref<ComboBox>, PyComboBox>(m, "ComboBox", D(ComboBox))
         .def(py::init<Widget *>(), py::arg("parent"), D(ComboBox, ComboBox))
         .def(py::init<Widget *, const std::vector<std::string> &>(),
@@ -12,6 +12,16 @@ public:
     }
 };
 
+class PyPlot : public Plot {
+public:
+    using Plot::Plot;
+    NANOGUI_WIDGET_OVERLOADS(Plot);
+
+    void drawGL() {
+        PYBIND11_OVERLOAD(void, Plot, drawGL);
+    }
+};
+
 void register_glcanvas(py::module &m) {
     py::class_<GLCanvas, Widget, ref<GLCanvas>, PyGLCanvas> glcanvas(m, "GLCanvas", D(GLCanvas));
     glcanvas
@@ -21,6 +31,37 @@ void register_glcanvas(py::module &m) {
         .def("drawBorder", &GLCanvas::drawBorder, D(GLCanvas, drawBorder))
         .def("setDrawBorder", &GLCanvas::setDrawBorder, D(GLCanvas, setDrawBorder))
         .def("drawGL", &GLCanvas::drawGL, D(GLCanvas, drawGL));
+
+    py::class_<Plot, GLCanvas, ref<Plot>, PyPlot>(m, "Plot", D(Plot))
+        .def(py::init<Widget *>(), py::arg("parent"), D(Plot, Plot))
+        .def("addSeries", &Plot::addSeries, py::arg("name"), py::arg("capacity"),
+             py::arg("color"), D(Plot, addSeries))
+        .def("removeSeries", &Plot::removeSeries, D(Plot, removeSeries))
+        .def("seriesCount", &Plot::seriesCount, D(Plot, seriesCount))
+        .def("seriesName", &Plot::seriesName, D(Plot, seriesName))
+        .def("seriesColor", &Plot::seriesColor, D(Plot, seriesColor))
+        .def("setSeriesColor", &Plot::setSeriesColor, D(Plot, setSeriesColor))
+        .def("seriesVisible", &Plot::seriesVisible, D(Plot, seriesVisible))
+        .def("setSeriesVisible", &Plot::setSeriesVisible, D(Plot, setSeriesVisible))
+        .def("seriesCapacity", &Plot::seriesCapacity, D(Plot, seriesCapacity))
+        .def("seriesSize", &Plot::seriesSize, D(Plot, seriesSize))
+        .def("setSeriesSampling", &Plot::setSeriesSampling, py::arg("index"),
+             py::arg("start"), py::arg("step"), D(Plot, setSeriesSampling))
+        .def("setSeriesData", [](Plot &p, int index, size_t offset, const VectorXf &values) {
+            p.setSeriesData(index, offset, values.data(), (size_t) values.size());
+        }, py::arg("index"), py::arg("offset"), py::arg("values"), D(Plot, setSeriesData))
+        .def("appendSeries", [](Plot &p, int index, const VectorXf &values) {
+            p.appendSeries(index, values.data(), (size_t) values.size());
+        }, py::arg("index"), py::arg("values"), D(Plot, appendSeries))
+        .def("xRange", &Plot::xRange, D(Plot, xRange))
+        .def("setXRange", &Plot::setXRange, D(Plot, setXRange))
+        .def("yRange", &Plot::yRange, D(Plot, yRange))
+        .def("setYRange", &Plot::setYRange, D(Plot, setYRange))
+        .def("autoScroll", &Plot::autoScroll, D(Plot, autoScroll))
+        .def("setAutoScroll", &Plot::setAutoScroll, D(Plot, setAutoScroll))
+        .def("fitView", &Plot::fitView, D(Plot, fitView))
+        .def("axisColor", &Plot::axisColor, D(Plot, axisColor))
+        .def("setAxisColor", &Plot::setAxisColor, D(Plot, setAxisColor));
 }
 
 #endif
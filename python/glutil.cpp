@@ -3,92 +3,123 @@
 #include "python.h"
 #include <pybind11/numpy.h>
 
-static void uploadAttribPy(GLShader &sh, const std::string &name, py::array M, int version) {
+/* Convert a 2D array into column-major order and determine its OpenGL type */
+static py::array attribArrayPy(py::array M, const std::string &func, GLuint &glType, bool &integral) {
     if (M.ndim() != 2)
-        throw py::type_error("uploadAttrib(): expects 2D array");
+        throw py::type_error(func + "(): expects 2D array");
 
     M = py::array::ensure(M, py::array::f_style);
 
     py::dtype dtype = M.dtype();
-    GLuint glType;
-    bool integral = true;
+    integral = true;
 
     if (dtype.kind() == 'i') {
         switch (dtype.itemsize()) {
             case 1: glType = GL_BYTE; break;
             case 2: glType = GL_SHORT; break;
             case 4: glType = GL_INT; break;
-            default: throw py::type_error("uploadAttrib(): Invalid integer type!");
+            default: throw py::type_error(func + "(): Invalid integer type!");
         }
     } else if (dtype.kind() == 'u') {
         switch (dtype.itemsize()) {
             case 1: glType = GL_UNSIGNED_BYTE; break;
             case 2: glType = GL_UNSIGNED_SHORT; break;
             case 4: glType = GL_UNSIGNED_INT; break;
-            default: throw py::type_error("uploadAttrib(): Invalid unsigned integer type!");
+            default: throw py::type_error(func + "(): Invalid unsigned integer type!");
         }
     } else if (dtype.kind() == 'f') {
         switch (dtype.itemsize()) {
             case 2: glType = GL_HALF_FLOAT; break;
             case 4: glType = GL_FLOAT; break;
             case 8: glType = GL_DOUBLE; break;
-            default: throw py::type_error("uploadAttrib(): Invalid floating point type!");
+            default: throw py::type_error(func + "(): Invalid floating point type!");
         }
         integral = false;
     } else {
-        throw py::type_error("uploadAttrib(): Invalid type!");
+        throw py::type_error(func + "(): Invalid type!");
     }
+    return M;
+}
 
+static void uploadAttribPy(GLShader &sh, const std::string &name, py::array M, int version) {
+    GLuint glType;
+    bool integral;
+    M = attribArrayPy(M, "uploadAttrib", glType, integral);
     sh.uploadAttrib(name, M.shape(0) * M.shape(1), (int) M.shape(0),
                     (uint32_t)M.itemsize(), glType, integral, M.data(), version);
 }
 
-static void setUniformPy(GLShader &sh, const std::string &name, py::object arg, bool warn = true) {
-    GLuint id = sh.uniform(name, warn);
+static void updateAttribPy(GLShader &sh, const std::string &name, py::array M, size_t offset) {
+    GLuint glType;
+    bool integral;
+    M = attribArrayPy(M, "updateAttrib", glType, integral);
+    sh.updateAttrib(name, offset * M.shape(0), M.shape(0) * M.shape(1), (int) M.shape(0),
+                    (uint32_t)M.itemsize(), glType, M.data());
+}
+
+static void streamAttribPy(GLShader &sh, const std::string &name, py::array M) {
+    GLuint glType;
+    bool integral;
+    M = attribArrayPy(M, "streamAttrib", glType, integral);
+    sh.streamAttrib(name, M.shape(0) * M.shape(1), (int) M.shape(0),
+                    (uint32_t)M.itemsize(), glType, integral, M.data());
+}
+
+/* Return the length of a vector (1-4) or the size of a square matrix (3 or
+   4, negated), or 0 if the array has an unsupported shape */
+static int uniformShapePy(const py::array &value) {
+    if (value.ndim() == 0)
+        return 1;
+    else if (value.ndim() == 1 && value.shape(0) >= 1 && value.shape(0) <= 4)
+        return (int) value.shape(0);
+    else if (value.ndim() == 2 && value.shape(0) == value.shape(1) &&
+             (value.shape(0) == 3 || value.shape(0) == 4))
+        return -(int) value.shape(0);
+    return 0;
+}
+
+static void setUniformPy(GLShader &sh, GLShader::UniformHandle handle, py::object arg) {
+    GLint id = sh.uniformLocation(handle);
     py::array value_ = py::array::ensure(arg);
     auto dtype = value_.dtype();
+    int shape = uniformShapePy(value_);
+    if (shape == 0 || (shape < 0 && dtype.kind() != 'f'))
+        throw py::type_error("setUniform(): invalid dimension/size!");
+
+    /* Matrices are converted into column-major order, which makes the
+       cached values comparable to those set from C++ */
     if (dtype.kind() == 'f') {
-        auto value = py::array_t<float, py::array::forcecast | py::array::c_style>(value_);
-        if (value.ndim() == 0 || (value.ndim() == 1 && value.shape(0) == 1))
-            glUniform1fv(id, 1, value.data());
-        else if (value.ndim() == 1 && value.shape(0) == 2)
-            glUniform2fv(id, 1, value.data());
-        else if (value.ndim() == 1 && value.shape(0) == 3)
-            glUniform3fv(id, 1, value.data());
-        else if (value.ndim() == 1 && value.shape(0) == 4)
-            glUniform4fv(id, 1, value.data());
-        else if (value.ndim() == 2 && value.shape(0) == 3 && value.shape(1) == 3)
-            glUniformMatrix3fv(id, 1, GL_TRUE, value.data());
-        else if (value.ndim() == 2 && value.shape(0) == 4 && value.shape(1) == 4)
-            glUniformMatrix4fv(id, 1, GL_TRUE, value.data());
-        else
-            throw py::type_error("setUniform(): invalid dimension/size!");
+        auto value = py::array_t<float, py::array::forcecast | py::array::f_style>(value_);
+        if (!sh.cacheUniform(handle, value.data(), (uint32_t) value.nbytes()))
+            return;
+        switch (shape) {
+            case 1: glUniform1fv(id, 1, value.data()); break;
+            case 2: glUniform2fv(id, 1, value.data()); break;
+            case 3: glUniform3fv(id, 1, value.data()); break;
+            case 4: glUniform4fv(id, 1, value.data()); break;
+            case -3: glUniformMatrix3fv(id, 1, GL_FALSE, value.data()); break;
+            case -4: glUniformMatrix4fv(id, 1, GL_FALSE, value.data()); break;
+        }
     } else if (dtype.kind() == 'i') {
         auto value = py::array_t<int, py::array::forcecast>(value_);
-
-        if (value.ndim() == 0 || (value.ndim() == 1 && value.shape(0) == 1))
-            glUniform1iv(id, 1, value.data());
-        else if (value.ndim() == 1 && value.shape(0) == 2)
-            glUniform2iv(id, 1, value.data());
-        else if (value.ndim() == 1 && value.shape(0) == 3)
-            glUniform3iv(id, 1, value.data());
-        else if (value.ndim() == 1 && value.shape(0) == 4)
-            glUniform4iv(id, 1, value.data());
-        else
-            throw py::type_error("setUniform(): invalid dimension/size!");
+        if (!sh.cacheUniform(handle, value.data(), (uint32_t) value.nbytes()))
+            return;
+        switch (shape) {
+            case 1: glUniform1iv(id, 1, value.data()); break;
+            case 2: glUniform2iv(id, 1, value.data()); break;
+            case 3: glUniform3iv(id, 1, value.data()); break;
+            case 4: glUniform4iv(id, 1, value.data()); break;
+        }
     } else if (dtype.kind() == 'u') {
         auto value = py::array_t<unsigned int, py::array::forcecast>(value_);
-
-        if (value.ndim() == 0 || (value.ndim() == 1 && value.shape(0) == 1))
-            glUniform1uiv(id, 1, value.data());
-        else if (value.ndim() == 1 && value.shape(0) == 2)
-            glUniform2uiv(id, 1, value.data());
-        else if (value.ndim() == 1 && value.shape(0) == 3)
-            glUniform3uiv(id, 1, value.data());
-        else if (value.ndim() == 1 && value.shape(0) == 4)
-            glUniform4uiv(id, 1, value.data());
-        else
-            throw py::type_error("setUniform(): invalid dimension/size!");
+        if (!sh.cacheUniform(handle, value.data(), (uint32_t) value.nbytes()))
+            return;
+        switch (shape) {
+            case 1: glUniform1uiv(id, 1, value.data()); break;
+            case 2: glUniform2uiv(id, 1, value.data()); break;
+            case 3: glUniform3uiv(id, 1, value.data()); break;
+            case 4: glUniform4uiv(id, 1, value.data()); break;
+        }
     }
 }
 
@@ -98,10 +129,21 @@ void register_glutil(py::module &m) {
         .def("init", &GLShader::init, py::arg("name"),
              py::arg("vertex_str"), py::arg("fragment_str"),
              py::arg("geometry_str") = "", D(GLShader, init))
+        .def("initAsync", &GLShader::initAsync, py::arg("name"),
+             py::arg("vertex_str"), py::arg("fragment_str"),
+             py::arg("geometry_str") = "", D(GLShader, initAsync))
+        .def("ready", &GLShader::ready, D(GLShader, ready))
         .def("initFromFiles", &GLShader::initFromFiles, py::arg("name"),
              py::arg("vertex_fname"), py::arg("fragment_fname"),
              py::arg("geometry_fname") = "", D(GLShader, initFromFiles))
         .def("name", &GLShader::name, D(GLShader, name))
+        .def_static("setBinaryCacheDirectory", &GLShader::setBinaryCacheDirectory,
+                    py::arg("path"), D(GLShader, setBinaryCacheDirectory))
+        .def_static("binaryCacheDirectory", &GLShader::binaryCacheDirectory,
+                    D(GLShader, binaryCacheDirectory))
+        .def("compileTime", &GLShader::compileTime, D(GLShader, compileTime))
+        .def("linkTime", &GLShader::linkTime, D(GLShader, linkTime))
+        .def("loadedFromBinary", &GLShader::loadedFromBinary, D(GLShader, loadedFromBinary))
         .def("define", &GLShader::define, py::arg("key"), py::arg("value"),
              D(GLShader, define))
         .def("bind", &GLShader::bind, D(GLShader, bind))
@@ -115,6 +157,13 @@ void register_glutil(py::module &m) {
         .def("uploadIndices", [](GLShader &sh, py::array M, int version) {
                 uploadAttribPy(sh, "indices", M, version);
              }, py::arg("M"), py::arg("version") = -1)
+        .def("updateAttrib", &updateAttribPy, py::arg("name"),
+             py::arg("M"), py::arg("offset"), D(GLShader, updateAttrib))
+        .def("streamAttrib", &streamAttribPy, py::arg("name"),
+             py::arg("M"), D(GLShader, streamAttrib))
+        .def("streamIndices", [](GLShader &sh, py::array M) {
+                streamAttribPy(sh, "indices", M);
+             }, py::arg("M"), D(GLShader, streamIndices))
         .def("invalidateAttribs", &GLShader::invalidateAttribs,
              D(GLShader, invalidateAttribs))
         .def("freeAttrib", &GLShader::freeAttrib,
@@ -134,8 +183,30 @@ void register_glutil(py::module &m) {
         .def("drawIndexed", &GLShader::drawIndexed,
              D(GLShader, drawIndexed), py::arg("type"),
              py::arg("offset"), py::arg("count"))
-        .def("setUniform", &setUniformPy, py::arg("name"),
-             py::arg("value"), py::arg("warn") = true)
+        .def("drawArrayInstanced", &GLShader::drawArrayInstanced,
+             D(GLShader, drawArrayInstanced), py::arg("type"),
+             py::arg("offset"), py::arg("count"), py::arg("instanceCount"))
+        .def("drawIndexedInstanced", &GLShader::drawIndexedInstanced,
+             D(GLShader, drawIndexedInstanced), py::arg("type"),
+             py::arg("offset"), py::arg("count"), py::arg("instanceCount"))
+        .def("drawArrayMulti", &GLShader::drawArrayMulti,
+             D(GLShader, drawArrayMulti), py::arg("type"),
+             py::arg("offsets"), py::arg("counts"))
+        .def("drawIndexedMulti", &GLShader::drawIndexedMulti,
+             D(GLShader, drawIndexedMulti), py::arg("type"),
+             py::arg("offsets"), py::arg("counts"))
+        .def("setAttribDivisor", &GLShader::setAttribDivisor, py::arg("name"),
+             py::arg("divisor"), D(GLShader, setAttribDivisor))
+        .def("attribDivisor", &GLShader::attribDivisor, py::arg("name"),
+             D(GLShader, attribDivisor))
+        .def("uniformHandle", &GLShader::uniformHandle, py::arg("name"),
+             py::arg("warn") = true, D(GLShader, uniformHandle))
+        .def("setUniform", [](GLShader &sh, const std::string &name, py::object value, bool warn) {
+                setUniformPy(sh, sh.uniformHandle(name, warn), value);
+             }, py::arg("name"), py::arg("value"), py::arg("warn") = true)
+        .def("setUniform", &setUniformPy, py::arg("handle"), py::arg("value"))
+        .def("invalidateUniforms", &GLShader::invalidateUniforms,
+             D(GLShader, invalidateUniforms))
         .def("attribBuffer", &GLShader::attribBuffer, D(GLShader, attribBuffer));
 
     py::class_<GLShader::Buffer>(m, "Buffer", D(GLShader, Buffer))
@@ -147,6 +218,11 @@ void register_glutil(py::module &m) {
         .def_readonly("size", &GLShader::Buffer::size, D(GLShader, Buffer, size))
         .def_readonly("version", &GLShader::Buffer::version, D(GLShader, Buffer, version));
 
+    py::class_<GLShader::UniformHandle>(m, "UniformHandle", D(GLShader, UniformHandle))
+        .def(py::init<int>(), py::arg("index") = -1)
+        .def("valid", &GLShader::UniformHandle::valid, D(GLShader, UniformHandle, valid))
+        .def_readonly("index", &GLShader::UniformHandle::index, D(GLShader, UniformHandle, index));
+
     py::class_<Arcball>(m, "Arcball", D(Arcball))
         .def(py::init<float>(), py::arg("speedFactor") = 2.f, D(Arcball, Arcball))
         .def(py::init<const Quaternionf &>(), D(Arcball, Arcball, 2))
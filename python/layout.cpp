@@ -12,7 +12,8 @@ void register_layout(py::module &m) {
     py::class_<Layout, ref<Layout>, PyLayout> layout(m, "Layout", D(Layout));
     layout
         .def("preferredSize", &Layout::preferredSize, D(Layout, preferredSize))
-        .def("performLayout", &Layout::performLayout, D(Layout, performLayout));
+        .def("performLayout", &Layout::performLayout, D(Layout, performLayout))
+        .def("invalidate", &Layout::invalidate, D(Layout, invalidate));
 
     py::class_<BoxLayout, Layout, ref<BoxLayout>, PyBoxLayout>(m, "BoxLayout", D(BoxLayout))
         .def(py::init<Orientation, Alignment, int, int>(),
@@ -216,6 +216,7 @@ PYBIND11_MODULE(nanogui, m) {
     #endif
     m.def("utf8", [](int c) { return std::string(utf8(c).data()); }, D(utf8));
     m.def("loadImageDirectory", &nanogui::loadImageDirectory, D(loadImageDirectory));
+    m.def("listImageDirectory", &nanogui::listImageDirectory, D(listImageDirectory));
 
     py::enum_<Cursor>(m, "Cursor", D(Cursor))
         .value("Arrow", Cursor::Arrow)
@@ -225,6 +226,10 @@ PYBIND11_MODULE(nanogui, m) {
         .value("HResize", Cursor::HResize)
         .value("VResize", Cursor::VResize);
 
+    py::enum_<CacheMode>(m, "CacheMode", D(CacheMode))
+        .value("Disabled", CacheMode::Disabled)
+        .value("Retained", CacheMode::Retained);
+
     py::enum_<Alignment>(m, "Alignment", D(Alignment))
         .value("Minimum", Alignment::Minimum)
         .value("Middle", Alignment::Middle)
@@ -43,11 +43,78 @@ void register_misc(py::module &m) {
         .def("textColor", &Graph::textColor, D(Graph, textColor))
         .def("setTextColor", &Graph::setTextColor, D(Graph, setTextColor))
         .def("values", (VectorXf &(Graph::*)(void)) &Graph::values, D(Graph, values))
-        .def("setValues", &Graph::setValues, D(Graph, setValues));
+        .def("setValues", &Graph::setValues, D(Graph, setValues))
+        .def("capacity", &Graph::capacity, D(Graph, capacity))
+        .def("setCapacity", &Graph::setCapacity, D(Graph, setCapacity))
+        .def("push", &Graph::push, D(Graph, push))
+        .def("pushBatch", [](Graph &g, const VectorXf &values) {
+            g.pushBatch(values.data(), (size_t) values.size());
+        }, D(Graph, pushBatch))
+        .def("sampleCount", &Graph::sampleCount, D(Graph, sampleCount))
+        .def("sample", &Graph::sample, D(Graph, sample))
+        .def("sampleRange", [](const Graph &g, size_t begin, size_t end) {
+            float min, max;
+            g.sampleRange(begin, end, min, max);
+            return std::make_pair(min, max);
+        }, D(Graph, sampleRange))
+        .def("queueCapacity", &Graph::queueCapacity, D(Graph, queueCapacity))
+        .def("setQueueCapacity", &Graph::setQueueCapacity, D(Graph, setQueueCapacity))
+        .def("enqueue", &Graph::enqueue, D(Graph, enqueue))
+        .def("enqueueBatch", [](Graph &g, const VectorXf &values) {
+            return g.enqueueBatch(values.data(), (size_t) values.size());
+        }, D(Graph, enqueueBatch))
+        .def("drainQueue", &Graph::drainQueue, D(Graph, drainQueue));
 
-    py::class_<ImageView, Widget, ref<ImageView>, PyImageView>(m, "ImageView", D(ImageView))
+    py::class_<TiledImageSource, ref<TiledImageSource>>(m, "TiledImageSource", D(TiledImageSource))
+        .def(py::init([](const Vector2i &size, int tileSize,
+                         const std::function<py::object(int, const Vector2i &)> &loader) {
+            /* The loader returns the pixels of a tile as 'bytes' (or None),
+               and is invoked from the loader thread of the tile cache */
+            return new TiledImageSource(size, tileSize,
+                [loader, bytes = (size_t) tileSize * (size_t) tileSize * 4]
+                (int level, const Vector2i &tile, uint8_t *data) {
+                    py::gil_scoped_acquire acquire;
+                    py::object result = loader(level, tile);
+                    if (result.is_none())
+                        return false;
+                    std::string pixels = result.cast<py::bytes>();
+                    if (pixels.size() != bytes)
+                        throw std::runtime_error("TiledImageSource: tile has the wrong size!");
+                    memcpy(data, pixels.data(), bytes);
+                    return true;
+                });
+        }), py::arg("size"), py::arg("tileSize"), py::arg("loader"), D(TiledImageSource, TiledImageSource))
+        .def("size", &TiledImageSource::size, D(TiledImageSource, size))
+        .def("tileSize", &TiledImageSource::tileSize, D(TiledImageSource, tileSize))
+        .def("levelCount", &TiledImageSource::levelCount, D(TiledImageSource, levelCount))
+        .def("levelSize", &TiledImageSource::levelSize, D(TiledImageSource, levelSize))
+        .def("tileCount", &TiledImageSource::tileCount, D(TiledImageSource, tileCount))
+        .def("tileBytes", &TiledImageSource::tileBytes, D(TiledImageSource, tileBytes));
+
+    py::class_<MappedImageSource, TiledImageSource, ref<MappedImageSource>>(m, "MappedImageSource", D(MappedImageSource))
+        .def(py::init<const std::string &, const Vector2i &, int, size_t>(),
+             py::arg("filename"), py::arg("size"), py::arg("tileSize"), py::arg("offset") = 0,
+             D(MappedImageSource, MappedImageSource))
+        .def_static("fileSize", &MappedImageSource::fileSize, D(MappedImageSource, fileSize));
+
+    py::class_<ImageView, Widget, ref<ImageView>, PyImageView> imageView(m, "ImageView", D(ImageView));
+    imageView
         .def(py::init<Widget *, GLuint>(), D(ImageView, ImageView))
         .def("bindImage", &ImageView::bindImage, D(ImageView, bindImage))
+        .def("bindTiledImage", &ImageView::bindTiledImage, D(ImageView, bindTiledImage))
+        .def("tiledImage", &ImageView::tiledImage, D(ImageView, tiledImage))
+        .def("tileMemoryBudget", &ImageView::tileMemoryBudget, D(ImageView, tileMemoryBudget))
+        .def("setTileMemoryBudget", &ImageView::setTileMemoryBudget, D(ImageView, setTileMemoryBudget))
+        .def("tileUploadBudget", &ImageView::tileUploadBudget, D(ImageView, tileUploadBudget))
+        .def("setTileUploadBudget", &ImageView::setTileUploadBudget, D(ImageView, setTileUploadBudget))
+        .def("exposure", &ImageView::exposure, D(ImageView, exposure))
+        .def("setExposure", &ImageView::setExposure, D(ImageView, setExposure))
+        .def("gamma", &ImageView::gamma, D(ImageView, gamma))
+        .def("setGamma", &ImageView::setGamma, D(ImageView, setGamma))
+        .def("channel", &ImageView::channel, D(ImageView, channel))
+        .def("setChannel", &ImageView::setChannel, D(ImageView, setChannel))
+        .def("falseColor", &ImageView::falseColor, D(ImageView, falseColor))
+        .def("setFalseColor", &ImageView::setFalseColor, D(ImageView, setFalseColor))
         .def("imageShader", &ImageView::imageShader, D(ImageView, imageShader))
         .def("scaledImageSize", &ImageView::scaledImageSize, D(ImageView, scaledImageSize))
         .def("offset", &ImageView::offset, D(ImageView, offset))
@@ -65,6 +132,9 @@ void register_misc(py::module &m) {
         .def("setPixelInfoThreshold", &ImageView::setPixelInfoThreshold, D(ImageView, setPixelInfoThreshold))
         .def("setPixelInfoCallback", &ImageView::setPixelInfoCallback, D(ImageView, setPixelInfoCallback))
         .def("pixelInfoCallback", &ImageView::pixelInfoCallback, D(ImageView, pixelInfoCallback))
+        .def("setPixelInfoBatchCallback", &ImageView::setPixelInfoBatchCallback, D(ImageView, setPixelInfoBatchCallback))
+        .def("pixelInfoBatchCallback", &ImageView::pixelInfoBatchCallback, D(ImageView, pixelInfoBatchCallback))
+        .def("invalidatePixelInfo", &ImageView::invalidatePixelInfo, D(ImageView, invalidatePixelInfo))
         .def("setFontScaleFactor", &ImageView::setFontScaleFactor, D(ImageView, setFontScaleFactor))
         .def("fontScaleFactor", &ImageView::fontScaleFactor, D(ImageView, fontScaleFactor))
         .def("imageCoordinateAt", &ImageView::imageCoordinateAt, D(ImageView, imageCoordinateAt))
@@ -80,12 +150,68 @@ void register_misc(py::module &m) {
         .def("pixelInfoVisible", &ImageView::pixelInfoVisible, D(ImageView, pixelInfoVisible))
         .def("helpersVisible", &ImageView::helpersVisible, D(ImageView, helpersVisible));
 
+    py::enum_<ImageView::Channel>(imageView, "Channel", D(ImageView, Channel))
+        .value("RGBA", ImageView::Channel::RGBA)
+        .value("Red", ImageView::Channel::Red)
+        .value("Green", ImageView::Channel::Green)
+        .value("Blue", ImageView::Channel::Blue)
+        .value("Alpha", ImageView::Channel::Alpha)
+        .value("Luminance", ImageView::Channel::Luminance);
+
     py::class_<ImagePanel, Widget, ref<ImagePanel>, PyImagePanel>(m, "ImagePanel", D(ImagePanel))
         .def(py::init<Widget *>(), py::arg("parent"), D(ImagePanel, ImagePanel))
         .def("images", &ImagePanel::images, D(ImagePanel, images))
         .def("setImages", &ImagePanel::setImages, D(ImagePanel, setImages))
+        .def("loadDirectory", &ImagePanel::loadDirectory, py::arg("path"),
+             py::arg("thumbnailSize") = -1, D(ImagePanel, loadDirectory))
+        .def("loading", &ImagePanel::loading, D(ImagePanel, loading))
+        .def("uploadBudget", &ImagePanel::uploadBudget, D(ImagePanel, uploadBudget))
+        .def("setUploadBudget", &ImagePanel::setUploadBudget, D(ImagePanel, setUploadBudget))
         .def("callback", &ImagePanel::callback, D(ImagePanel, callback))
         .def("setCallback", &ImagePanel::setCallback, D(ImagePanel, setCallback));
+
+    py::class_<FrameTimings>(m, "FrameTimings", D(FrameTimings))
+        .def(py::init<>())
+        .def_readonly("layout", &FrameTimings::layout, D(FrameTimings, layout))
+        .def_readonly("contents", &FrameTimings::contents, D(FrameTimings, contents))
+        .def_readonly("widgets", &FrameTimings::widgets, D(FrameTimings, widgets))
+        .def_readonly("flush", &FrameTimings::flush, D(FrameTimings, flush))
+        .def_readonly("swap", &FrameTimings::swap, D(FrameTimings, swap))
+        .def_readonly("total", &FrameTimings::total, D(FrameTimings, total));
+
+    py::class_<WidgetClassStats>(m, "WidgetClassStats", D(WidgetClassStats))
+        .def_readonly("name", &WidgetClassStats::name, D(WidgetClassStats, name))
+        .def_readonly("time", &WidgetClassStats::time, D(WidgetClassStats, time))
+        .def_readonly("calls", &WidgetClassStats::calls, D(WidgetClassStats, calls));
+
+    py::class_<FrameProfiler>(m, "FrameProfiler", D(FrameProfiler))
+        .def("capacity", &FrameProfiler::capacity, D(FrameProfiler, capacity))
+        .def("setCapacity", &FrameProfiler::setCapacity, D(FrameProfiler, setCapacity))
+        .def("frameCount", &FrameProfiler::frameCount, D(FrameProfiler, frameCount))
+        .def("totalFrames", &FrameProfiler::totalFrames, D(FrameProfiler, totalFrames))
+        .def("frame", &FrameProfiler::frame, D(FrameProfiler, frame))
+        .def("frames", &FrameProfiler::frames, D(FrameProfiler, frames))
+        .def("average", &FrameProfiler::average, D(FrameProfiler, average))
+        .def("peak", &FrameProfiler::peak, D(FrameProfiler, peak))
+        .def("widgetInstrumentation", &FrameProfiler::widgetInstrumentation,
+             D(FrameProfiler, widgetInstrumentation))
+        .def("setWidgetInstrumentation", &FrameProfiler::setWidgetInstrumentation,
+             D(FrameProfiler, setWidgetInstrumentation))
+        .def("widgetStats", &FrameProfiler::widgetStats, D(FrameProfiler, widgetStats))
+        .def("clear", &FrameProfiler::clear, D(FrameProfiler, clear));
+
+    py::class_<TextMetricsCache>(m, "TextMetricsCache", D(TextMetricsCache))
+        .def("capacity", &TextMetricsCache::capacity, D(TextMetricsCache, capacity))
+        .def("setCapacity", &TextMetricsCache::setCapacity, D(TextMetricsCache, setCapacity))
+        .def("size", &TextMetricsCache::size, D(TextMetricsCache, size))
+        .def("hits", &TextMetricsCache::hits, D(TextMetricsCache, hits))
+        .def("misses", &TextMetricsCache::misses, D(TextMetricsCache, misses))
+        .def("resetStatistics", &TextMetricsCache::resetStatistics,
+             D(TextMetricsCache, resetStatistics))
+        .def("clear", &TextMetricsCache::clear, D(TextMetricsCache, clear))
+        .def("pixelRatio", &TextMetricsCache::pixelRatio, D(TextMetricsCache, pixelRatio))
+        .def("setPixelRatio", &TextMetricsCache::setPixelRatio,
+             D(TextMetricsCache, setPixelRatio));
 }
 
 #endif
@@ -531,6 +531,16 @@ static const char *__doc_nanogui_Button_setTextColor = R"doc(Sets the text color
 
 static const char *__doc_nanogui_Button_textColor = R"doc(Returns the text color of the caption of this Button.)doc";
 
+static const char *__doc_nanogui_CacheMode =
+R"doc(Caching strategies for the drawing output of a widget subtree (see
+Widget::setCacheMode()).)doc";
+
+static const char *__doc_nanogui_CacheMode_Disabled = R"doc(Draw the subtree from scratch in every frame.)doc";
+
+static const char *__doc_nanogui_CacheMode_Retained =
+R"doc(Record the tessellated output once and replay it while the subtree is
+unchanged.)doc";
+
 static const char *__doc_nanogui_CheckBox =
 R"doc(Two-state check box widget.
 
@@ -1096,6 +1106,67 @@ static const char *__doc_nanogui_Cursor_IBeam = R"doc(The I-beam cursor.)doc";
 
 static const char *__doc_nanogui_Cursor_VResize = R"doc(The vertical resize cursor.)doc";
 
+static const char *__doc_nanogui_DrawCache =
+R"doc(Records the tessellated output of NanoVG draw calls for later replay.
+
+While recording, the render callbacks of the NanoVG context are
+intercepted: the paint, scissor and vertex data of every fill, stroke
+and triangle batch (including text) is copied before being passed on
+to the renderer as usual. Replaying submits these copies directly to
+the renderer, which skips path construction, flattening, tessellation
+and text layout altogether.
+
+The recorded vertices are in absolute coordinates, hence a recording
+is tagged with a user-provided Key (e.g. the transform and clip region
+that were active while recording) and should only be replayed when the
+key still matches. Recording and replaying must happen on the thread
+that draws the NanoVG frame; recordings may be nested.
+
+This is the mechanism behind Widget::setCacheMode().)doc";
+
+static const char *__doc_nanogui_DrawCache_DrawCache = R"doc()doc";
+
+static const char *__doc_nanogui_DrawCache_begin = R"doc(Start recording all draw calls issued through ``ctx``)doc";
+
+static const char *__doc_nanogui_DrawCache_clear = R"doc(Discard the recording)doc";
+
+static const char *__doc_nanogui_DrawCache_end =
+R"doc(Stop recording
+
+Returns ``False`` if the output could not be captured, which is the
+case when the NanoVG frame was flushed while recording (e.g. by a
+GLCanvas that issues OpenGL calls of its own). Such a cache stays
+invalid until clear() is called.)doc";
+
+static const char *__doc_nanogui_DrawCache_failed = R"doc(Check whether an earlier recording with the current contents failed)doc";
+
+static const char *__doc_nanogui_DrawCache_mCalls = R"doc()doc";
+
+static const char *__doc_nanogui_DrawCache_mContext = R"doc()doc";
+
+static const char *__doc_nanogui_DrawCache_mFailed = R"doc()doc";
+
+static const char *__doc_nanogui_DrawCache_mForward = R"doc()doc";
+
+static const char *__doc_nanogui_DrawCache_mImages = R"doc()doc";
+
+static const char *__doc_nanogui_DrawCache_mKey = R"doc()doc";
+
+static const char *__doc_nanogui_DrawCache_mParent = R"doc()doc";
+
+static const char *__doc_nanogui_DrawCache_mValid = R"doc()doc";
+
+static const char *__doc_nanogui_DrawCache_replay =
+R"doc(Submit the recorded draw calls to ``ctx``
+
+Returns ``False`` without drawing anything if one of the referenced
+images (e.g. a font atlas that has since been resized) no longer
+exists.)doc";
+
+static const char *__doc_nanogui_DrawCache_size = R"doc(Return the number of recorded draw calls)doc";
+
+static const char *__doc_nanogui_DrawCache_valid = R"doc(Check whether the cache contains a usable recording for the given key)doc";
+
 static const char *__doc_nanogui_FloatBox =
 R"doc(A specialization of TextBox representing floating point values.
 
@@ -1285,6 +1356,60 @@ static const char *__doc_nanogui_FormHelper_widgetFontSize = R"doc(The size of t
 
 static const char *__doc_nanogui_FormHelper_window = R"doc(Access the currently active Window instance)doc";
 
+static const char *__doc_nanogui_FrameProfiler =
+R"doc(Records the timings of the last frames drawn by a Screen.
+
+Frame timings are kept in a ring buffer of fixed capacity. Optionally,
+every Widget::draw() call is timed as well and accumulated per widget
+class (see setWidgetInstrumentation()). See Screen::setProfiling().)doc";
+
+static const char *__doc_nanogui_FrameProfiler_average = R"doc(Return the average timings of the frames in the ring buffer)doc";
+
+static const char *__doc_nanogui_FrameProfiler_capacity = R"doc(Return the number of frames that are retained)doc";
+
+static const char *__doc_nanogui_FrameProfiler_clear = R"doc(Discard all recorded frames and widget statistics)doc";
+
+static const char *__doc_nanogui_FrameProfiler_frame = R"doc(Return the timings of a frame in the ring buffer (0 is the oldest))doc";
+
+static const char *__doc_nanogui_FrameProfiler_frameCount = R"doc(Return the number of frames in the ring buffer)doc";
+
+static const char *__doc_nanogui_FrameProfiler_frames = R"doc(Return the timings of all frames in the ring buffer, oldest first)doc";
+
+static const char *__doc_nanogui_FrameProfiler_peak = R"doc(Return the largest timings of the frames in the ring buffer (per stage))doc";
+
+static const char *__doc_nanogui_FrameProfiler_setCapacity = R"doc(Set the number of frames that are retained (discards all recorded frames))doc";
+
+static const char *__doc_nanogui_FrameProfiler_setWidgetInstrumentation =
+R"doc(Time every Widget::draw() call
+
+Adds the overhead of two clock queries per drawn widget. Note that this
+only measures the construction of NanoVG paths and text, the actual
+rendering happens during the FrameTimings::flush stage.)doc";
+
+static const char *__doc_nanogui_FrameProfiler_totalFrames = R"doc(Return the number of frames recorded since the last call to clear())doc";
+
+static const char *__doc_nanogui_FrameProfiler_widgetInstrumentation = R"doc(Return whether Widget::draw() calls are timed)doc";
+
+static const char *__doc_nanogui_FrameProfiler_widgetStats = R"doc(Return the per-class draw statistics since clear(), most expensive first)doc";
+
+static const char *__doc_nanogui_FrameTimings =
+R"doc(CPU time (in milliseconds) spent on the stages of a single frame.
+
+OpenGL executes commands asynchronously, hence GPU work shows up in the
+stage that waits for it (usually the buffer swap).)doc";
+
+static const char *__doc_nanogui_FrameTimings_contents = R"doc(Screen::drawContents())doc";
+
+static const char *__doc_nanogui_FrameTimings_flush = R"doc(Rendering the NanoVG frame in ``nvgEndFrame()``)doc";
+
+static const char *__doc_nanogui_FrameTimings_layout = R"doc(Screen::performLayout() calls since the previous frame)doc";
+
+static const char *__doc_nanogui_FrameTimings_swap = R"doc(Presenting the frame (buffer swap))doc";
+
+static const char *__doc_nanogui_FrameTimings_total = R"doc(The complete Screen::drawAll() call)doc";
+
+static const char *__doc_nanogui_FrameTimings_widgets = R"doc(Building the NanoVG frame, i.e. Widget::draw() and tooltips)doc";
+
 static const char *__doc_nanogui_GLCanvas =
 R"doc(Canvas widget for rendering OpenGL content. This widget was
 contributed by Jan Winkler.
@@ -1365,6 +1490,8 @@ static const char *__doc_nanogui_GLFramebuffer_downloadTGA =
 R"doc(Quick and dirty method to write a TGA (32bpp RGBA) file of the
 framebuffer contents for debugging)doc";
 
+static const char *__doc_nanogui_GLFramebuffer_framebuffer = R"doc(Return the handle of the underlying OpenGL framebuffer object)doc";
+
 static const char *__doc_nanogui_GLFramebuffer_free = R"doc(Release all associated resources)doc";
 
 static const char *__doc_nanogui_GLFramebuffer_init =
@@ -1411,6 +1538,8 @@ static const char *__doc_nanogui_GLFramebuffer_release = R"doc(Release/unbind th
 
 static const char *__doc_nanogui_GLFramebuffer_samples = R"doc(Return the number of MSAA samples)doc";
 
+static const char *__doc_nanogui_GLFramebuffer_size = R"doc(Return the size of the framebuffer object)doc";
+
 static const char *__doc_nanogui_GLShader =
 R"doc(Helper class for compiling and linking OpenGL shaders and uploading
 associated vertex and index buffers from Eigen matrices.)doc";
@@ -1434,6 +1563,14 @@ static const char *__doc_nanogui_GLShader_Buffer_version = R"doc(The current ver
 
 static const char *__doc_nanogui_GLShader_GLShader = R"doc(Create an unitialized OpenGL shader)doc";
 
+static const char *__doc_nanogui_GLShader_UniformHandle =
+R"doc(A pre-resolved reference to a uniform of a linked shader, as returned
+by GLShader::uniformHandle.)doc";
+
+static const char *__doc_nanogui_GLShader_UniformHandle_index = R"doc(The index into the introspected uniforms (-1 if invalid).)doc";
+
+static const char *__doc_nanogui_GLShader_UniformHandle_valid = R"doc(Return whether the handle refers to an active uniform)doc";
+
 static const char *__doc_nanogui_GLShader_attrib =
 R"doc(Return the handle of a named shader attribute (-1 if it does not
 exist))doc";
@@ -1471,8 +1608,12 @@ Returns:
 Throws:
     std::runtime_error If ``name`` is not found.)doc";
 
+static const char *__doc_nanogui_GLShader_attribDivisor = R"doc(Return the instance divisor of an attribute (0 if it advances per vertex))doc";
+
 static const char *__doc_nanogui_GLShader_attribVersion = R"doc(Return the version number of a given attribute)doc";
 
+static const char *__doc_nanogui_GLShader_binaryCacheDirectory = R"doc(Return the directory of the program binary cache (empty if disabled))doc";
+
 static const char *__doc_nanogui_GLShader_bind =
 R"doc(Select this shader for subsequent draw calls. Simply executes
 ``glUseProgram`` with mProgramShader, and ``glBindVertexArray`` with
@@ -1480,6 +1621,12 @@ mVertexArrayObject.)doc";
 
 static const char *__doc_nanogui_GLShader_bufferSize = R"doc(Return the size of all registered buffers in bytes)doc";
 
+static const char *__doc_nanogui_GLShader_compileTime =
+R"doc(Return the time in seconds that the calling thread spent compiling the
+shaders
+
+This includes submitting the sources and waiting for the compile status.)doc";
+
 static const char *__doc_nanogui_GLShader_define =
 R"doc(Set a preprocessor definition. Custom preprocessor definitions must be
 added **before** initializing the shader (e.g., via initFromFiles).
@@ -1491,8 +1638,24 @@ static const char *__doc_nanogui_GLShader_downloadAttrib_2 = R"doc()doc";
 
 static const char *__doc_nanogui_GLShader_drawArray = R"doc(Draw a sequence of primitives)doc";
 
+static const char *__doc_nanogui_GLShader_drawArrayInstanced = R"doc(Draw a sequence of primitives ``instanceCount`` times (see setAttribDivisor))doc";
+
+static const char *__doc_nanogui_GLShader_drawArrayMulti =
+R"doc(Draw several sequences of primitives with a single call
+
+Equivalent to calling drawArray for every pair of offset and count,
+but submitted with ``glMultiDrawArrays``.)doc";
+
 static const char *__doc_nanogui_GLShader_drawIndexed = R"doc(Draw a sequence of primitives using a previously uploaded index buffer)doc";
 
+static const char *__doc_nanogui_GLShader_drawIndexedInstanced = R"doc(Draw a sequence of indexed primitives ``instanceCount`` times (see setAttribDivisor))doc";
+
+static const char *__doc_nanogui_GLShader_drawIndexedMulti =
+R"doc(Draw several sequences of indexed primitives with a single call
+
+Equivalent to calling drawIndexed for every pair of offset and count
+(in primitives), but submitted with ``glMultiDrawElements``.)doc";
+
 static const char *__doc_nanogui_GLShader_free = R"doc(Release underlying OpenGL objects)doc";
 
 static const char *__doc_nanogui_GLShader_freeAttrib = R"doc(Completely free an existing attribute buffer)doc";
@@ -1516,6 +1679,17 @@ Parameter ``geometry_str``:
     is the empty string, which indicates no geometry shader will be
     used.)doc";
 
+static const char *__doc_nanogui_GLShader_initAsync =
+R"doc(Start compiling and linking the shader without waiting for the result
+
+Takes the same arguments as init, but does not query the status of the
+compilation, which lets the driver process several programs in
+parallel (with ``KHR_parallel_shader_compile``) or on a background
+thread. The status is checked (and compilation errors are thrown) by
+ready once it reports completion, or at the latest when the shader is
+first bound or its uniforms or attributes are accessed, which blocks
+until the program is linked.)doc";
+
 static const char *__doc_nanogui_GLShader_initFromFiles =
 R"doc(Initialize the shader using the specified files on disk.
 
@@ -1535,6 +1709,18 @@ Parameter ``geometry_fname``:
 
 static const char *__doc_nanogui_GLShader_invalidateAttribs = R"doc(Invalidate the version numbers associated with attribute data)doc";
 
+static const char *__doc_nanogui_GLShader_invalidateUniforms =
+R"doc(Forget the cached values of all uniforms
+
+setUniform skips OpenGL calls that would not change the value of a
+uniform. Call this function after modifying uniforms of the program
+without going through this class (e.g. with ``glUniform*()`` and the
+location returned by uniform).)doc";
+
+static const char *__doc_nanogui_GLShader_linkTime = R"doc(Return the time in seconds that the calling thread spent waiting for the link status (or loading the binary))doc";
+
+static const char *__doc_nanogui_GLShader_loadedFromBinary = R"doc(Return whether init created the program from the binary cache)doc";
+
 static const char *__doc_nanogui_GLShader_mBufferObjects =
 R"doc(The map of string names to buffer objects representing the various
 attributes that have been uploaded using uploadAttrib.)doc";
@@ -1571,8 +1757,35 @@ R"doc(The vertex shader of this GLShader (as returned by
 
 static const char *__doc_nanogui_GLShader_name = R"doc(Return the name of the shader)doc";
 
+static const char *__doc_nanogui_GLShader_ready =
+R"doc(Return whether the program is ready to be used without blocking
+
+Always ``True`` after init. After initAsync, this polls the driver if
+it supports ``KHR_parallel_shader_compile``; otherwise, it finishes the
+initialization (which may block) and returns ``True``.)doc";
+
 static const char *__doc_nanogui_GLShader_resetAttribVersion = R"doc(Reset the version number of a given attribute)doc";
 
+static const char *__doc_nanogui_GLShader_setAttribDivisor =
+R"doc(Set the rate at which an attribute advances during instanced draw
+calls
+
+With a divisor of ``n``, the attribute advances once per ``n``
+instances instead of once per vertex (the default, which corresponds
+to 0). The setting persists when the attribute is uploaded, streamed
+or shared again. The shader must be bound.)doc";
+
+static const char *__doc_nanogui_GLShader_setBinaryCacheDirectory =
+R"doc(Set the directory of the program binary cache (empty to disable it)
+
+When enabled, init stores the binary of every linked program in this
+directory (which must exist), and later creates programs with
+identical sources, definitions and driver (vendor, renderer and
+version) from their binaries instead of compiling them. Binaries that
+the driver rejects are silently replaced. Requires support for
+``glProgramBinary`` (OpenGL 4.1 or ``ARB_get_program_binary``) and is
+ignored on other contexts.)doc";
+
 static const char *__doc_nanogui_GLShader_setUniform = R"doc(Initialize a uniform parameter with a 4x4 matrix (float))doc";
 
 static const char *__doc_nanogui_GLShader_setUniform_10 = R"doc(Initialize a uniform parameter with a 3D vector (int))doc";
@@ -1605,8 +1818,36 @@ static const char *__doc_nanogui_GLShader_shareAttrib =
 R"doc(Create a symbolic link to an attribute of another GLShader. This
 avoids duplicating unnecessary data)doc";
 
+static const char *__doc_nanogui_GLShader_streamAttrib =
+R"doc(Upload data that changes on every frame through a streaming ring
+buffer
+
+The buffer of a streamed attribute is divided into StreamSegments
+segments that are used in turn. Each segment is protected by a fence,
+so that new data never overwrites what the GPU may still read for a
+previous frame. With OpenGL 4.4 or ``ARB_buffer_storage``, the buffer
+is persistently mapped and the data is copied into it directly.)doc";
+
+static const char *__doc_nanogui_GLShader_streamIndices = R"doc(Upload an index buffer that changes on every frame (see streamAttrib))doc";
+
 static const char *__doc_nanogui_GLShader_uniform = R"doc(Return the handle of a uniform attribute (-1 if it does not exist))doc";
 
+static const char *__doc_nanogui_GLShader_uniformHandle =
+R"doc(Return a handle of a uniform that can be passed to setUniform instead
+of its name
+
+The active uniforms of the program are enumerated once after linking,
+hence this function merely looks up a hash table. Handles remain valid
+until the shader is freed or initialized again. The handle of a
+uniform that does not exist is invalid, and setting it has no effect.)doc";
+
+static const char *__doc_nanogui_GLShader_updateAttrib =
+R"doc(Overwrite the columns ``[offset, offset + M.cols())`` of an attribute
+
+The attribute must have been uploaded with the same number of rows and
+scalar type, and must cover the given columns. Only the affected part
+of the buffer is sent to the GPU.)doc";
+
 static const char *__doc_nanogui_GLShader_uploadAttrib =
 R"doc(Upload an Eigen matrix as a vertex buffer object (refreshing it as
 needed))doc";
@@ -1635,16 +1876,43 @@ static const char *__doc_nanogui_GLUniformBuffer_release = R"doc(Release/unbind
 
 static const char *__doc_nanogui_GLUniformBuffer_update = R"doc(Update content on the GPU using data)doc";
 
-static const char *__doc_nanogui_Graph = R"doc(Simple graph widget for showing a function plot.)doc";
+static const char *__doc_nanogui_Graph =
+R"doc(Simple graph widget for showing a function plot.
+
+The plotted values are either specified all at once using setValues(), or
+streamed into a ring buffer that retains the most recent capacity()
+samples (see push()). Producer threads can hand samples to the user
+interface thread through a lock-free queue (see enqueue()).
+
+Long series are decimated to a minimum and maximum per pixel column before
+drawing, which preserves peaks. The ring buffer maintains a min/max pyramid
+that is updated incrementally on every append, so that the cost of drawing
+it depends on the width of the widget rather than on the number of
+samples.)doc";
 
 static const char *__doc_nanogui_Graph_Graph = R"doc()doc";
 
 static const char *__doc_nanogui_Graph_backgroundColor = R"doc()doc";
 
+static const char *__doc_nanogui_Graph_capacity = R"doc(Return the capacity of the ring buffer (zero if disabled))doc";
+
 static const char *__doc_nanogui_Graph_caption = R"doc()doc";
 
+static const char *__doc_nanogui_Graph_drainQueue = R"doc(Move the samples waiting in the queue into the ring buffer and return how many were kept)doc";
+
 static const char *__doc_nanogui_Graph_draw = R"doc()doc";
 
+static const char *__doc_nanogui_Graph_enqueue =
+R"doc(Hand a sample from a producer thread to the user interface thread
+
+This function is wait-free and may be called concurrently with the user
+interface thread, but only from a single producer thread at a time.
+Returns ``False`` and drops the sample if the queue is full. Samples that
+arrive while the ring buffer is disabled (capacity() is zero) are removed
+from the queue but not plotted.)doc";
+
+static const char *__doc_nanogui_Graph_enqueueBatch = R"doc(Hand ``count`` samples to the user interface thread and return how many fit into the queue)doc";
+
 static const char *__doc_nanogui_Graph_footer = R"doc()doc";
 
 static const char *__doc_nanogui_Graph_foregroundColor = R"doc()doc";
@@ -1693,10 +1961,33 @@ static const char *__doc_nanogui_Graph_operator_new_5 = R"doc()doc";
 
 static const char *__doc_nanogui_Graph_preferredSize = R"doc()doc";
 
+static const char *__doc_nanogui_Graph_push = R"doc(Append a sample to the ring buffer, discarding the oldest one if it is full)doc";
+
+static const char *__doc_nanogui_Graph_pushBatch = R"doc(Append ``count`` samples to the ring buffer)doc";
+
+static const char *__doc_nanogui_Graph_queueCapacity = R"doc(Return the capacity of the producer queue (rounded up to a power of two))doc";
+
+static const char *__doc_nanogui_Graph_sample = R"doc(Return the plotted sample with index ``i`` (the oldest one has index 0))doc";
+
+static const char *__doc_nanogui_Graph_sampleCount = R"doc(Return the number of plotted samples)doc";
+
+static const char *__doc_nanogui_Graph_sampleRange =
+R"doc(Compute the minimum and maximum of the plotted samples with indices in
+``[begin, end)``
+
+Takes logarithmic time in the ring buffer and linear time otherwise.)doc";
+
 static const char *__doc_nanogui_Graph_save = R"doc()doc";
 
 static const char *__doc_nanogui_Graph_setBackgroundColor = R"doc()doc";
 
+static const char *__doc_nanogui_Graph_setCapacity =
+R"doc(Plot the last ``capacity`` samples passed to push()
+
+The samples are kept in a preallocated ring buffer, hence appending them
+never allocates or moves the others. A capacity of zero disables the ring
+buffer and plots values() instead.)doc";
+
 static const char *__doc_nanogui_Graph_setCaption = R"doc()doc";
 
 static const char *__doc_nanogui_Graph_setFooter = R"doc()doc";
@@ -1705,13 +1996,17 @@ static const char *__doc_nanogui_Graph_setForegroundColor = R"doc()doc";
 
 static const char *__doc_nanogui_Graph_setHeader = R"doc()doc";
 
+static const char *__doc_nanogui_Graph_setQueueCapacity =
+R"doc(Allocate a queue that transfers up to ``capacity`` samples from a
+producer thread to the ring buffer)doc";
+
 static const char *__doc_nanogui_Graph_setTextColor = R"doc()doc";
 
-static const char *__doc_nanogui_Graph_setValues = R"doc()doc";
+static const char *__doc_nanogui_Graph_setValues = R"doc(Set the plotted values (replaces the contents of the ring buffer, if enabled))doc";
 
 static const char *__doc_nanogui_Graph_textColor = R"doc()doc";
 
-static const char *__doc_nanogui_Graph_values = R"doc()doc";
+static const char *__doc_nanogui_Graph_values = R"doc(Return the values that are plotted when the ring buffer is disabled)doc";
 
 static const char *__doc_nanogui_Graph_values_2 = R"doc()doc";
 
@@ -1897,6 +2192,19 @@ static const char *__doc_nanogui_ImagePanel_images = R"doc()doc";
 
 static const char *__doc_nanogui_ImagePanel_indexForPosition = R"doc()doc";
 
+static const char *__doc_nanogui_ImagePanel_loadDirectory =
+R"doc(Asynchronously load the PNG images of a directory as thumbnails
+
+The entries are added immediately as placeholders and filled in as
+their images are decoded on worker threads (see ThumbnailLoader),
+starting with the visible ones. The images are downscaled until their
+smaller side does not exceed ``thumbnailSize`` pixels (by default twice
+the size of the icons, for high-DPI displays), cropped to a square and
+packed into texture atlases owned by the panel. The image of all
+entries is 0.)doc";
+
+static const char *__doc_nanogui_ImagePanel_loading = R"doc(Return whether loadDirectory() is still filling in thumbnails)doc";
+
 static const char *__doc_nanogui_ImagePanel_mCallback = R"doc()doc";
 
 static const char *__doc_nanogui_ImagePanel_mImages = R"doc()doc";
@@ -1943,14 +2251,36 @@ static const char *__doc_nanogui_ImagePanel_setCallback = R"doc()doc";
 
 static const char *__doc_nanogui_ImagePanel_setImages = R"doc()doc";
 
+static const char *__doc_nanogui_ImagePanel_setUploadBudget = R"doc(Set the time in seconds that may be spent creating thumbnail images per frame)doc";
+
+static const char *__doc_nanogui_ImagePanel_uploadBudget = R"doc(Return the time in seconds that may be spent creating thumbnail images per frame)doc";
+
 static const char *__doc_nanogui_ImageView = R"doc(Widget used to display images.)doc";
 
+static const char *__doc_nanogui_ImageView_Channel = R"doc(The channels that can be displayed.)doc";
+
+static const char *__doc_nanogui_ImageView_Channel_Alpha = R"doc(The alpha channel as a grayscale image.)doc";
+
+static const char *__doc_nanogui_ImageView_Channel_Blue = R"doc(The blue channel as a grayscale image.)doc";
+
+static const char *__doc_nanogui_ImageView_Channel_Green = R"doc(The green channel as a grayscale image.)doc";
+
+static const char *__doc_nanogui_ImageView_Channel_Luminance = R"doc(The luminance of the red, green and blue channels.)doc";
+
+static const char *__doc_nanogui_ImageView_Channel_RGBA = R"doc(All channels.)doc";
+
+static const char *__doc_nanogui_ImageView_Channel_Red = R"doc(The red channel as a grayscale image.)doc";
+
 static const char *__doc_nanogui_ImageView_ImageView = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_bindImage = R"doc()doc";
 
+static const char *__doc_nanogui_ImageView_bindTiledImage = R"doc(Display a tiled image pyramid instead of a texture)doc";
+
 static const char *__doc_nanogui_ImageView_center = R"doc(Centers the image without affecting the scaling factor.)doc";
 
+static const char *__doc_nanogui_ImageView_channel = R"doc(Return the displayed channel(s))doc";
+
 static const char *__doc_nanogui_ImageView_clampedImageCoordinateAt =
 R"doc(Calculates the image coordinates of the given pixel position on the
 widget. If the position provided corresponds to a coordinate outside
@@ -1969,6 +2299,10 @@ static const char *__doc_nanogui_ImageView_drawPixelInfo = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_drawWidgetBorder = R"doc()doc";
 
+static const char *__doc_nanogui_ImageView_exposure = R"doc(Return the exposure in stops, i.e. the values are scaled by ``2^exposure``)doc";
+
+static const char *__doc_nanogui_ImageView_falseColor = R"doc(Return whether the selected channel (or the luminance) is mapped to colors)doc";
+
 static const char *__doc_nanogui_ImageView_fit = R"doc(Centers and scales the image so that it fits inside the widgets.)doc";
 
 static const char *__doc_nanogui_ImageView_fixedOffset = R"doc()doc";
@@ -1977,6 +2311,8 @@ static const char *__doc_nanogui_ImageView_fixedScale = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_fontScaleFactor = R"doc()doc";
 
+static const char *__doc_nanogui_ImageView_gamma = R"doc(Return the gamma that is applied to the scaled values)doc";
+
 static const char *__doc_nanogui_ImageView_gridThreshold = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_gridVisible = R"doc(Function indicating whether the grid is currently visible.)doc";
@@ -1993,6 +2329,8 @@ static const char *__doc_nanogui_ImageView_imageSize = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_imageSizeF = R"doc()doc";
 
+static const char *__doc_nanogui_ImageView_invalidatePixelInfo = R"doc(Discard the cached pixel information)doc";
+
 static const char *__doc_nanogui_ImageView_keyboardCharacterEvent = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_keyboardEvent = R"doc()doc";
@@ -2053,6 +2391,8 @@ static const char *__doc_nanogui_ImageView_operator_new_5 = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_performLayout = R"doc()doc";
 
+static const char *__doc_nanogui_ImageView_pixelInfoBatchCallback = R"doc()doc";
+
 static const char *__doc_nanogui_ImageView_pixelInfoCallback = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_pixelInfoThreshold = R"doc()doc";
@@ -2077,12 +2417,24 @@ static const char *__doc_nanogui_ImageView_scaledImageSizeF = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_scrollEvent = R"doc()doc";
 
+static const char *__doc_nanogui_ImageView_setChannel = R"doc(Set the displayed channel(s))doc";
+
+static const char *__doc_nanogui_ImageView_setExposure = R"doc(Set the exposure in stops, i.e. the values are scaled by ``2^exposure``)doc";
+
+static const char *__doc_nanogui_ImageView_setFalseColor =
+R"doc(Set whether the selected channel (or the luminance) is mapped to colors
+
+The scaled values in ``[0, 1]`` are mapped to the colors of the Turbo
+colormap, from dark blue to dark red. Gamma is not applied.)doc";
+
 static const char *__doc_nanogui_ImageView_setFixedOffset = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_setFixedScale = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_setFontScaleFactor = R"doc()doc";
 
+static const char *__doc_nanogui_ImageView_setGamma = R"doc(Set the gamma that is applied to the scaled values (e.g. 2.2 for linear images))doc";
+
 static const char *__doc_nanogui_ImageView_setGridThreshold = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_setImageCoordinateAt =
@@ -2093,6 +2445,8 @@ widget.)doc";
 
 static const char *__doc_nanogui_ImageView_setOffset = R"doc()doc";
 
+static const char *__doc_nanogui_ImageView_setPixelInfoBatchCallback = R"doc(Set a callback that provides the pixel information of all visible pixels at once)doc";
+
 static const char *__doc_nanogui_ImageView_setPixelInfoCallback = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_setPixelInfoThreshold = R"doc()doc";
@@ -2101,13 +2455,21 @@ static const char *__doc_nanogui_ImageView_setScale = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_setScaleCentered = R"doc(Set the scale while keeping the image centered)doc";
 
+static const char *__doc_nanogui_ImageView_setTileMemoryBudget = R"doc(Set the maximum number of bytes of GPU memory used by the tiles of a tiled image)doc";
+
+static const char *__doc_nanogui_ImageView_setTileUploadBudget = R"doc(Set the time in seconds that may be spent uploading tiles per frame)doc";
+
 static const char *__doc_nanogui_ImageView_setZoomSensitivity = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_sizeF = R"doc()doc";
 
-static const char *__doc_nanogui_ImageView_updateImageParameters = R"doc()doc";
+static const char *__doc_nanogui_ImageView_tileMemoryBudget = R"doc(Return the maximum number of bytes of GPU memory used by the tiles of a tiled image)doc";
 
-static const char *__doc_nanogui_ImageView_writePixelInfo = R"doc()doc";
+static const char *__doc_nanogui_ImageView_tileUploadBudget = R"doc(Return the time in seconds that may be spent uploading tiles per frame)doc";
+
+static const char *__doc_nanogui_ImageView_tiledImage = R"doc(Return the tiled image pyramid that is displayed (if any))doc";
+
+static const char *__doc_nanogui_ImageView_updateImageParameters = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_zoom =
 R"doc(Changes the scale factor by the provided amount modified by the zoom
@@ -2241,6 +2603,13 @@ static const char *__doc_nanogui_Label_setTheme = R"doc(Set the Theme used to dr
 
 static const char *__doc_nanogui_Layout = R"doc(Basic interface of a layout engine.)doc";
 
+static const char *__doc_nanogui_Layout_invalidate =
+R"doc(Discard the cached layout information of all widgets using this layout
+
+The setters of the layout parameters call this function, so that the
+next Widget::performLayout() of an ancestor takes the change into
+account (see Widget::invalidateLayout()).)doc";
+
 static const char *__doc_nanogui_Layout_performLayout =
 R"doc(Performs any and all resizing applicable.
 
@@ -2263,6 +2632,12 @@ Returns:
     The preferred size, accounting for things such as spacing, padding
     for icons, etc.)doc";
 
+static const char *__doc_nanogui_MappedImageSource = R"doc(Tiled image pyramid that is read from a memory-mapped file.)doc";
+
+static const char *__doc_nanogui_MappedImageSource_MappedImageSource = R"doc(Map a file that holds a pyramid of the given image and tile size)doc";
+
+static const char *__doc_nanogui_MappedImageSource_fileSize = R"doc(Return the size of a file that holds a pyramid of the given image and tile size (excluding the offset))doc";
+
 static const char *__doc_nanogui_MessageDialog = R"doc(Simple "OK" or "Yes/No"-style modal dialogs.)doc";
 
 static const char *__doc_nanogui_MessageDialog_MessageDialog = R"doc()doc";
@@ -2335,6 +2710,78 @@ static const char *__doc_nanogui_Orientation_Horizontal = R"doc(Layout expands o
 
 static const char *__doc_nanogui_Orientation_Vertical = R"doc(Layout expands on vertical axis.)doc";
 
+static const char *__doc_nanogui_Plot =
+R"doc(Plot of many long series of uniformly spaced samples.
+
+Unlike Graph, which builds a NanoVG path on every frame, the samples of
+each series reside in an OpenGL vertex buffer and are drawn as a line
+strip. Only the modified samples are uploaded (see setSeriesData() and
+appendSeries()), and panning or zooming merely changes shader uniforms.
+Axes, grid lines and the legend are drawn with NanoVG on top of the
+series, which are composited like the contents of any other GLCanvas.
+
+Sample ``i`` of a series lies at ``x = start + i * step`` (see
+setSeriesSampling()), where ``i`` counts all samples ever appended. The
+view can be panned by dragging and zoomed horizontally with the scroll
+wheel. Positions on the x axis are kept in double precision, so that long
+recordings can be inspected at the resolution of single samples; only
+offsets relative to the view are passed to the shader.
+
+The buffers are created and updated immediately, hence all functions that
+modify series must be called while the OpenGL context of the screen is
+current (i.e. on the user interface thread).)doc";
+
+static const char *__doc_nanogui_Plot_Plot = R"doc()doc";
+
+static const char *__doc_nanogui_Plot_addSeries = R"doc(Add a series that retains up to ``capacity`` samples and return its index)doc";
+
+static const char *__doc_nanogui_Plot_appendSeries = R"doc(Append samples to a series, discarding the oldest ones once it is full)doc";
+
+static const char *__doc_nanogui_Plot_autoScroll = R"doc(Return whether the x axis follows the most recent sample)doc";
+
+static const char *__doc_nanogui_Plot_axisColor = R"doc(Return the color of the axes, grid lines and labels)doc";
+
+static const char *__doc_nanogui_Plot_fitView = R"doc(Set the visible ranges to the extent of the visible series)doc";
+
+static const char *__doc_nanogui_Plot_removeSeries = R"doc(Remove a series (the indices of the following ones decrease by one))doc";
+
+static const char *__doc_nanogui_Plot_seriesCapacity = R"doc(Return the maximum number of samples that a series retains)doc";
+
+static const char *__doc_nanogui_Plot_seriesColor = R"doc(Return the color of a series)doc";
+
+static const char *__doc_nanogui_Plot_seriesCount = R"doc(Return the number of series)doc";
+
+static const char *__doc_nanogui_Plot_seriesName = R"doc(Return the name of a series)doc";
+
+static const char *__doc_nanogui_Plot_seriesSize = R"doc(Return the number of samples that a series currently holds)doc";
+
+static const char *__doc_nanogui_Plot_seriesVisible = R"doc(Return whether a series is drawn)doc";
+
+static const char *__doc_nanogui_Plot_setAutoScroll = R"doc(Set whether the x axis follows the most recent sample (disabled by panning))doc";
+
+static const char *__doc_nanogui_Plot_setAxisColor = R"doc(Set the color of the axes, grid lines and labels)doc";
+
+static const char *__doc_nanogui_Plot_setSeriesColor = R"doc(Set the color of a series)doc";
+
+static const char *__doc_nanogui_Plot_setSeriesData =
+R"doc(Overwrite the samples with indices ``[offset, offset + count)``
+
+Indices are relative to the oldest retained sample. Only the affected part
+of the vertex buffer is uploaded. Writing past the current size grows the
+series up to its capacity.)doc";
+
+static const char *__doc_nanogui_Plot_setSeriesSampling = R"doc(Set the position of the first sample and the spacing of samples on the x axis)doc";
+
+static const char *__doc_nanogui_Plot_setSeriesVisible = R"doc(Set whether a series is drawn)doc";
+
+static const char *__doc_nanogui_Plot_setXRange = R"doc(Set the visible range of the x axis)doc";
+
+static const char *__doc_nanogui_Plot_setYRange = R"doc(Set the visible range of the y axis)doc";
+
+static const char *__doc_nanogui_Plot_xRange = R"doc(Return the visible range of the x axis)doc";
+
+static const char *__doc_nanogui_Plot_yRange = R"doc(Return the visible range of the y axis)doc";
+
 static const char *__doc_nanogui_Popup =
 R"doc(Popup window for combo boxes, popup buttons, nested dialogs etc.
 
@@ -2588,19 +3035,29 @@ an existing ``GLFWwindow`` instance
 You will also be responsible in this case to deliver GLFW callbacks to
 the appropriate callback event handlers below)doc";
 
+static const char *__doc_nanogui_Screen_addDamage = R"doc(Record the bounds of a widget (at absolute position ``pos``) as damaged)doc";
+
 static const char *__doc_nanogui_Screen_background = R"doc(Return the screen's background color)doc";
 
+static const char *__doc_nanogui_Screen_cancelAnimationFrame = R"doc(Cancel a callback registered with requestAnimationFrame())doc";
+
 static const char *__doc_nanogui_Screen_caption = R"doc(Get the window title bar caption)doc";
 
 static const char *__doc_nanogui_Screen_centerWindow = R"doc()doc";
 
 static const char *__doc_nanogui_Screen_charCallbackEvent = R"doc()doc";
 
+static const char *__doc_nanogui_Screen_cullWidgets = R"doc(Flag all subtrees of ``widget`` that don't intersect mRedrawRegion)doc";
+
 static const char *__doc_nanogui_Screen_cursorPosCallbackEvent = R"doc()doc";
 
 static const char *__doc_nanogui_Screen_disposeWindow = R"doc()doc";
 
-static const char *__doc_nanogui_Screen_drawAll = R"doc(Draw the Screen contents)doc";
+static const char *__doc_nanogui_Screen_drawAll =
+R"doc(Draw the Screen contents
+
+Rendering and the buffer swap are skipped when no widget has been
+marked as dirty since the previous frame (see Widget::markDirty()).)doc";
 
 static const char *__doc_nanogui_Screen_drawContents = R"doc(Draw the window contents --- put your OpenGL draw calls here)doc";
 
@@ -2610,10 +3067,32 @@ static const char *__doc_nanogui_Screen_dropCallbackEvent = R"doc()doc";
 
 static const char *__doc_nanogui_Screen_dropEvent = R"doc(Handle a file drop event)doc";
 
+static const char *__doc_nanogui_Screen_framebufferSize = R"doc(Return the size of the framebuffer in hardware pixels)doc";
+
 static const char *__doc_nanogui_Screen_glfwWindow = R"doc(Return a pointer to the underlying GLFW window data structure)doc";
 
+static const char *__doc_nanogui_Screen_headless = R"doc(Return whether this screen renders offscreen (see initializeHeadless()))doc";
+
 static const char *__doc_nanogui_Screen_initialize = R"doc(Initialize the Screen)doc";
 
+static const char *__doc_nanogui_Screen_initializeHeadless =
+R"doc(Initialize the Screen without a window
+
+Creates an OpenGL 3.3 core profile context that renders into an
+offscreen EGL pbuffer surface of the given size (at 96 dpi), which
+requires neither a display server nor nanogui::init(). This is meant
+for automated tests, screenshots and benchmarks: call drawAll() to
+render a frame and readPixels() to retrieve it.
+
+Input is delivered through the event handlers below, with the same
+conventions as the GLFW callbacks they normally receive. A call to
+resizeCallbackEvent() takes the new framebuffer size. Unless GLFW was
+initialized, ``glfwGetTime()`` always returns zero, hence tooltips
+never appear and the output only depends on the events.
+
+Only available when NanoGUI was compiled with the ``NANOGUI_HEADLESS``
+CMake option, throws ``std::runtime_error`` otherwise.)doc";
+
 static const char *__doc_nanogui_Screen_keyCallbackEvent = R"doc()doc";
 
 static const char *__doc_nanogui_Screen_keyboardCharacterEvent = R"doc(Text input event handler: codepoint is native endian UTF-32 format)doc";
@@ -2628,6 +3107,10 @@ static const char *__doc_nanogui_Screen_mCursor = R"doc()doc";
 
 static const char *__doc_nanogui_Screen_mCursors = R"doc()doc";
 
+static const char *__doc_nanogui_Screen_mDamage = R"doc()doc";
+
+static const char *__doc_nanogui_Screen_mDamageAll = R"doc()doc";
+
 static const char *__doc_nanogui_Screen_mDragActive = R"doc()doc";
 
 static const char *__doc_nanogui_Screen_mDragWidget = R"doc()doc";
@@ -2650,20 +3133,37 @@ static const char *__doc_nanogui_Screen_mMouseState = R"doc()doc";
 
 static const char *__doc_nanogui_Screen_mNVGContext = R"doc()doc";
 
+static const char *__doc_nanogui_Screen_mPartialRedraw = R"doc()doc";
+
 static const char *__doc_nanogui_Screen_mPixelRatio = R"doc()doc";
 
 static const char *__doc_nanogui_Screen_mProcessEvents = R"doc()doc";
 
+static const char *__doc_nanogui_Screen_mRedrawRegion = R"doc()doc";
+
+static const char *__doc_nanogui_Screen_mRedrawRegions = R"doc()doc";
+
 static const char *__doc_nanogui_Screen_mResizeCallback = R"doc()doc";
 
+static const char *__doc_nanogui_Screen_mRetainedFrame = R"doc()doc";
+
 static const char *__doc_nanogui_Screen_mShutdownGLFWOnDestruct = R"doc()doc";
 
+static const char *__doc_nanogui_Screen_mSkippedFrames = R"doc()doc";
+
 static const char *__doc_nanogui_Screen_mouseButtonCallbackEvent = R"doc()doc";
 
 static const char *__doc_nanogui_Screen_mousePos = R"doc(Return the last observed mouse position value)doc";
 
 static const char *__doc_nanogui_Screen_moveWindowToFront = R"doc()doc";
 
+static const char *__doc_nanogui_Screen_nextFrameTime =
+R"doc(Return when drawAll() next has work to do
+
+The result is a time on the ``glfwGetTime()`` clock, which lies in the
+past if a frame is due immediately (dirty widgets or animation frame
+requests) and is infinite if the screen is idle.)doc";
+
 static const char *__doc_nanogui_Screen_nvgContext = R"doc(Return a pointer to the underlying nanoVG draw context)doc";
 
 static const char *__doc_nanogui_Screen_operator_delete = R"doc()doc";
@@ -2690,24 +3190,109 @@ static const char *__doc_nanogui_Screen_operator_new_4 = R"doc()doc";
 
 static const char *__doc_nanogui_Screen_operator_new_5 = R"doc()doc";
 
+static const char *__doc_nanogui_Screen_parallelLayout = R"doc(Return whether independent subtrees are laid out concurrently (see setParallelLayout()))doc";
+
+static const char *__doc_nanogui_Screen_partialRedraw = R"doc(Return whether partial redraws are enabled (see setPartialRedraw()))doc";
+
 static const char *__doc_nanogui_Screen_performLayout = R"doc(Compute the layout of all widgets)doc";
 
 static const char *__doc_nanogui_Screen_pixelRatio =
 R"doc(Return the ratio between pixel and device coordinates (e.g. >= 2 on
 Mac Retina displays))doc";
 
+static const char *__doc_nanogui_Screen_profiler = R"doc(Return the frame time profiler, or ``nullptr`` if profiling is disabled)doc";
+
+static const char *__doc_nanogui_Screen_profilerOverlay = R"doc(Return whether the frame time overlay is shown (see setProfilerOverlay()))doc";
+
+static const char *__doc_nanogui_Screen_profiling = R"doc(Return whether the frame time profiler is enabled (see setProfiling()))doc";
+
+static const char *__doc_nanogui_Screen_readPixels =
+R"doc(Read back the most recently drawn frame
+
+Returns framebufferSize().prod() RGBA pixels with 8 bits per
+component, ordered from the top left to the bottom right. Headless
+screens read the back buffer, all others the front buffer.)doc";
+
+static const char *__doc_nanogui_Screen_requestAnimationFrame =
+R"doc(Invoke a callback once before the next frame is drawn
+
+The callback receives the current time (see ``glfwGetTime()``) and is
+expected to update the animated state, e.g. by calling setters that
+mark widgets as dirty. Animations that should continue must request
+another frame from within the callback. While frames are requested,
+mainloop() draws at the refresh rate of the display; otherwise, it
+sleeps until the next input event or scheduled redraw.
+
+Returns an identifier that can be passed to cancelAnimationFrame().)doc";
+
 static const char *__doc_nanogui_Screen_resizeCallback = R"doc(Set the resize callback)doc";
 
 static const char *__doc_nanogui_Screen_resizeCallbackEvent = R"doc()doc";
 
 static const char *__doc_nanogui_Screen_resizeEvent = R"doc(Window resize event handler)doc";
 
+static const char *__doc_nanogui_Screen_runScheduled = R"doc(Run pending animation frame callbacks and scheduled redraws that are due)doc";
+
+static const char *__doc_nanogui_Screen_scheduleRedraw =
+R"doc(Mark ``widget`` as dirty once the clock reaches ``time``
+
+``time`` is specified in seconds on the ``glfwGetTime()`` clock. Only
+the earliest pending redraw is retained per widget. See
+Widget::scheduleRedrawAt().)doc";
+
 static const char *__doc_nanogui_Screen_scrollCallbackEvent = R"doc()doc";
 
 static const char *__doc_nanogui_Screen_setBackground = R"doc(Set the screen's background color)doc";
 
 static const char *__doc_nanogui_Screen_setCaption = R"doc(Set the window title bar caption)doc";
 
+static const char *__doc_nanogui_Screen_setParallelLayout =
+R"doc(Lay out independent subtrees concurrently
+
+When enabled, performLayout() lays out the windows of the screen on
+the threads of ThreadPool::shared(). Nested containers whose children
+are independent (GridLayout, StackedWidget and thereby TabWidget)
+distribute their children in the same way (see
+Widget::performLayouts()). Text is measured through the thread-safe
+TextMetricsCache, which does not require the OpenGL context.
+
+Custom widgets must then only modify their own subtree in
+Widget::preferredSize() and Widget::performLayout(), and measure text
+via textBounds() and related functions instead of calling NanoVG
+directly. Methods overridden in Python hold the interpreter lock and
+therefore still run one at a time. Since the damaged regions are not
+tracked during a parallel layout, the next frame is always a complete
+redraw.)doc";
+
+static const char *__doc_nanogui_Screen_setPartialRedraw =
+R"doc(Enable or disable partial redraws
+
+When enabled, drawAll() only repaints the regions covered by widgets
+that were marked as dirty since the previous frame (see
+Widget::markDirty()) and skips all subtrees that don't intersect them.
+Changes to the screen itself (e.g. resizing or input events) still
+cause a full repaint. The last frame is retained in an offscreen
+framebuffer, hence this requires a default framebuffer without
+multisampling.
+
+drawContents() is invoked once per damaged region, with the scissor
+test set up accordingly.)doc";
+
+static const char *__doc_nanogui_Screen_setProfilerOverlay =
+R"doc(Show a Graph of recent frame times in the top right corner
+
+The graph is scaled so that its top corresponds to twice the 16.7 ms
+budget of a 60 Hz display. It is refreshed whenever the screen is
+redrawn anyway and does not cause any redraws of its own. Enabling the
+overlay also enables profiling.)doc";
+
+static const char *__doc_nanogui_Screen_setProfiling =
+R"doc(Enable or disable the frame time profiler
+
+While enabled, the timings of every frame drawn by drawAll() are
+recorded by the FrameProfiler returned by profiler(). Disabling the
+profiler discards all measurements.)doc";
+
 static const char *__doc_nanogui_Screen_setResizeCallback = R"doc()doc";
 
 static const char *__doc_nanogui_Screen_setShutdownGLFWOnDestruct = R"doc()doc";
@@ -2718,8 +3303,14 @@ static const char *__doc_nanogui_Screen_setVisible = R"doc(Set the top-level win
 
 static const char *__doc_nanogui_Screen_shutdownGLFWOnDestruct = R"doc()doc";
 
+static const char *__doc_nanogui_Screen_skippedFrames = R"doc(Return the number of drawAll() calls that were skipped because nothing changed)doc";
+
+static const char *__doc_nanogui_Screen_textMetrics = R"doc(Return the cache of text measurements shared by all widgets (see textBounds()))doc";
+
 static const char *__doc_nanogui_Screen_updateFocus = R"doc()doc";
 
+static const char *__doc_nanogui_Screen_updateRedrawRegions = R"doc(Merge the damaged regions, returns ``False`` when a full repaint is needed)doc";
+
 static const char *__doc_nanogui_Slider = R"doc(Fractional slider widget with mouse control.)doc";
 
 static const char *__doc_nanogui_Slider_Slider = R"doc()doc";
@@ -2796,6 +3387,27 @@ static const char *__doc_nanogui_Slider_setValue = R"doc()doc";
 
 static const char *__doc_nanogui_Slider_value = R"doc()doc";
 
+static const char *__doc_nanogui_SpatialIndex =
+R"doc(Accelerates hit tests against a large number of child widgets.
+
+The bounding box of all children is subdivided into a uniform grid
+with roughly one cell per child, and each cell lists the (indices of
+the) children overlapping it in drawing order. A hit test then only
+needs to look at the children of a single cell instead of all of them.
+
+This is the mechanism behind Widget::setSpatialIndex().)doc";
+
+static const char *__doc_nanogui_SpatialIndex_build = R"doc(Rebuild the grid from the current bounds of the given widgets)doc";
+
+static const char *__doc_nanogui_SpatialIndex_cellCount = R"doc(Return the number of grid cells)doc";
+
+static const char *__doc_nanogui_SpatialIndex_query =
+R"doc(Return the children whose bounds overlap the cell containing ``p``
+
+``p`` is specified in the coordinate system of the children's
+positions. This is a superset of the children containing ``p``,
+regardless of their visibility.)doc";
+
 static const char *__doc_nanogui_StackedWidget = R"doc(A stack widget.)doc";
 
 static const char *__doc_nanogui_StackedWidget_StackedWidget = R"doc()doc";
@@ -3285,6 +3897,65 @@ static const char *__doc_nanogui_TextBox_updateCursor = R"doc()doc";
 
 static const char *__doc_nanogui_TextBox_value = R"doc()doc";
 
+static const char *__doc_nanogui_TextMetricsCache =
+R"doc(Least recently used cache of text bounds and glyph positions.
+
+Measuring a string with NanoVG runs the font shaper over the complete
+string, and widgets do so on every layout and often on every frame,
+although their text rarely changes. Every Screen owns a cache for its
+NanoVG context, which is used by the free functions textBounds(),
+textBoxBounds() and textGlyphPositions().
+
+Entries are keyed on the font face, font size, alignment, line height,
+wrap width and the string itself. Measurements are performed at the
+origin and translated to the requested position.
+
+The cache is thread-safe, which allows Screen::setParallelLayout().
+Text is measured with private NanoVG contexts that have no renderer and
+only contain the fonts registered with addFont() (the Theme registers
+its fonts automatically). Each thread that measures text concurrently
+uses a context of its own, hence misses are neither serialized nor do
+they touch the state of the context that draws the user interface,
+which is only used for fonts that were not registered.)doc";
+
+static const char *__doc_nanogui_TextMetricsCache_TextMetricsCache = R"doc(Create a cache that holds up to ``capacity`` measurements)doc";
+
+static const char *__doc_nanogui_TextMetricsCache_addFont =
+R"doc(Register font data for measurements
+
+The data (e.g. the contents of a TrueType file) must remain valid for
+the lifetime of the cache. Fonts that are created directly with
+``nvgCreateFont()`` and not registered here are measured through the
+NanoVG context passed to the measurement functions, one at a time.)doc";
+
+static const char *__doc_nanogui_TextMetricsCache_capacity = R"doc(Return the maximum number of cached measurements)doc";
+
+static const char *__doc_nanogui_TextMetricsCache_clear = R"doc(Discard all cached measurements (e.g. after fonts or the pixel ratio changed))doc";
+
+static const char *__doc_nanogui_TextMetricsCache_find = R"doc(Return the cache that is registered for a NanoVG context (if any))doc";
+
+static const char *__doc_nanogui_TextMetricsCache_hits = R"doc(Return the number of measurements that were answered from the cache)doc";
+
+static const char *__doc_nanogui_TextMetricsCache_misses = R"doc(Return the number of measurements that had to be performed by NanoVG)doc";
+
+static const char *__doc_nanogui_TextMetricsCache_pixelRatio = R"doc(Return the ratio of framebuffer to window pixels at which text is measured)doc";
+
+static const char *__doc_nanogui_TextMetricsCache_registerCache = R"doc(Register the cache for a NanoVG context (``nullptr`` unregisters it))doc";
+
+static const char *__doc_nanogui_TextMetricsCache_resetStatistics = R"doc(Reset the hit and miss counters)doc";
+
+static const char *__doc_nanogui_TextMetricsCache_setCapacity = R"doc(Set the maximum number of cached measurements (evicts the oldest ones))doc";
+
+static const char *__doc_nanogui_TextMetricsCache_setPixelRatio = R"doc(Set the ratio of framebuffer to window pixels at which text is measured (clears the cache if it changes))doc";
+
+static const char *__doc_nanogui_TextMetricsCache_size = R"doc(Return the number of cached measurements)doc";
+
+static const char *__doc_nanogui_TextMetricsCache_textBounds = R"doc(Cached equivalent of ``nvgTextBounds()``)doc";
+
+static const char *__doc_nanogui_TextMetricsCache_textBoxBounds = R"doc(Cached equivalent of ``nvgTextBoxBounds()``)doc";
+
+static const char *__doc_nanogui_TextMetricsCache_textGlyphPositions = R"doc(Cached equivalent of ``nvgTextGlyphPositions()``)doc";
+
 static const char *__doc_nanogui_Theme = R"doc(Storage class for basic theme-related properties.)doc";
 
 static const char *__doc_nanogui_Theme_Theme = R"doc()doc";
@@ -3514,6 +4185,44 @@ static const char *__doc_nanogui_Theme_operator_new_4 = R"doc()doc";
 
 static const char *__doc_nanogui_Theme_operator_new_5 = R"doc()doc";
 
+static const char *__doc_nanogui_ThreadPool =
+R"doc(Executes the iterations of loops on a fixed set of worker threads.
+
+Iterations are claimed one at a time by the calling thread and all idle
+workers, which balances loops whose iterations differ greatly in cost
+(e.g. the layouts of windows with few and many widgets). Loops may be
+nested: idle workers pick up the iterations of the most recently
+started loop first. This is used by Screen::setParallelLayout().)doc";
+
+static const char *__doc_nanogui_ThreadPool_ThreadPool = R"doc(Create a pool with the given number of worker threads (0: run everything on the caller))doc";
+
+static const char *__doc_nanogui_ThreadPool_parallelFor =
+R"doc(Invoke ``func(i)`` for every ``i`` in ``[0, count)``
+
+The calling thread participates and the function returns once all
+iterations have completed. If iterations throw, the first exception is
+rethrown after the remaining iterations have completed.)doc";
+
+static const char *__doc_nanogui_ThreadPool_shared = R"doc(Return the pool shared by NanoGUI (one worker per additional CPU core))doc";
+
+static const char *__doc_nanogui_ThreadPool_threadCount = R"doc(Return the number of worker threads)doc";
+
+static const char *__doc_nanogui_TiledImageSource = R"doc(Image that is divided into a pyramid of square RGBA8 tiles.)doc";
+
+static const char *__doc_nanogui_TiledImageSource_TiledImageSource = R"doc(Create a source of the given size whose tiles are provided by a callback)doc";
+
+static const char *__doc_nanogui_TiledImageSource_levelCount = R"doc(Return the number of levels of the pyramid)doc";
+
+static const char *__doc_nanogui_TiledImageSource_levelSize = R"doc(Return the size of the image at the given level)doc";
+
+static const char *__doc_nanogui_TiledImageSource_size = R"doc(Return the size of the image at full resolution)doc";
+
+static const char *__doc_nanogui_TiledImageSource_tileBytes = R"doc(Return the number of bytes of a tile)doc";
+
+static const char *__doc_nanogui_TiledImageSource_tileCount = R"doc(Return the number of tiles along each axis at the given level)doc";
+
+static const char *__doc_nanogui_TiledImageSource_tileSize = R"doc(Return the width and height of the tiles in pixels)doc";
+
 static const char *__doc_nanogui_ToolButton = R"doc(Simple radio+toggle button with an icon.)doc";
 
 static const char *__doc_nanogui_ToolButton_ToolButton = R"doc()doc";
@@ -3610,6 +4319,61 @@ static const char *__doc_nanogui_VScrollPanel_setScroll =
 R"doc(Set the scroll amount to a value between 0 and 1. 0 means scrolled to
 the top and 1 to the bottom.)doc";
 
+static const char *__doc_nanogui_VirtualList =
+R"doc(Scrollable list of uniformly sized rows for very large item counts.
+
+Unlike a VScrollPanel around a long list of widgets, the list only knows
+the number of items and obtains their contents from a callback. It
+creates just enough row widgets to cover the visible area and rebinds
+them to other items while scrolling, so memory usage and frame time do
+not depend on the number of items.)doc";
+
+static const char *__doc_nanogui_VirtualList_VirtualList = R"doc()doc";
+
+static const char *__doc_nanogui_VirtualList_callback = R"doc(Return the callback that is invoked when the user selects an item)doc";
+
+static const char *__doc_nanogui_VirtualList_itemAt = R"doc(Return the index of the item at a vertical position relative to the list, or -1)doc";
+
+static const char *__doc_nanogui_VirtualList_itemCount = R"doc(Return the number of items)doc";
+
+static const char *__doc_nanogui_VirtualList_refresh = R"doc(Bind all rows again, e.g. after the contents of the items changed)doc";
+
+static const char *__doc_nanogui_VirtualList_rowBinder = R"doc(Return the callback that fills a row widget with the contents of an item)doc";
+
+static const char *__doc_nanogui_VirtualList_rowCount = R"doc(Return the number of row widgets that currently exist)doc";
+
+static const char *__doc_nanogui_VirtualList_rowFactory = R"doc(Return the callback that creates a new row widget)doc";
+
+static const char *__doc_nanogui_VirtualList_rowHeight = R"doc(Return the height of each row in pixels)doc";
+
+static const char *__doc_nanogui_VirtualList_scroll = R"doc(Return the current scroll amount as a value between 0 and 1. 0 means scrolled to the top and 1 to the bottom.)doc";
+
+static const char *__doc_nanogui_VirtualList_scrollToItem = R"doc(Scroll by the smallest amount that makes an item completely visible)doc";
+
+static const char *__doc_nanogui_VirtualList_selectedIndex = R"doc(Return the index of the selected item, or -1 if none is selected)doc";
+
+static const char *__doc_nanogui_VirtualList_setCallback = R"doc(Set the callback that is invoked when the user selects an item)doc";
+
+static const char *__doc_nanogui_VirtualList_setItemCount = R"doc(Set the number of items (rebinds all visible rows))doc";
+
+static const char *__doc_nanogui_VirtualList_setRowBinder = R"doc(Set the callback that fills a row widget with the contents of an item)doc";
+
+static const char *__doc_nanogui_VirtualList_setRowFactory =
+R"doc(Set the callback that creates a new row widget
+
+The callback receives the list and must return a new widget that has
+the list as its parent. The list takes care of its position and size.)doc";
+
+static const char *__doc_nanogui_VirtualList_setRowHeight = R"doc(Set the height of each row in pixels)doc";
+
+static const char *__doc_nanogui_VirtualList_setScroll = R"doc(Set the scroll amount to a value between 0 and 1. 0 means scrolled to the top and 1 to the bottom.)doc";
+
+static const char *__doc_nanogui_VirtualList_setSelectedIndex = R"doc(Select an item (-1 clears the selection), without invoking the callback)doc";
+
+static const char *__doc_nanogui_VirtualList_setTextCallback = R"doc(Set the callback that provides the text of an item (used by the default rows))doc";
+
+static const char *__doc_nanogui_VirtualList_textCallback = R"doc(Return the callback that provides the text of an item (used by the default rows))doc";
+
 static const char *__doc_nanogui_Widget =
 R"doc(Base class of all widgets.
 
@@ -3617,6 +4381,14 @@ Widget is the base class of all widgets in ``nanogui``. It can also be
 used as an panel to arrange an arbitrary number of child widgets using
 a layout generator (see Layout).)doc";
 
+static const char *__doc_nanogui_WidgetClassStats = R"doc(Accumulated draw statistics of all widgets of one class.)doc";
+
+static const char *__doc_nanogui_WidgetClassStats_calls = R"doc(Number of Widget::draw() calls)doc";
+
+static const char *__doc_nanogui_WidgetClassStats_name = R"doc(Class name)doc";
+
+static const char *__doc_nanogui_WidgetClassStats_time = R"doc(Time spent in Widget::draw() in milliseconds, excluding child widgets)doc";
+
 static const char *__doc_nanogui_Widget_Widget = R"doc(Construct a new widget with the given parent widget)doc";
 
 static const char *__doc_nanogui_Widget_absolutePosition = R"doc(Return the absolute position on screen)doc";
@@ -3632,6 +4404,25 @@ parent)doc";
 
 static const char *__doc_nanogui_Widget_addChild_2 = R"doc(Convenience function which appends a widget at the end)doc";
 
+static const char *__doc_nanogui_Widget_cacheMode = R"doc(Return how the drawing output of this widget and its children is cached)doc";
+
+static const char *__doc_nanogui_Widget_cachePreferredSizes =
+R"doc(Compute the preferred sizes of several widgets ahead of time
+
+During a parallel layout (see Screen::setParallelLayout()), the
+widgets are measured concurrently and the results are memoized for
+cachedPreferredSize(). Does nothing otherwise. The widgets must not be
+ancestors of each other.)doc";
+
+static const char *__doc_nanogui_Widget_cachedPreferredSize =
+R"doc(Return the preferred size, computing it only if necessary
+
+The result of preferredSize() is memoized until the layout of this
+widget or one of its descendants is invalidated (see
+invalidateLayout()). Layouts use this function to query the sizes of
+child widgets, so that each widget is measured once per change rather
+than once per ancestor.)doc";
+
 static const char *__doc_nanogui_Widget_childAt = R"doc(Retrieves the child at the specific position)doc";
 
 static const char *__doc_nanogui_Widget_childAt_2 = R"doc(Retrieves the child at the specific position)doc";
@@ -3642,12 +4433,18 @@ static const char *__doc_nanogui_Widget_childIndex = R"doc(Returns the index of
 
 static const char *__doc_nanogui_Widget_children = R"doc(Return the list of child widgets of the current widget)doc";
 
+static const char *__doc_nanogui_Widget_clearDirty = R"doc(Reset the dirty flag of this widget and all dirty children)doc";
+
 static const char *__doc_nanogui_Widget_contains = R"doc(Check if the widget contains a certain position)doc";
 
 static const char *__doc_nanogui_Widget_cursor = R"doc(Return a pointer to the cursor of the widget)doc";
 
+static const char *__doc_nanogui_Widget_dirty = R"doc(Return whether this widget (or one of its children) must be redrawn)doc";
+
 static const char *__doc_nanogui_Widget_draw = R"doc(Draw the widget (and all child widgets))doc";
 
+static const char *__doc_nanogui_Widget_drawCached = R"doc(Draw the widget by replaying (or recording) its DrawCache)doc";
+
 static const char *__doc_nanogui_Widget_enabled = R"doc(Return whether or not this widget is currently enabled)doc";
 
 static const char *__doc_nanogui_Widget_findWidget = R"doc(Determine the widget located at the given position value (recursive))doc";
@@ -3688,6 +4485,18 @@ Remark:
 
 static const char *__doc_nanogui_Widget_id = R"doc(Return the ID value associated with this widget, if any)doc";
 
+static const char *__doc_nanogui_Widget_invalidateLayout =
+R"doc(Discard the cached layout information of this widget and its ancestors
+
+The setters that affect the preferred size of a widget (e.g. its
+caption, font, font size, theme, fixed size, visibility or children) do
+this automatically, and so do the setters of Layout (for all widgets
+using the layout). Call it after changing something that affects the
+preferred size or layout of the widget by other means. Unlike
+markDirty(), purely visual changes don't require it.)doc";
+
+static const char *__doc_nanogui_Widget_invalidateParentIndex = R"doc(Tell the parent that the bounds of this widget changed (see setSpatialIndex()))doc";
+
 static const char *__doc_nanogui_Widget_keyboardCharacterEvent = R"doc(Handle text input (UTF-32 format) (default implementation: do nothing))doc";
 
 static const char *__doc_nanogui_Widget_keyboardEvent = R"doc(Handle a keyboard event (default implementation: do nothing))doc";
@@ -3698,10 +4507,18 @@ static const char *__doc_nanogui_Widget_layout_2 = R"doc(Return the used Layout
 
 static const char *__doc_nanogui_Widget_load = R"doc(Restore the state of the widget from the given Serializer instance)doc";
 
+static const char *__doc_nanogui_Widget_mCacheMode = R"doc(Caching strategy for the drawing output (see setCacheMode()))doc";
+
 static const char *__doc_nanogui_Widget_mChildren = R"doc()doc";
 
+static const char *__doc_nanogui_Widget_mCulled = R"doc(Set by the Screen while drawing to skip subtrees outside of the redrawn region)doc";
+
 static const char *__doc_nanogui_Widget_mCursor = R"doc()doc";
 
+static const char *__doc_nanogui_Widget_mDirty = R"doc(Whether this widget or one of its children must be redrawn (see markDirty()))doc";
+
+static const char *__doc_nanogui_Widget_mDrawCache = R"doc(Recorded drawing output of this widget and its children)doc";
+
 static const char *__doc_nanogui_Widget_mEnabled =
 R"doc(Whether or not this Widget is currently enabled. Various different
 kinds of derived types use this to determine whether or not user input
@@ -3750,14 +4567,24 @@ static const char *__doc_nanogui_Widget_mId = R"doc()doc";
 
 static const char *__doc_nanogui_Widget_mLayout = R"doc()doc";
 
+static const char *__doc_nanogui_Widget_mLayoutValid = R"doc(Whether the children are placed according to the current state (see performLayoutIfNeeded()))doc";
+
 static const char *__doc_nanogui_Widget_mMouseFocus = R"doc()doc";
 
 static const char *__doc_nanogui_Widget_mParent = R"doc()doc";
 
 static const char *__doc_nanogui_Widget_mPos = R"doc()doc";
 
+static const char *__doc_nanogui_Widget_mPreferredSize = R"doc(Memoized result of preferredSize() (see cachedPreferredSize()))doc";
+
+static const char *__doc_nanogui_Widget_mPreferredSizeValid = R"doc(Whether mPreferredSize is up to date)doc";
+
 static const char *__doc_nanogui_Widget_mSize = R"doc()doc";
 
+static const char *__doc_nanogui_Widget_mSpatialIndex = R"doc(Acceleration structure for hit tests (see setSpatialIndex()))doc";
+
+static const char *__doc_nanogui_Widget_mSpatialIndexValid = R"doc(Whether mSpatialIndex reflects the current children and their bounds)doc";
+
 static const char *__doc_nanogui_Widget_mTheme = R"doc()doc";
 
 static const char *__doc_nanogui_Widget_mTooltip = R"doc()doc";
@@ -3766,6 +4593,20 @@ static const char *__doc_nanogui_Widget_mVisible =
 R"doc(Whether or not this Widget is currently visible. When a Widget is not
 currently visible, no time is wasted executing its drawing method.)doc";
 
+static const char *__doc_nanogui_Widget_markDirty =
+R"doc(Flag this widget as requiring a redraw
+
+The flag propagates to all parent widgets up to the Screen, which
+skips rendering entirely (see Screen::drawAll()) as long as no widget
+in its hierarchy is dirty. The widget's current bounds are also
+reported to the screen as a damaged region, which is used for partial
+redraws (see Screen::setPartialRedraw()). The cached layout information
+is left untouched, so that e.g. hovering over a widget does not cause
+its ancestors to be measured again; changes that affect the size of the
+widget must call invalidateLayout() as well. The setters of Widget and
+its subclasses call this function automatically; custom widgets should
+call it whenever their visual state changes.)doc";
+
 static const char *__doc_nanogui_Widget_mouseButtonEvent =
 R"doc(Handle a mouse button event (default implementation: propagate to
 children))doc";
@@ -3804,6 +4645,8 @@ static const char *__doc_nanogui_Widget_operator_new_4 = R"doc()doc";
 
 static const char *__doc_nanogui_Widget_operator_new_5 = R"doc()doc";
 
+static const char *__doc_nanogui_Widget_parallelLayoutActive = R"doc(Return whether a parallel layout is in progress (see Screen::setParallelLayout()))doc";
+
 static const char *__doc_nanogui_Widget_parent = R"doc(Return the parent widget)doc";
 
 static const char *__doc_nanogui_Widget_parent_2 = R"doc(Return the parent widget)doc";
@@ -3812,6 +4655,19 @@ static const char *__doc_nanogui_Widget_performLayout =
 R"doc(Invoke the associated layout generator to properly place child
 widgets, if any)doc";
 
+static const char *__doc_nanogui_Widget_performLayoutIfNeeded =
+R"doc(Invoke performLayout() unless nothing changed since the last time
+
+Layouts use this function for child widgets, hence an explicit call to
+performLayout() only revisits the subtrees that were invalidated.)doc";
+
+static const char *__doc_nanogui_Widget_performLayouts =
+R"doc(Invoke performLayoutIfNeeded() on several widgets
+
+During a parallel layout (see Screen::setParallelLayout()), the
+widgets are laid out concurrently. The widgets must not be ancestors
+of each other.)doc";
+
 static const char *__doc_nanogui_Widget_position = R"doc(Return the position relative to the parent widget)doc";
 
 static const char *__doc_nanogui_Widget_preferredSize = R"doc(Compute the preferred size of the widget)doc";
@@ -3822,14 +4678,35 @@ static const char *__doc_nanogui_Widget_removeChild_2 = R"doc(Remove a child wid
 
 static const char *__doc_nanogui_Widget_requestFocus = R"doc(Request the focus to be moved to this widget)doc";
 
+static const char *__doc_nanogui_Widget_sParallelLayout = R"doc(Whether a parallel layout is in progress (see Screen::setParallelLayout()))doc";
+
 static const char *__doc_nanogui_Widget_save = R"doc(Save the state of the widget into the given Serializer instance)doc";
 
+static const char *__doc_nanogui_Widget_scheduleRedrawAt =
+R"doc(Mark this widget as dirty at a later point in time
+
+``time`` is specified in seconds on the ``glfwGetTime()`` clock. This
+is meant for widgets whose appearance changes after a delay (e.g. a
+notification that expires), and allows mainloop() to sleep until
+then. Has no effect if the widget is not attached to a Screen. For
+continuous animations, see Screen::requestAnimationFrame().)doc";
+
 static const char *__doc_nanogui_Widget_screen = R"doc(Walk up the hierarchy and return the parent screen)doc";
 
 static const char *__doc_nanogui_Widget_scrollEvent =
 R"doc(Handle a mouse scroll event (default implementation: propagate to
 children))doc";
 
+static const char *__doc_nanogui_Widget_setCacheMode =
+R"doc(Set how the drawing output of this widget and its children is cached
+
+With CacheMode::Retained, the tessellated NanoVG output of the whole
+subtree is recorded once (see DrawCache) and replayed in subsequent
+frames until markDirty() is called on any widget of the subtree, or
+until the subtree is moved or clipped differently. This is meant for
+large static panels; subtrees that issue OpenGL calls of their own
+(e.g. GLCanvas) are always drawn from scratch.)doc";
+
 static const char *__doc_nanogui_Widget_setCursor = R"doc(Set the cursor of the widget)doc";
 
 static const char *__doc_nanogui_Widget_setEnabled = R"doc(Set whether or not this widget is currently enabled)doc";
@@ -3867,6 +4744,16 @@ static const char *__doc_nanogui_Widget_setPosition = R"doc(Set the position rel
 
 static const char *__doc_nanogui_Widget_setSize = R"doc(set the size of the widget)doc";
 
+static const char *__doc_nanogui_Widget_setSpatialIndex =
+R"doc(Accelerate hit tests against the children of this widget
+
+When enabled, findWidget() and the default mouse event handlers look
+up the children under the cursor in a SpatialIndex instead of testing
+every child. The index is rebuilt lazily on the next hit test after
+children were added, removed, moved or resized (e.g. by
+performLayout()). This pays off for containers with hundreds of
+children or more.)doc";
+
 static const char *__doc_nanogui_Widget_setTheme = R"doc(Set the Theme used to draw this widget)doc";
 
 static const char *__doc_nanogui_Widget_setTooltip = R"doc()doc";
@@ -3879,12 +4766,16 @@ static const char *__doc_nanogui_Widget_setWidth = R"doc(Set the width of the wi
 
 static const char *__doc_nanogui_Widget_size = R"doc(Return the size of the widget)doc";
 
+static const char *__doc_nanogui_Widget_spatialIndex = R"doc(Return whether hit tests against the children use a SpatialIndex)doc";
+
 static const char *__doc_nanogui_Widget_theme = R"doc(Return the Theme used to draw this widget)doc";
 
 static const char *__doc_nanogui_Widget_theme_2 = R"doc(Return the Theme used to draw this widget)doc";
 
 static const char *__doc_nanogui_Widget_tooltip = R"doc()doc";
 
+static const char *__doc_nanogui_Widget_updateSpatialIndex = R"doc(Return the up-to-date spatial index over the children, if enabled)doc";
+
 static const char *__doc_nanogui_Widget_visible =
 R"doc(Return whether or not the widget is currently visible (assuming all
 parents are visible))doc";
@@ -3905,16 +4796,32 @@ static const char *__doc_nanogui_Window_buttonPanel = R"doc(Return the panel use
 
 static const char *__doc_nanogui_Window_center = R"doc(Center the window in the current Screen)doc";
 
+static const char *__doc_nanogui_Window_clearDirty = R"doc(Invalidate the cached layer when anything in the window changed)doc";
+
 static const char *__doc_nanogui_Window_dispose = R"doc(Dispose the window)doc";
 
 static const char *__doc_nanogui_Window_draw = R"doc(Draw the window)doc";
 
+static const char *__doc_nanogui_Window_layerCaching = R"doc(Return whether the window is cached in an offscreen layer)doc";
+
 static const char *__doc_nanogui_Window_load = R"doc()doc";
 
 static const char *__doc_nanogui_Window_mButtonPanel = R"doc()doc";
 
 static const char *__doc_nanogui_Window_mDrag = R"doc()doc";
 
+static const char *__doc_nanogui_Window_mDrawingLayer = R"doc()doc";
+
+static const char *__doc_nanogui_Window_mLayer = R"doc()doc";
+
+static const char *__doc_nanogui_Window_mLayerCaching = R"doc()doc";
+
+static const char *__doc_nanogui_Window_mLayerPixelRatio = R"doc()doc";
+
+static const char *__doc_nanogui_Window_mLayerSize = R"doc()doc";
+
+static const char *__doc_nanogui_Window_mLayerValid = R"doc()doc";
+
 static const char *__doc_nanogui_Window_mModal = R"doc()doc";
 
 static const char *__doc_nanogui_Window_mTitle = R"doc()doc";
@@ -3967,12 +4874,25 @@ static const char *__doc_nanogui_Window_scrollEvent =
 R"doc(Accept scroll events and propagate them to the widget under the mouse
 cursor)doc";
 
+static const char *__doc_nanogui_Window_setLayerCaching =
+R"doc(Enable caching the window in an offscreen layer
+
+When enabled, the window and its children are rendered into a texture
+at the resolution given by Screen::pixelRatio(), which is then
+composited as a single textured quad. The layer is only rendered again
+once a widget of the window has been marked as dirty (see
+Widget::markDirty()), hence dragging the window around does not redraw
+any of its children. Windows containing widgets that issue OpenGL
+calls of their own (e.g. GLCanvas) should not enable this.)doc";
+
 static const char *__doc_nanogui_Window_setModal = R"doc(Set whether or not this is a modal dialog)doc";
 
 static const char *__doc_nanogui_Window_setTitle = R"doc(Set the window title)doc";
 
 static const char *__doc_nanogui_Window_title = R"doc(Return the window title)doc";
 
+static const char *__doc_nanogui_Window_updateLayer = R"doc(Render the cached layer if it is out of date (called by Screen before each frame))doc";
+
 static const char *__doc_nanogui_active = R"doc(Return whether or not a main loop is currently active)doc";
 
 static const char *__doc_nanogui_chdir_to_bundle_parent =
@@ -4196,9 +5116,15 @@ static const char *__doc_nanogui_leave =
 R"doc(Request the application main loop to terminate (e.g. if you detached
 mainloop).)doc";
 
+static const char *__doc_nanogui_listImageDirectory = R"doc(Return the paths of the PNG images in a directory)doc";
+
 static const char *__doc_nanogui_loadImageDirectory =
 R"doc(Load a directory of PNG images and upload them to the GPU (suitable
-for use with ImagePanel))doc";
+for use with ImagePanel)
+
+All images are decoded on the calling thread before the function
+returns. See ImagePanel::loadDirectory() for asynchronous loading of
+thumbnails.)doc";
 
 static const char *__doc_nanogui_lookAt =
 R"doc(Creates a "look at" matrix that describes the position and orientation
@@ -4225,9 +5151,15 @@ R"doc(Enter the application main loop
 
 Parameter ``refresh``:
     NanoGUI issues a redraw call whenever an keyboard/mouse/.. event
-    is received. In the absence of any external events, it enforces a
-    redraw once every ``refresh`` milliseconds. To disable the refresh
-    timer, specify a negative value here.
+    is received, a widget is dirty (see Widget::markDirty()), an
+    animation frame was requested (see Screen::requestAnimationFrame())
+    or a scheduled redraw is due (see Widget::scheduleRedrawAt()).
+    Animations are drawn at the refresh rate of the display, and the
+    loop sleeps while there is nothing to do. Screens without any dirty
+    widgets are not redrawn. When ``refresh`` is positive, the loop
+    additionally wakes up at least once every ``refresh`` milliseconds,
+    which supports applications that modify the user interface from
+    other threads without calling ``glfwPostEmptyEvent()``.
 
 Parameter ``detach``:
     This parameter only exists in the Python bindings. When the active
@@ -4399,6 +5331,18 @@ Parameter ``v``:
 
 static const char *__doc_nanogui_shutdown = R"doc(Static shutdown; should be called before the application terminates.)doc";
 
+static const char *__doc_nanogui_textBounds =
+R"doc(Measure a single line of text like ``nvgTextBounds()``
+
+The font state is specified explicitly, and the state of the NanoVG
+context is left unchanged. Uses the TextMetricsCache of the Screen
+that owns ``ctx`` when there is one. Returns the horizontal advance
+and optionally stores ``[xmin, ymin, xmax, ymax]`` in ``bounds``.)doc";
+
+static const char *__doc_nanogui_textBoxBounds = R"doc(Measure a text box like ``nvgTextBoxBounds()`` (see textBounds()))doc";
+
+static const char *__doc_nanogui_textGlyphPositions = R"doc(Compute glyph positions like ``nvgTextGlyphPositions()`` (see textBounds()))doc";
+
 static const char *__doc_nanogui_translate =
 R"doc(Construct homogeneous coordinate translation matrix
 
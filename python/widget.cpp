@@ -62,7 +62,11 @@ void register_widget(py::module &m) {
         .def("hasFontSize", &Widget::hasFontSize, D(Widget, hasFontSize))
         .def("cursor", &Widget::cursor, D(Widget, cursor))
         .def("setCursor", &Widget::setCursor, D(Widget, setCursor))
+        .def("cacheMode", &Widget::cacheMode, D(Widget, cacheMode))
+        .def("setCacheMode", &Widget::setCacheMode, D(Widget, setCacheMode))
         .def("findWidget", &Widget::findWidget, D(Widget, findWidget))
+        .def("spatialIndex", &Widget::spatialIndex, D(Widget, spatialIndex))
+        .def("setSpatialIndex", &Widget::setSpatialIndex, D(Widget, setSpatialIndex))
         .def("contains", &Widget::contains, D(Widget, contains))
         .def("mouseButtonEvent", &Widget::mouseButtonEvent, py::arg("p"), py::arg("button"),
              py::arg("down"), py::arg("modifiers"), D(Widget, mouseButtonEvent))
@@ -81,7 +85,13 @@ void register_widget(py::module &m) {
              D(Widget, keyboardCharacterEvent))
         .def("preferredSize", &Widget::preferredSize, D(Widget, preferredSize))
         .def("performLayout", &Widget::performLayout, D(Widget, performLayout))
-        .def("draw", &Widget::draw, D(Widget, draw));
+        .def("cachedPreferredSize", &Widget::cachedPreferredSize, D(Widget, cachedPreferredSize))
+        .def("performLayoutIfNeeded", &Widget::performLayoutIfNeeded, D(Widget, performLayoutIfNeeded))
+        .def("invalidateLayout", &Widget::invalidateLayout, D(Widget, invalidateLayout))
+        .def("draw", &Widget::draw, D(Widget, draw))
+        .def("markDirty", &Widget::markDirty, D(Widget, markDirty))
+        .def("scheduleRedrawAt", &Widget::scheduleRedrawAt, D(Widget, scheduleRedrawAt))
+        .def("dirty", &Widget::dirty, D(Widget, dirty));
 
     py::class_<Window, Widget, ref<Window>, PyWindow>(m, "Window", D(Window))
         .def(py::init<Widget *, const std::string>(), py::arg("parent"),
@@ -92,22 +102,64 @@ void register_widget(py::module &m) {
         .def("setModal", &Window::setModal, D(Window, setModal))
         .def("dispose", &Window::dispose, D(Window, dispose))
         .def("buttonPanel", &Window::buttonPanel, D(Window, buttonPanel))
-        .def("center", &Window::center, D(Window, center));
+        .def("center", &Window::center, D(Window, center))
+        .def("layerCaching", &Window::layerCaching, D(Window, layerCaching))
+        .def("setLayerCaching", &Window::setLayerCaching, D(Window, setLayerCaching));
 
     py::class_<Screen, Widget, ref<Screen>, PyScreen>(m, "Screen", D(Screen))
         .def(py::init<const Vector2i &, const std::string &, bool, bool, int, int, int, int, int, unsigned int, unsigned int>(),
             py::arg("size"), py::arg("caption"), py::arg("resizable") = true, py::arg("fullscreen") = false,
             py::arg("colorBits") = 8, py::arg("alphaBits") = 8, py::arg("depthBits") = 24, py::arg("stencilBits") = 8,
             py::arg("nSamples") = 0, py::arg("glMajor") = 3, py::arg("glMinor") = 3, D(Screen, Screen))
+        .def(py::init<>(), D(Screen, Screen, 2))
+        .def("initializeHeadless", &Screen::initializeHeadless, py::arg("size"),
+             py::arg("pixelRatio") = 1.f, D(Screen, initializeHeadless))
+        .def("headless", &Screen::headless, D(Screen, headless))
+        .def("framebufferSize", &Screen::framebufferSize, D(Screen, framebufferSize))
+        .def("readPixels", [](Screen &screen) {
+            std::vector<uint8_t> pixels = screen.readPixels();
+            return py::bytes((const char *) pixels.data(), pixels.size());
+        }, D(Screen, readPixels))
+        .def("cursorPosCallbackEvent", &Screen::cursorPosCallbackEvent)
+        .def("mouseButtonCallbackEvent", &Screen::mouseButtonCallbackEvent)
+        .def("keyCallbackEvent", &Screen::keyCallbackEvent)
+        .def("charCallbackEvent", &Screen::charCallbackEvent)
+        .def("scrollCallbackEvent", &Screen::scrollCallbackEvent)
+        .def("resizeCallbackEvent", &Screen::resizeCallbackEvent)
         .def("caption", &Screen::caption, D(Screen, caption))
         .def("setCaption", &Screen::setCaption, D(Screen, setCaption))
         .def("background", &Screen::background, D(Screen, background))
         .def("setBackground", &Screen::setBackground, D(Screen, setBackground))
         .def("setVisible", &Screen::setVisible, D(Screen, setVisible))
         .def("setSize", &Screen::setSize, D(Screen, setSize))
-        .def("performLayout", (void(Screen::*)(void)) &Screen::performLayout, D(Screen, performLayout))
+        .def("performLayout", [](Screen &screen) {
+                /* Worker threads acquire the GIL to look up Python overrides */
+                if (screen.parallelLayout()) {
+                    py::gil_scoped_release release;
+                    screen.performLayout();
+                } else {
+                    screen.performLayout();
+                }
+             }, D(Screen, performLayout))
         .def("drawAll", &Screen::drawAll, D(Screen, drawAll))
         .def("drawContents", &Screen::drawContents, D(Screen, drawContents))
+        .def("skippedFrames", &Screen::skippedFrames, D(Screen, skippedFrames))
+        .def("requestAnimationFrame", &Screen::requestAnimationFrame, D(Screen, requestAnimationFrame))
+        .def("cancelAnimationFrame", &Screen::cancelAnimationFrame, D(Screen, cancelAnimationFrame))
+        .def("scheduleRedraw", &Screen::scheduleRedraw, D(Screen, scheduleRedraw))
+        .def("nextFrameTime", &Screen::nextFrameTime, D(Screen, nextFrameTime))
+        .def("partialRedraw", &Screen::partialRedraw, D(Screen, partialRedraw))
+        .def("setPartialRedraw", &Screen::setPartialRedraw, D(Screen, setPartialRedraw))
+        .def("profiling", &Screen::profiling, D(Screen, profiling))
+        .def("setProfiling", &Screen::setProfiling, D(Screen, setProfiling))
+        .def("profiler", &Screen::profiler, D(Screen, profiler),
+             py::return_value_policy::reference_internal)
+        .def("profilerOverlay", &Screen::profilerOverlay, D(Screen, profilerOverlay))
+        .def("textMetrics", &Screen::textMetrics, D(Screen, textMetrics),
+             py::return_value_policy::reference_internal)
+        .def("parallelLayout", &Screen::parallelLayout, D(Screen, parallelLayout))
+        .def("setParallelLayout", &Screen::setParallelLayout, D(Screen, setParallelLayout))
+        .def("setProfilerOverlay", &Screen::setProfilerOverlay, D(Screen, setProfilerOverlay))
         .def("resizeEvent", &Screen::resizeEvent, py::arg("size"), D(Screen, resizeEvent))
         .def("resizeCallback", &Screen::resizeCallback)
         .def("setResizeCallback", &Screen::setResizeCallback)
@@ -12,6 +12,7 @@
 #include <nanogui/button.h>
 #include <nanogui/theme.h>
 #include <nanogui/opengl.h>
+#include <nanogui/textmetrics.h>
 #include <nanogui/serializer/core.h>
 
 NAMESPACE_BEGIN(nanogui)
@@ -24,18 +25,15 @@ Button::Button(Widget *parent, const std::string &caption, int icon)
 
 Vector2i Button::preferredSize(NVGcontext *ctx) const {
     int fontSize = mFontSize == -1 ? mTheme->mButtonFontSize : mFontSize;
-    nvgFontSize(ctx, fontSize);
-    nvgFontFace(ctx, "sans-bold");
-    float tw = nvgTextBounds(ctx, 0,0, mCaption.c_str(), nullptr, nullptr);
+    float tw = textBounds(ctx, "sans-bold", fontSize, NVG_ALIGN_LEFT | NVG_ALIGN_TOP,
+                          0, 0, mCaption);
     float iw = 0.0f, ih = fontSize;
 
     if (mIcon) {
         if (nvgIsFontIcon(mIcon)) {
             ih *= icon_scale();
-            nvgFontFace(ctx, "icons");
-            nvgFontSize(ctx, ih);
-            iw = nvgTextBounds(ctx, 0, 0, utf8(mIcon).data(), nullptr, nullptr)
-                + mSize.y() * 0.15f;
+            iw = textBounds(ctx, "icons", ih, NVG_ALIGN_LEFT | NVG_ALIGN_TOP, 0, 0,
+                            utf8(mIcon).data()) + mSize.y() * 0.15f;
         } else {
             int w, h;
             ih *= 0.9f;
@@ -155,7 +153,8 @@ void Button::draw(NVGcontext *ctx) {
     int fontSize = mFontSize == -1 ? mTheme->mButtonFontSize : mFontSize;
     nvgFontSize(ctx, fontSize);
     nvgFontFace(ctx, "sans-bold");
-    float tw = nvgTextBounds(ctx, 0,0, mCaption.c_str(), nullptr, nullptr);
+    float tw = textBounds(ctx, "sans-bold", fontSize, NVG_ALIGN_LEFT | NVG_ALIGN_TOP,
+                          0, 0, mCaption);
 
     Vector2f center = mPos.cast<float>() + mSize.cast<float>() * 0.5f;
     Vector2f textPos(center.x() - tw * 0.5f, center.y() - 1);
@@ -172,7 +171,8 @@ void Button::draw(NVGcontext *ctx) {
             ih *= icon_scale();
             nvgFontSize(ctx, ih);
             nvgFontFace(ctx, "icons");
-            iw = nvgTextBounds(ctx, 0, 0, icon.data(), nullptr, nullptr);
+            iw = textBounds(ctx, "icons", ih, NVG_ALIGN_LEFT | NVG_ALIGN_TOP, 0, 0,
+                            icon.data());
         } else {
             int w, h;
             ih *= 0.9f;
@@ -11,6 +11,7 @@
 
 #include <nanogui/checkbox.h>
 #include <nanogui/opengl.h>
+#include <nanogui/textmetrics.h>
 #include <nanogui/theme.h>
 #include <nanogui/serializer/core.h>
 
@@ -49,11 +50,9 @@ bool CheckBox::mouseButtonEvent(const Vector2i &p, int button, bool down,
 Vector2i CheckBox::preferredSize(NVGcontext *ctx) const {
     if (mFixedSize != Vector2i::Zero())
         return mFixedSize;
-    nvgFontSize(ctx, fontSize());
-    nvgFontFace(ctx, "sans");
     return Vector2i(
-        nvgTextBounds(ctx, 0, 0, mCaption.c_str(), nullptr, nullptr) +
-            1.8f * fontSize(),
+        textBounds(ctx, "sans", fontSize(), NVG_ALIGN_LEFT | NVG_ALIGN_TOP, 0, 0,
+                   mCaption) + 1.8f * fontSize(),
         fontSize() * 1.3f);
 }
 
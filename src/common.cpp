@@ -17,8 +17,8 @@
 
 #include <nanogui/opengl.h>
 #include <map>
-#include <thread>
-#include <chrono>
+#include <limits>
+#include <cmath>
 #include <iostream>
 
 #if !defined(_WIN32)
@@ -67,25 +67,17 @@ void mainloop(int refresh) {
 
     mainloop_active = true;
 
-    std::thread refresh_thread;
-    if (refresh > 0) {
-        /* If there are no mouse/keyboard events, try to refresh the
-           view roughly every 50 ms (default); this is to support animations
-           such as progress bars while keeping the system load
-           reasonably low */
-        refresh_thread = std::thread(
-            [refresh]() {
-                std::chrono::milliseconds time(refresh);
-                while (mainloop_active) {
-                    std::this_thread::sleep_for(time);
-                    glfwPostEmptyEvent();
-                }
-            }
-        );
-    }
+    /* Animation frames are paced to the refresh rate of the primary monitor */
+    double frameInterval = 1.0 / 60.0;
+    GLFWmonitor *monitor = glfwGetPrimaryMonitor();
+    const GLFWvidmode *mode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+    if (mode && mode->refreshRate > 0)
+        frameInterval = 1.0 / mode->refreshRate;
 
     try {
         while (mainloop_active) {
+            double frameStart = glfwGetTime();
+            double deadline = std::numeric_limits<double>::infinity();
             int numScreens = 0;
             for (auto kv : __nanogui_screens) {
                 Screen *screen = kv.second;
@@ -96,6 +88,7 @@ void mainloop(int refresh) {
                     continue;
                 }
                 screen->drawAll();
+                deadline = std::min(deadline, screen->nextFrameTime());
                 numScreens++;
             }
 
@@ -105,8 +98,25 @@ void mainloop(int refresh) {
                 break;
             }
 
-            /* Wait for mouse/keyboard or empty refresh events */
-            glfwWaitEvents();
+            /* Don't draw animations faster than the display can show them */
+            deadline = std::max(deadline, frameStart + frameInterval);
+
+            /* Optionally wake up periodically to support applications that
+               change the user interface without marking it as dirty */
+            if (refresh > 0)
+                deadline = std::min(deadline, frameStart + refresh / 1000.0);
+
+            /* Wait for mouse/keyboard events, empty events (see
+               glfwPostEmptyEvent()), or the next scheduled frame */
+            if (std::isinf(deadline)) {
+                glfwWaitEvents();
+            } else {
+                double timeout = deadline - glfwGetTime();
+                if (timeout > 0)
+                    glfwWaitEventsTimeout(timeout);
+                else
+                    glfwPollEvents();
+            }
         }
 
         /* Process events once more */
@@ -115,13 +125,14 @@ void mainloop(int refresh) {
         std::cerr << "Caught exception in main loop: " << e.what() << std::endl;
         leave();
     }
-
-    if (refresh > 0)
-        refresh_thread.join();
 }
 
 void leave() {
+    if (!mainloop_active)
+        return;
     mainloop_active = false;
+    /* Wake up the main loop in case it is waiting for events */
+    glfwPostEmptyEvent();
 }
 
 bool active() {
@@ -165,9 +176,8 @@ int __nanogui_get_image(NVGcontext *ctx, const std::string &name, uint8_t *data,
     return iconID;
 }
 
-std::vector<std::pair<int, std::string>>
-loadImageDirectory(NVGcontext *ctx, const std::string &path) {
-    std::vector<std::pair<int, std::string> > result;
+std::vector<std::string> listImageDirectory(const std::string &path) {
+    std::vector<std::string> result;
 #if !defined(_WIN32)
     DIR *dp = opendir(path.c_str());
     if (!dp)
@@ -186,12 +196,7 @@ loadImageDirectory(NVGcontext *ctx, const std::string &path) {
 #endif
         if (strstr(fname, "png") == nullptr)
             continue;
-        std::string fullName = path + "/" + std::string(fname);
-        int img = nvgCreateImage(ctx, fullName.c_str(), 0);
-        if (img == 0)
-            throw std::runtime_error("Could not open image data!");
-        result.push_back(
-            std::make_pair(img, fullName.substr(0, fullName.length() - 4)));
+        result.push_back(path + "/" + std::string(fname));
 #if !defined(_WIN32)
     }
     closedir(dp);
@@ -202,6 +207,19 @@ loadImageDirectory(NVGcontext *ctx, const std::string &path) {
     return result;
 }
 
+std::vector<std::pair<int, std::string>>
+loadImageDirectory(NVGcontext *ctx, const std::string &path) {
+    std::vector<std::pair<int, std::string> > result;
+    for (const std::string &fullName : listImageDirectory(path)) {
+        int img = nvgCreateImage(ctx, fullName.c_str(), 0);
+        if (img == 0)
+            throw std::runtime_error("Could not open image data!");
+        result.push_back(
+            std::make_pair(img, fullName.substr(0, fullName.length() - 4)));
+    }
+    return result;
+}
+
 std::string file_dialog(const std::vector<std::pair<std::string, std::string>> &filetypes, bool save) {
     auto result = file_dialog(filetypes, save, false);
     return result.empty() ? "" : result.front();
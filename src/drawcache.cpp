@@ -0,0 +1,245 @@
+/*
+    src/drawcache.cpp -- Recording and replay of tessellated NanoVG output
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/drawcache.h>
+#include <nanogui/opengl.h>
+#include <algorithm>
+#include <memory>
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Innermost cache that is currently recording */
+static DrawCache *activeRecorder = nullptr;
+
+/* Deep copy of the paths (and their vertices) passed to a render callback */
+struct PathData {
+    std::vector<NVGpath> paths;
+    std::vector<NVGvertex> verts;
+
+    PathData(const NVGpath *p, int npaths) : paths(p, p + npaths) {
+        size_t nverts = 0;
+        for (const NVGpath &path : paths)
+            nverts += path.nfill + path.nstroke;
+        /* Reserve up front so that the pointers below remain valid */
+        verts.reserve(nverts);
+        for (NVGpath &path : paths) {
+            NVGvertex *fill = verts.data() + verts.size();
+            verts.insert(verts.end(), path.fill, path.fill + path.nfill);
+            NVGvertex *stroke = verts.data() + verts.size();
+            verts.insert(verts.end(), path.stroke, path.stroke + path.nstroke);
+            path.fill = fill;
+            path.stroke = stroke;
+        }
+    }
+};
+
+/* Deep copy of the vertices passed to renderTriangles() */
+using VertexData = std::vector<NVGvertex>;
+
+/*
+ * Replacement render callbacks that are installed while recording. The
+ * signatures of these callbacks changed between NanoVG versions (global
+ * composite operations, fringe width for triangles), hence every hook is a
+ * function template whose matching overload gets selected when its address
+ * is assigned to the NVGparams field.
+ */
+struct DrawCacheHooks {
+    using Call = DrawCache::Call;
+
+    /* Record a call and forward it to the previously installed callback,
+       which may belong to an enclosing recording */
+    template <typename Func> static void record(int image, Call call, const Func &forward) {
+        DrawCache *rec = activeRecorder;
+        if (image != 0 && std::find(rec->mImages.begin(), rec->mImages.end(),
+                                    image) == rec->mImages.end())
+            rec->mImages.push_back(image);
+        rec->mCalls.push_back(std::move(call));
+        activeRecorder = rec->mParent;
+        forward(rec->mForward);
+        activeRecorder = rec;
+    }
+
+    template <typename Scissor>
+    static void fill(void *uptr, NVGpaint *paint, Scissor *scissor, float fringe,
+                     const float *bounds, const NVGpath *paths, int npaths) {
+        NVGpaint p = *paint; Scissor s = *scissor;
+        std::array<float, 4> b = {{ bounds[0], bounds[1], bounds[2], bounds[3] }};
+        auto data = std::make_shared<PathData>(paths, npaths);
+        record(p.image, [=](NVGparams *params) mutable {
+            params->renderFill(params->userPtr, &p, &s, fringe, b.data(),
+                               data->paths.data(), npaths);
+        }, [&](NVGparams *params) {
+            params->renderFill(uptr, paint, scissor, fringe, bounds, paths, npaths);
+        });
+    }
+
+    template <typename Op>
+    static void fill(void *uptr, NVGpaint *paint, Op op, NVGscissor *scissor,
+                     float fringe, const float *bounds, const NVGpath *paths,
+                     int npaths) {
+        NVGpaint p = *paint; NVGscissor s = *scissor;
+        std::array<float, 4> b = {{ bounds[0], bounds[1], bounds[2], bounds[3] }};
+        auto data = std::make_shared<PathData>(paths, npaths);
+        record(p.image, [=](NVGparams *params) mutable {
+            params->renderFill(params->userPtr, &p, op, &s, fringe, b.data(),
+                               data->paths.data(), npaths);
+        }, [&](NVGparams *params) {
+            params->renderFill(uptr, paint, op, scissor, fringe, bounds, paths, npaths);
+        });
+    }
+
+    template <typename Scissor>
+    static void stroke(void *uptr, NVGpaint *paint, Scissor *scissor, float fringe,
+                       float strokeWidth, const NVGpath *paths, int npaths) {
+        NVGpaint p = *paint; Scissor s = *scissor;
+        auto data = std::make_shared<PathData>(paths, npaths);
+        record(p.image, [=](NVGparams *params) mutable {
+            params->renderStroke(params->userPtr, &p, &s, fringe, strokeWidth,
+                                 data->paths.data(), npaths);
+        }, [&](NVGparams *params) {
+            params->renderStroke(uptr, paint, scissor, fringe, strokeWidth, paths, npaths);
+        });
+    }
+
+    template <typename Op>
+    static void stroke(void *uptr, NVGpaint *paint, Op op, NVGscissor *scissor,
+                       float fringe, float strokeWidth, const NVGpath *paths,
+                       int npaths) {
+        NVGpaint p = *paint; NVGscissor s = *scissor;
+        auto data = std::make_shared<PathData>(paths, npaths);
+        record(p.image, [=](NVGparams *params) mutable {
+            params->renderStroke(params->userPtr, &p, op, &s, fringe, strokeWidth,
+                                 data->paths.data(), npaths);
+        }, [&](NVGparams *params) {
+            params->renderStroke(uptr, paint, op, scissor, fringe, strokeWidth, paths, npaths);
+        });
+    }
+
+    template <typename Scissor>
+    static void triangles(void *uptr, NVGpaint *paint, Scissor *scissor,
+                          const NVGvertex *verts, int nverts) {
+        NVGpaint p = *paint; Scissor s = *scissor;
+        auto data = std::make_shared<VertexData>(verts, verts + nverts);
+        record(p.image, [=](NVGparams *params) mutable {
+            params->renderTriangles(params->userPtr, &p, &s, data->data(), nverts);
+        }, [&](NVGparams *params) {
+            params->renderTriangles(uptr, paint, scissor, verts, nverts);
+        });
+    }
+
+    template <typename Op>
+    static void triangles(void *uptr, NVGpaint *paint, Op op, NVGscissor *scissor,
+                          const NVGvertex *verts, int nverts) {
+        NVGpaint p = *paint; NVGscissor s = *scissor;
+        auto data = std::make_shared<VertexData>(verts, verts + nverts);
+        record(p.image, [=](NVGparams *params) mutable {
+            params->renderTriangles(params->userPtr, &p, op, &s, data->data(), nverts);
+        }, [&](NVGparams *params) {
+            params->renderTriangles(uptr, paint, op, scissor, verts, nverts);
+        });
+    }
+
+    template <typename Op>
+    static void triangles(void *uptr, NVGpaint *paint, Op op, NVGscissor *scissor,
+                          const NVGvertex *verts, int nverts, float fringe) {
+        NVGpaint p = *paint; NVGscissor s = *scissor;
+        auto data = std::make_shared<VertexData>(verts, verts + nverts);
+        record(p.image, [=](NVGparams *params) mutable {
+            params->renderTriangles(params->userPtr, &p, op, &s, data->data(),
+                                    nverts, fringe);
+        }, [&](NVGparams *params) {
+            params->renderTriangles(uptr, paint, op, scissor, verts, nverts, fringe);
+        });
+    }
+
+    /* Anything submitted before a flush cannot be replayed in the right
+       order relative to the OpenGL calls that follow it */
+    template <typename... Args> static void flush(void *uptr, Args... args) {
+        DrawCache *rec = activeRecorder;
+        rec->mFailed = true;
+        activeRecorder = rec->mParent;
+        rec->mForward->renderFlush(uptr, args...);
+        activeRecorder = rec;
+    }
+};
+
+DrawCache::DrawCache()
+    : mValid(false), mFailed(false), mContext(nullptr), mForward(nullptr),
+      mParent(nullptr) {
+    mKey.fill(0.f);
+}
+
+DrawCache::~DrawCache() {
+    if (mContext)
+        end();
+}
+
+void DrawCache::begin(NVGcontext *ctx, const Key &key) {
+    if (mContext)
+        throw std::runtime_error("DrawCache::begin(): already recording!");
+
+    clear();
+    mKey = key;
+    mContext = ctx;
+    mParent = activeRecorder;
+    activeRecorder = this;
+
+    NVGparams *params = nvgInternalParams(ctx);
+    mForward = new NVGparams(*params);
+    params->renderFill = &DrawCacheHooks::fill;
+    params->renderStroke = &DrawCacheHooks::stroke;
+    params->renderTriangles = &DrawCacheHooks::triangles;
+    params->renderFlush = &DrawCacheHooks::flush;
+}
+
+bool DrawCache::end() {
+    if (!mContext || activeRecorder != this)
+        throw std::runtime_error("DrawCache::end(): not the active recording!");
+
+    *nvgInternalParams(mContext) = *mForward;
+    delete mForward;
+    mForward = nullptr;
+    activeRecorder = mParent;
+    mParent = nullptr;
+    mContext = nullptr;
+
+    if (mFailed) {
+        mCalls.clear();
+        mImages.clear();
+    }
+    mValid = !mFailed;
+    return mValid;
+}
+
+bool DrawCache::replay(NVGcontext *ctx) const {
+    NVGparams *params = nvgInternalParams(ctx);
+
+    for (int image : mImages) {
+        int w, h;
+        if (!params->renderGetTextureSize(params->userPtr, image, &w, &h))
+            return false;
+    }
+
+    for (const Call &call : mCalls)
+        call(params);
+
+    return true;
+}
+
+void DrawCache::clear() {
+    mCalls.clear();
+    mImages.clear();
+    mValid = false;
+    /* A change while recording makes the recording stale right away */
+    mFailed = mContext != nullptr;
+}
+
+NAMESPACE_END(nanogui)
@@ -17,14 +17,23 @@
 #  endif
 #endif
 
+#if defined(_WIN32)
+#  include <process.h>
+#else
+#  include <unistd.h>
+#endif
+
 #include <iostream>
 #include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <chrono>
+#include <random>
 #include <Eigen/Geometry>
 
 NAMESPACE_BEGIN(nanogui)
 
-static GLuint createShader_helper(GLint type, const std::string &name,
-                                  const std::string &defines,
+static GLuint createShader_helper(GLint type, const std::string &defines,
                                   std::string shader_string) {
     if (shader_string.empty())
         return (GLuint) 0;
@@ -45,16 +54,30 @@ static GLuint createShader_helper(GLint type, const std::string &name,
         }
     }
 
+    /* The compile status is checked by checkShader_helper(), which allows
+       the driver to compile several shaders in parallel */
     GLuint id = glCreateShader(type);
     const char *shader_string_const = shader_string.c_str();
     glShaderSource(id, 1, &shader_string_const, nullptr);
     glCompileShader(id);
 
+    return id;
+}
+
+static void checkShader_helper(GLuint id, const std::string &name) {
+    if (!id)
+        return;
+
     GLint status;
     glGetShaderiv(id, GL_COMPILE_STATUS, &status);
 
     if (status != GL_TRUE) {
         char buffer[512];
+        GLint type, length = 0;
+        glGetShaderiv(id, GL_SHADER_TYPE, &type);
+        glGetShaderiv(id, GL_SHADER_SOURCE_LENGTH, &length);
+        std::vector<char> shader_string((size_t) std::max(length, 1), '\0');
+        glGetShaderSource(id, (GLsizei) shader_string.size(), nullptr, shader_string.data());
         std::cerr << "Error while compiling ";
         if (type == GL_VERTEX_SHADER)
             std::cerr << "vertex shader";
@@ -63,13 +86,200 @@ static GLuint createShader_helper(GLint type, const std::string &name,
         else if (type == GL_GEOMETRY_SHADER)
             std::cerr << "geometry shader";
         std::cerr << " \"" << name << "\":" << std::endl;
-        std::cerr << shader_string << std::endl << std::endl;
+        std::cerr << shader_string.data() << std::endl << std::endl;
         glGetShaderInfoLog(id, 512, nullptr, buffer);
         std::cerr << "Error: " << std::endl << buffer << std::endl;
         throw std::runtime_error("Shader compilation failed!");
     }
+}
 
-    return id;
+/* Directory of the program binary cache (disabled if empty) */
+static std::string binaryCacheDir;
+
+/* Magic number at the beginning of cached program binaries */
+static const char binaryCacheMagic[4] = { 'N', 'G', 'S', 'B' };
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/* FNV-1a hash of a sequence of strings */
+static uint64_t hashStrings(std::initializer_list<std::string> strings) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const std::string &str : strings) {
+        for (char c : str)
+            hash = (hash ^ (uint8_t) c) * 0x100000001b3ull;
+        hash = (hash ^ 0xFF) * 0x100000001b3ull; /* Separator */
+    }
+    return hash;
+}
+
+static std::string glString(GLenum name) {
+    const GLubyte *str = glGetString(name);
+    return str ? std::string((const char *) str) : std::string();
+}
+
+/* Try to create a program from a cached binary, return 0 on failure */
+static GLuint loadProgramBinary(const std::string &filename, uint64_t key) {
+    std::ifstream is(filename, std::ios::binary);
+    if (!is)
+        return 0;
+
+    char magic[4];
+    uint64_t storedKey;
+    GLenum format;
+    is.read(magic, sizeof(magic));
+    is.read((char *) &storedKey, sizeof(storedKey));
+    is.read((char *) &format, sizeof(format));
+    if (!is || memcmp(magic, binaryCacheMagic, sizeof(magic)) != 0 || storedKey != key)
+        return 0;
+    std::vector<char> binary((std::istreambuf_iterator<char>(is)),
+                             std::istreambuf_iterator<char>());
+    if (binary.empty())
+        return 0;
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, format, binary.data(), (GLsizei) binary.size());
+    GLint status;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        /* The driver rejected the binary (e.g. after an update) */
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+/* Store the binary of a linked program, ignoring failures */
+static void saveProgramBinary(const std::string &filename, uint64_t key, GLuint program) {
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+    std::vector<char> binary((size_t) length);
+    GLenum format;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+    if (length <= 0)
+        return;
+
+    /* Write to a temporary file first, so that other processes never read
+       an incomplete binary. Its name is unique to this process and call, so
+       that concurrent writers of the same cache entry don't clobber it */
+#if defined(_WIN32)
+    long pid = (long) _getpid();
+#else
+    long pid = (long) getpid();
+#endif
+    char suffix[48];
+    snprintf(suffix, sizeof(suffix), ".%ld.%08x.tmp", pid, (unsigned) std::random_device()());
+    std::string tempFilename = filename + suffix;
+    {
+        std::ofstream os(tempFilename, std::ios::binary | std::ios::trunc);
+        os.write(binaryCacheMagic, sizeof(binaryCacheMagic));
+        os.write((const char *) &key, sizeof(key));
+        os.write((const char *) &format, sizeof(format));
+        os.write(binary.data(), length);
+        if (!os) {
+            os.close();
+            std::remove(tempFilename.c_str());
+            return;
+        }
+    }
+#if defined(_WIN32)
+    /* rename() does not replace existing files on Windows */
+    std::remove(filename.c_str());
+#endif
+    if (std::rename(tempFilename.c_str(), filename.c_str()) != 0)
+        std::remove(tempFilename.c_str());
+}
+
+/* Check whether the current context supports an OpenGL extension */
+static bool hasExtension(const char *name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const char *ext = (const char *) glGetStringi(GL_EXTENSIONS, (GLuint) i);
+        if (ext && strcmp(ext, name) == 0)
+            return true;
+    }
+    return false;
+}
+
+/* Check for KHR/ARB_parallel_shader_compile and request as many compiler
+   threads as the driver offers */
+static bool parallelCompileSupported() {
+    static int supported = -1;
+    if (supported >= 0)
+        return supported == 1;
+
+    const char *maxThreadsName = nullptr;
+    if (hasExtension("GL_KHR_parallel_shader_compile"))
+        maxThreadsName = "glMaxShaderCompilerThreadsKHR";
+    else if (hasExtension("GL_ARB_parallel_shader_compile"))
+        maxThreadsName = "glMaxShaderCompilerThreadsARB";
+    supported = maxThreadsName ? 1 : 0;
+
+    if (maxThreadsName) {
+        auto maxThreads = (void (*)(GLuint)) glfwGetProcAddress(maxThreadsName);
+        if (maxThreads)
+            maxThreads(0xFFFFFFFFu);
+    }
+    return supported == 1;
+}
+
+/* Check for glProgramBinary() (OpenGL 4.1 or ARB_get_program_binary) */
+static bool programBinarySupported() {
+    static int supported = -1;
+    if (supported >= 0)
+        return supported == 1;
+
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    supported = major > 4 || (major == 4 && minor >= 1) ||
+                hasExtension("GL_ARB_get_program_binary");
+#if defined(NANOGUI_GLAD)
+    /* glad only loads the functions for OpenGL 4.1 contexts */
+    if (supported && !GLAD_GL_VERSION_4_1) {
+        glad_glGetProgramBinary = (PFNGLGETPROGRAMBINARYPROC) glfwGetProcAddress("glGetProgramBinary");
+        glad_glProgramBinary = (PFNGLPROGRAMBINARYPROC) glfwGetProcAddress("glProgramBinary");
+        glad_glProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC) glfwGetProcAddress("glProgramParameteri");
+    }
+    if (!glad_glGetProgramBinary || !glad_glProgramBinary || !glad_glProgramParameteri)
+        supported = 0;
+#endif
+    return supported == 1;
+}
+
+#if defined(GL_VERSION_4_4)
+/* Check for glBufferStorage() (OpenGL 4.4 or ARB_buffer_storage) */
+static bool bufferStorageSupported() {
+    static int supported = -1;
+    if (supported >= 0)
+        return supported == 1;
+
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    supported = major > 4 || (major == 4 && minor >= 4) ||
+                hasExtension("GL_ARB_buffer_storage");
+#if defined(NANOGUI_GLAD)
+    /* glad only loads the function for OpenGL 4.4 contexts */
+    if (supported && !GLAD_GL_VERSION_4_4)
+        glad_glBufferStorage = (PFNGLBUFFERSTORAGEPROC) glfwGetProcAddress("glBufferStorage");
+    if (!glad_glBufferStorage)
+        supported = 0;
+#endif
+    return supported == 1;
+}
+#endif
+
+void GLShader::setBinaryCacheDirectory(const std::string &path) {
+    binaryCacheDir = path;
+}
+
+const std::string &GLShader::binaryCacheDirectory() {
+    return binaryCacheDir;
 }
 
 bool GLShader::initFromFiles(
@@ -95,18 +305,59 @@ bool GLShader::init(const std::string &name,
                     const std::string &vertex_str,
                     const std::string &fragment_str,
                     const std::string &geometry_str) {
+    if (!initAsync(name, vertex_str, fragment_str, geometry_str))
+        return false;
+    finishInit();
+    return true;
+}
+
+bool GLShader::initAsync(const std::string &name,
+                         const std::string &vertex_str,
+                         const std::string &fragment_str,
+                         const std::string &geometry_str) {
     std::string defines;
     for (auto def : mDefinitions)
         defines += std::string("#define ") + def.first + std::string(" ") + def.second + "\n";
 
     glGenVertexArrays(1, &mVertexArrayObject);
     mName = name;
+    mCompileTime = mLinkTime = 0;
+    mLoadedFromBinary = false;
+    mPending = false;
+    mBinaryFile.clear();
+
+    /* The cached binary depends on the sources and the exact driver */
+    GLint binaryFormats = 0;
+    if (!binaryCacheDir.empty() && programBinarySupported())
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormats);
+    if (binaryFormats > 0) {
+        mBinaryKey = hashStrings({ vertex_str, fragment_str, geometry_str, defines,
+                                   glString(GL_VENDOR), glString(GL_RENDERER),
+                                   glString(GL_VERSION) });
+        char keyStr[17];
+        snprintf(keyStr, sizeof(keyStr), "%016llx", (unsigned long long) mBinaryKey);
+        mBinaryFile = binaryCacheDir + "/" + keyStr + ".bin";
+
+        auto start = std::chrono::steady_clock::now();
+        mProgramShader = loadProgramBinary(mBinaryFile, mBinaryKey);
+        if (mProgramShader) {
+            mLinkTime = secondsSince(start);
+            mLoadedFromBinary = true;
+            introspect();
+            return true;
+        }
+    }
+
+    /* Enable parallel compilation before submitting any work */
+    parallelCompileSupported();
+
+    auto start = std::chrono::steady_clock::now();
     mVertexShader =
-        createShader_helper(GL_VERTEX_SHADER, name, defines, vertex_str);
+        createShader_helper(GL_VERTEX_SHADER, defines, vertex_str);
     mGeometryShader =
-        createShader_helper(GL_GEOMETRY_SHADER, name, defines, geometry_str);
+        createShader_helper(GL_GEOMETRY_SHADER, defines, geometry_str);
     mFragmentShader =
-        createShader_helper(GL_FRAGMENT_SHADER, name, defines, fragment_str);
+        createShader_helper(GL_FRAGMENT_SHADER, defines, fragment_str);
 
     if (!mVertexShader || !mFragmentShader)
         return false;
@@ -114,6 +365,8 @@ bool GLShader::init(const std::string &name,
         return false;
 
     mProgramShader = glCreateProgram();
+    if (!mBinaryFile.empty())
+        glProgramParameteri(mProgramShader, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 
     glAttachShader(mProgramShader, mVertexShader);
     glAttachShader(mProgramShader, mFragmentShader);
@@ -121,8 +374,39 @@ bool GLShader::init(const std::string &name,
     if (mGeometryShader)
         glAttachShader(mProgramShader, mGeometryShader);
 
+    /* Linking does not wait for the compilation to finish */
     glLinkProgram(mProgramShader);
+    mCompileTime = secondsSince(start);
+    mPending = true;
+
+    return true;
+}
 
+bool GLShader::ready() {
+    if (!mPending)
+        return true;
+    if (parallelCompileSupported()) {
+        GLint completed = GL_FALSE;
+        glGetProgramiv(mProgramShader, GL_COMPLETION_STATUS_KHR, &completed);
+        if (completed != GL_TRUE)
+            return false;
+    }
+    finishInit();
+    return true;
+}
+
+void GLShader::finishInit() {
+    if (!mPending)
+        return;
+    mPending = false;
+
+    auto start = std::chrono::steady_clock::now();
+    checkShader_helper(mVertexShader, mName);
+    checkShader_helper(mGeometryShader, mName);
+    checkShader_helper(mFragmentShader, mName);
+    mCompileTime += secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
     GLint status;
     glGetProgramiv(mProgramShader, GL_LINK_STATUS, &status);
 
@@ -133,39 +417,125 @@ bool GLShader::init(const std::string &name,
         mProgramShader = 0;
         throw std::runtime_error("Shader linking failed!");
     }
+    mLinkTime = secondsSince(start);
 
-    return true;
+    if (!mBinaryFile.empty())
+        saveProgramBinary(mBinaryFile, mBinaryKey, mProgramShader);
+
+    introspect();
+}
+
+void GLShader::introspect() {
+    mUniforms.clear();
+    mUniformIndices.clear();
+    mAttribLocations.clear();
+    mUniformBlocks.clear();
+
+    GLint count = 0, maxLength = 0;
+    GLsizei length = 0;
+    GLint size;
+    GLenum type;
+
+    glGetProgramiv(mProgramShader, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(mProgramShader, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<char> buffer((size_t) std::max(maxLength, 1));
+    for (GLint i = 0; i < count; ++i) {
+        glGetActiveUniform(mProgramShader, (GLuint) i, (GLsizei) buffer.size(), &length,
+                           &size, &type, buffer.data());
+        std::string name(buffer.data(), (size_t) length);
+        GLint location = glGetUniformLocation(mProgramShader, name.c_str());
+        if (location < 0)
+            continue; /* Member of a uniform block */
+        int index = (int) mUniforms.size();
+        mUniforms.push_back(Uniform { location, 0, { } });
+        mUniformIndices[name] = index;
+        /* Arrays are reported as "name[0]", but may be referred to as "name" */
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+            mUniformIndices[name.substr(0, name.size() - 3)] = index;
+    }
+
+    glGetProgramiv(mProgramShader, GL_ACTIVE_ATTRIBUTES, &count);
+    glGetProgramiv(mProgramShader, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+    buffer.resize((size_t) std::max(maxLength, 1));
+    for (GLint i = 0; i < count; ++i) {
+        glGetActiveAttrib(mProgramShader, (GLuint) i, (GLsizei) buffer.size(), &length,
+                          &size, &type, buffer.data());
+        std::string name(buffer.data(), (size_t) length);
+        GLint location = glGetAttribLocation(mProgramShader, name.c_str());
+        if (location >= 0) /* Skip built-in inputs such as gl_VertexID */
+            mAttribLocations[name] = location;
+    }
+
+    glGetProgramiv(mProgramShader, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+    glGetProgramiv(mProgramShader, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+    buffer.resize((size_t) std::max(maxLength, 1));
+    for (GLint i = 0; i < count; ++i) {
+        glGetActiveUniformBlockName(mProgramShader, (GLuint) i, (GLsizei) buffer.size(),
+                                    &length, buffer.data());
+        mUniformBlocks[std::string(buffer.data(), (size_t) length)] = (GLuint) i;
+    }
 }
 
 void GLShader::bind() {
+    finishInit();
     glUseProgram(mProgramShader);
     glBindVertexArray(mVertexArrayObject);
 }
 
 GLint GLShader::attrib(const std::string &name, bool warn) const {
-    GLint id = glGetAttribLocation(mProgramShader, name.c_str());
+    const_cast<GLShader *>(this)->finishInit();
+    auto it = mAttribLocations.find(name);
+    GLint id = it != mAttribLocations.end() ? it->second : -1;
     if (id == -1 && warn)
         std::cerr << mName << ": warning: did not find attrib " << name << std::endl;
     return id;
 }
 
 void GLShader::setUniform(const std::string &name, const GLUniformBuffer &buf, bool warn) {
-    GLuint blockIndex = glGetUniformBlockIndex(mProgramShader, name.c_str());
-    if (blockIndex == GL_INVALID_INDEX) {
+    finishInit();
+    auto it = mUniformBlocks.find(name);
+    if (it == mUniformBlocks.end()) {
         if (warn)
             std::cerr << mName << ": warning: did not find uniform buffer " << name << std::endl;
         return;
     }
-    glUniformBlockBinding(mProgramShader, blockIndex, buf.getBindingPoint());
+    glUniformBlockBinding(mProgramShader, it->second, buf.getBindingPoint());
 }
 
 GLint GLShader::uniform(const std::string &name, bool warn) const {
-    GLint id = glGetUniformLocation(mProgramShader, name.c_str());
+    const_cast<GLShader *>(this)->finishInit();
+    GLint id = -1;
+    auto it = mUniformIndices.find(name);
+    if (it != mUniformIndices.end())
+        id = mUniforms[it->second].location;
+    else if (name.find('[') != std::string::npos) /* Array elements other than the first */
+        id = glGetUniformLocation(mProgramShader, name.c_str());
     if (id == -1 && warn)
         std::cerr << mName << ": warning: did not find uniform " << name << std::endl;
     return id;
 }
 
+GLShader::UniformHandle GLShader::uniformHandle(const std::string &name, bool warn) {
+    finishInit();
+    auto it = mUniformIndices.find(name);
+    if (it != mUniformIndices.end())
+        return UniformHandle(it->second);
+
+    /* Array elements other than the first are resolved on first use */
+    GLint location = uniform(name, warn);
+    if (location == -1)
+        return UniformHandle();
+    int index = (int) mUniforms.size();
+    mUniforms.push_back(Uniform { location, 0, { } });
+    mUniformIndices[name] = index;
+    return UniformHandle(index);
+}
+
+void GLShader::invalidateUniforms() {
+    for (auto &uniform : mUniforms)
+        uniform.valueSize = 0;
+}
+
 void GLShader::uploadAttrib(const std::string &name, size_t size, int dim,
                             uint32_t compSize, GLuint glType, bool integral,
                             const void *data, int version) {
@@ -176,14 +546,24 @@ void GLShader::uploadAttrib(const std::string &name, size_t size, int dim,
             return;
     }
 
+    /* The storage of a streamed buffer may be immutable: start over */
+    if (mStreamBuffers.find(name) != mStreamBuffers.end())
+        freeAttrib(name);
+
     GLuint bufferID;
+    size_t totalSize = size * (size_t) compSize;
+    bool reuse = false;
     auto it = mBufferObjects.find(name);
     if (it != mBufferObjects.end()) {
         Buffer &buffer = it->second;
         bufferID = it->second.id;
+        reuse = (size_t) buffer.size * buffer.compSize == totalSize && totalSize > 0;
         buffer.version = version;
+        buffer.glType = glType;
+        buffer.dim = dim;
         buffer.size = (GLuint) size;
         buffer.compSize = compSize;
+        buffer.offset = 0;
     } else {
         glGenBuffers(1, &bufferID);
         Buffer buffer;
@@ -193,23 +573,159 @@ void GLShader::uploadAttrib(const std::string &name, size_t size, int dim,
         buffer.compSize = compSize;
         buffer.size = (GLuint) size;
         buffer.version = version;
+        buffer.offset = 0;
         mBufferObjects[name] = buffer;
     }
-    size_t totalSize = size * (size_t) compSize;
+
+    /* Replace the contents of a buffer of the same size in place, which
+       avoids reallocating its storage */
+    GLenum target = name == "indices" ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER;
+    glBindBuffer(target, bufferID);
+    if (reuse)
+        glBufferSubData(target, 0, totalSize, data);
+    else
+        glBufferData(target, totalSize, data, GL_DYNAMIC_DRAW);
 
     if (name == "indices") {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bufferID);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, totalSize, data, GL_DYNAMIC_DRAW);
+        mIndexOffset = 0;
+    } else if (size == 0) {
+        glDisableVertexAttribArray(attribID);
+    } else {
+        glEnableVertexAttribArray(attribID);
+        glVertexAttribPointer(attribID, dim, glType, integral, 0, 0);
+        glVertexAttribDivisor(attribID, attribDivisor(name));
+    }
+}
+
+void GLShader::updateAttrib(const std::string &name, size_t offset, size_t size, int dim,
+                            uint32_t compSize, GLuint glType, const void *data) {
+    auto it = mBufferObjects.find(name);
+    if (it == mBufferObjects.end())
+        throw std::runtime_error("updateAttrib(" + mName + ", " + name + ") : buffer not found!");
+
+    const Buffer &buf = it->second;
+    if (mStreamBuffers.find(name) != mStreamBuffers.end())
+        throw std::runtime_error("updateAttrib(" + mName + ", " + name + ") : attribute is streamed!");
+    if ((int) buf.dim != dim || buf.compSize != compSize || buf.glType != glType)
+        throw std::runtime_error(mName + ": updateAttrib: type mismatch!");
+    if (offset + size > buf.size)
+        throw std::runtime_error(mName + ": updateAttrib: range exceeds the buffer!");
+    if (size == 0)
+        return;
+
+    GLenum target = name == "indices" ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER;
+    glBindBuffer(target, buf.id);
+    glBufferSubData(target, offset * compSize, size * compSize, data);
+}
+
+void GLShader::streamAttrib(const std::string &name, size_t size, int dim,
+                            uint32_t compSize, GLuint glType, bool integral,
+                            const void *data) {
+    int attribID = 0;
+    if (name != "indices") {
+        attribID = attrib(name);
+        if (attribID < 0)
+            return;
+    }
+
+    GLenum target = name == "indices" ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER;
+    size_t totalSize = size * (size_t) compSize;
+    auto it = mStreamBuffers.find(name);
+
+    if (it == mStreamBuffers.end() || it->second.segmentSize < totalSize) {
+        /* Allocate a new ring whose segments can hold the data */
+        size_t segmentSize = 4096;
+        while (segmentSize < totalSize)
+            segmentSize *= 2;
+        freeAttrib(name);
+
+        GLuint bufferID;
+        glGenBuffers(1, &bufferID);
+        glBindBuffer(target, bufferID);
+        StreamBuffer stream;
+        stream.segmentSize = segmentSize;
+        stream.segment = 0;
+        stream.mapped = nullptr;
+        for (int i = 0; i < StreamSegments; ++i)
+            stream.fences[i] = nullptr;
+
+        GLsizeiptr bufferSize = (GLsizeiptr) (segmentSize * StreamSegments);
+#if defined(GL_VERSION_4_4)
+        if (bufferStorageSupported()) {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(target, bufferSize, nullptr, flags);
+            stream.mapped = glMapBufferRange(target, 0, bufferSize, flags);
+        }
+#endif
+        if (!stream.mapped)
+            glBufferData(target, bufferSize, nullptr, GL_STREAM_DRAW);
+
+        Buffer buffer;
+        buffer.id = bufferID;
+        buffer.version = -1;
+        buffer.offset = 0;
+        mBufferObjects[name] = buffer;
+        it = mStreamBuffers.insert(std::make_pair(name, stream)).first;
     } else {
-        glBindBuffer(GL_ARRAY_BUFFER, bufferID);
-        glBufferData(GL_ARRAY_BUFFER, totalSize, data, GL_DYNAMIC_DRAW);
-        if (size == 0) {
-            glDisableVertexAttribArray(attribID);
+        /* Fence the segment holding the previous data, which the GPU may
+           still read, and move on to the next one */
+        StreamBuffer &stream = it->second;
+        GLsync &fence = stream.fences[stream.segment];
+        if (fence)
+            glDeleteSync(fence);
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        stream.segment = (stream.segment + 1) % StreamSegments;
+    }
+
+    StreamBuffer &stream = it->second;
+    Buffer &buffer = mBufferObjects[name];
+    buffer.glType = glType;
+    buffer.dim = dim;
+    buffer.compSize = compSize;
+    buffer.size = (GLuint) size;
+    buffer.offset = stream.segment * stream.segmentSize;
+
+    /* Wait until the GPU has finished reading the segment (normally, it
+       was fenced two frames ago and the fence has long been signalled) */
+    GLsync &fence = stream.fences[stream.segment];
+    if (fence) {
+        /* Flush on the first wait, since the fence may still be sitting
+           in the command queue and would otherwise never be signalled */
+        while (true) {
+            GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                             (GLuint64) 1000000000);
+            if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED ||
+                result == GL_WAIT_FAILED)
+                break;
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    glBindBuffer(target, buffer.id);
+    if (totalSize > 0) {
+        if (stream.mapped) {
+            memcpy((uint8_t *) stream.mapped + buffer.offset, data, totalSize);
         } else {
-            glEnableVertexAttribArray(attribID);
-            glVertexAttribPointer(attribID, dim, glType, integral, 0, 0);
+            void *ptr = glMapBufferRange(target, buffer.offset, totalSize,
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+            if (!ptr)
+                throw std::runtime_error(mName + ": streamAttrib: could not map buffer!");
+            memcpy(ptr, data, totalSize);
+            glUnmapBuffer(target);
         }
     }
+
+    if (name == "indices") {
+        mIndexOffset = buffer.offset;
+    } else if (size == 0) {
+        glDisableVertexAttribArray(attribID);
+    } else {
+        glEnableVertexAttribArray(attribID);
+        glVertexAttribPointer(attribID, dim, glType, integral, 0,
+                              (const void *) buffer.offset);
+        glVertexAttribDivisor(attribID, attribDivisor(name));
+    }
 }
 
 void GLShader::downloadAttrib(const std::string &name, size_t size, int /* dim */,
@@ -226,10 +742,10 @@ void GLShader::downloadAttrib(const std::string &name, size_t size, int /* dim *
 
     if (name == "indices") {
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buf.id);
-        glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, totalSize, data);
+        glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, buf.offset, totalSize, data);
     } else {
         glBindBuffer(GL_ARRAY_BUFFER, buf.id);
-        glGetBufferSubData(GL_ARRAY_BUFFER, 0, totalSize, data);
+        glGetBufferSubData(GL_ARRAY_BUFFER, buf.offset, totalSize, data);
     }
 }
 
@@ -246,9 +762,12 @@ void GLShader::shareAttrib(const GLShader &otherShader, const std::string &name,
             return;
         glEnableVertexAttribArray(attribID);
         glBindBuffer(GL_ARRAY_BUFFER, buffer.id);
-        glVertexAttribPointer(attribID, buffer.dim, buffer.glType, buffer.compSize == 1 ? GL_TRUE : GL_FALSE, 0, 0);
+        glVertexAttribPointer(attribID, buffer.dim, buffer.glType, buffer.compSize == 1 ? GL_TRUE : GL_FALSE, 0,
+                              (const void *) buffer.offset);
+        glVertexAttribDivisor(attribID, attribDivisor(as));
     } else {
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.id);
+        mIndexOffset = buffer.offset;
     }
 }
 
@@ -263,21 +782,85 @@ void GLShader::freeAttrib(const std::string &name) {
         glDeleteBuffers(1, &it->second.id);
         mBufferObjects.erase(it);
     }
+    auto it2 = mStreamBuffers.find(name);
+    if (it2 != mStreamBuffers.end()) {
+        for (GLsync fence : it2->second.fences) {
+            if (fence)
+                glDeleteSync(fence);
+        }
+        mStreamBuffers.erase(it2);
+    }
+    if (name == "indices")
+        mIndexOffset = 0;
 }
 
-void GLShader::drawIndexed(int type, uint32_t offset_, uint32_t count_) {
-    if (count_ == 0)
+void GLShader::setAttribDivisor(const std::string &name, uint32_t divisor) {
+    if (divisor == 0)
+        mAttribDivisors.erase(name);
+    else
+        mAttribDivisors[name] = divisor;
+
+    /* Attributes that have not been uploaded yet pick it up later */
+    if (mBufferObjects.find(name) == mBufferObjects.end())
         return;
-    size_t offset = offset_;
-    size_t count = count_;
+    int attribID = attrib(name, false);
+    if (attribID >= 0)
+        glVertexAttribDivisor(attribID, divisor);
+}
 
+/* Number of indices per primitive, by which the offsets and counts of
+   indexed draw calls are multiplied */
+static size_t indicesPerPrimitive(int type) {
     switch (type) {
-        case GL_TRIANGLES: offset *= 3; count *= 3; break;
-        case GL_LINES: offset *= 2; count *= 2; break;
+        case GL_TRIANGLES: return 3;
+        case GL_LINES: return 2;
+        default: return 1;
     }
+}
+
+void GLShader::drawIndexed(int type, uint32_t offset_, uint32_t count_) {
+    if (count_ == 0)
+        return;
+    size_t offset = offset_ * indicesPerPrimitive(type);
+    size_t count = count_ * indicesPerPrimitive(type);
 
     glDrawElements(type, (GLsizei) count, GL_UNSIGNED_INT,
-                   (const void *)(offset * sizeof(uint32_t)));
+                   (const void *)(mIndexOffset + offset * sizeof(uint32_t)));
+}
+
+void GLShader::drawIndexedInstanced(int type, uint32_t offset_, uint32_t count_,
+                                    uint32_t instanceCount) {
+    if (count_ == 0 || instanceCount == 0)
+        return;
+    size_t offset = offset_ * indicesPerPrimitive(type);
+    size_t count = count_ * indicesPerPrimitive(type);
+
+    glDrawElementsInstanced(type, (GLsizei) count, GL_UNSIGNED_INT,
+                            (const void *)(mIndexOffset + offset * sizeof(uint32_t)),
+                            (GLsizei) instanceCount);
+}
+
+void GLShader::drawIndexedMulti(int type, const std::vector<uint32_t> &offsets,
+                                const std::vector<uint32_t> &counts) {
+    if (offsets.size() != counts.size())
+        throw std::runtime_error(mName + ": drawIndexedMulti: offsets and counts differ in size!");
+
+    size_t factor = indicesPerPrimitive(type);
+    std::vector<GLsizei> indexCounts;
+    std::vector<const void *> indexOffsets;
+    indexCounts.reserve(counts.size());
+    indexOffsets.reserve(counts.size());
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] == 0)
+            continue;
+        indexCounts.push_back((GLsizei) (counts[i] * factor));
+        indexOffsets.push_back((const void *) (mIndexOffset + offsets[i] * factor * sizeof(uint32_t)));
+    }
+    if (indexCounts.empty())
+        return;
+
+    glMultiDrawElements(type, indexCounts.data(), GL_UNSIGNED_INT, indexOffsets.data(),
+                        (GLsizei) indexCounts.size());
 }
 
 void GLShader::drawArray(int type, uint32_t offset, uint32_t count) {
@@ -287,10 +870,43 @@ void GLShader::drawArray(int type, uint32_t offset, uint32_t count) {
     glDrawArrays(type, offset, count);
 }
 
+void GLShader::drawArrayInstanced(int type, uint32_t offset, uint32_t count,
+                                  uint32_t instanceCount) {
+    if (count == 0 || instanceCount == 0)
+        return;
+
+    glDrawArraysInstanced(type, (GLint) offset, (GLsizei) count, (GLsizei) instanceCount);
+}
+
+void GLShader::drawArrayMulti(int type, const std::vector<uint32_t> &offsets,
+                              const std::vector<uint32_t> &counts) {
+    if (offsets.size() != counts.size())
+        throw std::runtime_error(mName + ": drawArrayMulti: offsets and counts differ in size!");
+    if (counts.empty())
+        return;
+
+    std::vector<GLint> firsts(offsets.begin(), offsets.end());
+    std::vector<GLsizei> sizes(counts.begin(), counts.end());
+    glMultiDrawArrays(type, firsts.data(), sizes.data(), (GLsizei) sizes.size());
+}
+
 void GLShader::free() {
     for (auto &buf: mBufferObjects)
         glDeleteBuffers(1, &buf.second.id);
     mBufferObjects.clear();
+    for (auto &stream: mStreamBuffers) {
+        for (GLsync fence : stream.second.fences) {
+            if (fence)
+                glDeleteSync(fence);
+        }
+    }
+    mStreamBuffers.clear();
+    mIndexOffset = 0;
+    mUniforms.clear();
+    mUniformIndices.clear();
+    mAttribLocations.clear();
+    mUniformBlocks.clear();
+    mPending = false;
 
     if (mVertexArrayObject) {
         glDeleteVertexArrays(1, &mVertexArrayObject);
@@ -380,7 +996,8 @@ void GLFramebuffer::init(const Vector2i &size, int nSamples) {
 void GLFramebuffer::free() {
     glDeleteRenderbuffers(1, &mColor);
     glDeleteRenderbuffers(1, &mDepth);
-    mColor = mDepth = 0;
+    glDeleteFramebuffers(1, &mFramebuffer);
+    mColor = mDepth = mFramebuffer = 0;
 }
 
 void GLFramebuffer::bind() {
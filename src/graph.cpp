@@ -10,19 +10,281 @@
 */
 
 #include <nanogui/graph.h>
+#include <nanogui/screen.h>
 #include <nanogui/theme.h>
 #include <nanogui/opengl.h>
 #include <nanogui/serializer/core.h>
+#include <algorithm>
+#include <limits>
 
 NAMESPACE_BEGIN(nanogui)
 
+/* The producer queue may be set up before the graph is attached to a screen */
+static Screen *findScreen(Widget *widget) {
+    while (widget->parent())
+        widget = widget->parent();
+    return dynamic_cast<Screen *>(widget);
+}
+
 Graph::Graph(Widget *parent, const std::string &caption)
-    : Widget(parent), mCaption(caption) {
+    : Widget(parent), mCaption(caption), mRingStart(0), mRingCount(0), mRingTotal(0),
+      mQueueRead(0), mQueueWrite(0), mDrainRequested(false),
+      mQueueScreen(nullptr) {
     mBackgroundColor = Color(20, 128);
     mForegroundColor = Color(255, 192, 0, 128);
     mTextColor = Color(240, 192);
 }
 
+void Graph::setValues(const VectorXf &values) {
+    if (mRing.empty()) {
+        mValues = values;
+        markDirty();
+    } else {
+        mRingStart = mRingCount = 0;
+        pushBatch(values.data(), (size_t) values.size());
+    }
+}
+
+void Graph::setCapacity(size_t capacity) {
+    if (capacity == mRing.size())
+        return;
+
+    /* Keep the most recent samples (or all of them when disabling the ring buffer) */
+    size_t total = sampleCount(), count = std::min(total, capacity);
+    if (capacity == 0) {
+        mValues.resize(total);
+        for (size_t i = 0; i < total; ++i)
+            mValues[i] = sample(i);
+    }
+    std::vector<float> ring(capacity);
+    for (size_t i = 0; i < count; ++i)
+        ring[i] = sample(total - count + i);
+
+    mRing.swap(ring);
+    mRingStart = 0;
+    mRingCount = mRingTotal = count;
+    rebuildPyramid();
+    markDirty();
+}
+
+void Graph::pushBatch(const float *values, size_t count) {
+    size_t capacity = mRing.size();
+    if (capacity == 0)
+        throw std::runtime_error("Graph::pushBatch(): the ring buffer is disabled, call setCapacity() first!");
+    if (count == 0)
+        return;
+
+    /* Only the last 'capacity' samples survive */
+    if (count > capacity) {
+        values += count - capacity;
+        count = capacity;
+    }
+
+    /* Copy in at most two contiguous pieces */
+    size_t end = (mRingStart + mRingCount) % capacity,
+           first = std::min(count, capacity - end);
+    std::copy(values, values + first, mRing.begin() + end);
+    std::copy(values + first, values + count, mRing.begin());
+
+    size_t overflow = std::max(mRingCount + count, capacity) - capacity;
+    mRingStart = (mRingStart + overflow) % capacity;
+    mRingCount = std::min(mRingCount + count, capacity);
+    mRingTotal += count;
+    updatePyramid(mRingTotal - count);
+    markDirty();
+}
+
+size_t Graph::sampleCount() const {
+    return mRing.empty() ? (size_t) mValues.size() : mRingCount;
+}
+
+float Graph::sample(size_t i) const {
+    if (mRing.empty())
+        return mValues[i];
+    return mRing[(mRingStart + i) % mRing.size()];
+}
+
+void Graph::rawRange(size_t begin, size_t end, float &min, float &max) const {
+    /* Up to two contiguous pieces, reduced with Eigen's vectorized kernels */
+    size_t capacity = mRing.size(),
+           start = (mRingStart + begin - (mRingTotal - mRingCount)) % capacity,
+           count = end - begin,
+           first = std::min(count, capacity - start);
+    Eigen::Map<const Eigen::ArrayXf> a(mRing.data() + start, (Eigen::Index) first),
+                                     b(mRing.data(), (Eigen::Index) (count - first));
+    min = a.minCoeff();
+    max = a.maxCoeff();
+    if (count > first) {
+        min = std::min(min, b.minCoeff());
+        max = std::max(max, b.maxCoeff());
+    }
+}
+
+void Graph::rebuildPyramid() {
+    mPyramid.clear();
+    size_t capacity = mRing.size();
+    for (size_t blockSize = 8; blockSize * 4 <= capacity; blockSize *= 4) {
+        PyramidLevel level;
+        level.blockSize = blockSize;
+        /* Room for all complete blocks within the ring, however aligned */
+        level.min.resize(capacity / blockSize + 2);
+        level.max.resize(capacity / blockSize + 2);
+        mPyramid.push_back(std::move(level));
+    }
+    updatePyramid(mRingTotal - mRingCount);
+}
+
+void Graph::updatePyramid(size_t from) {
+    size_t oldest = mRingTotal - mRingCount;
+    for (size_t l = 0; l < mPyramid.size(); ++l) {
+        PyramidLevel &level = mPyramid[l];
+        size_t bs = level.blockSize, blocks = level.min.size();
+
+        /* Blocks that were completed since 'from' and still lie within the ring */
+        size_t first = std::max(from / bs, (oldest + bs - 1) / bs),
+               last = mRingTotal / bs;
+        for (size_t j = first; j < last; ++j) {
+            float min, max;
+            if (l == 0) {
+                rawRange(j * bs, (j + 1) * bs, min, max);
+            } else {
+                const PyramidLevel &child = mPyramid[l - 1];
+                size_t childBlocks = child.min.size();
+                min = child.min[(4 * j) % childBlocks];
+                max = child.max[(4 * j) % childBlocks];
+                for (size_t k = 1; k < 4; ++k) {
+                    min = std::min(min, child.min[(4 * j + k) % childBlocks]);
+                    max = std::max(max, child.max[(4 * j + k) % childBlocks]);
+                }
+            }
+            level.min[j % blocks] = min;
+            level.max[j % blocks] = max;
+        }
+    }
+}
+
+void Graph::pyramidRange(int l, size_t begin, size_t end, float &min, float &max) const {
+    if (l < 0) {
+        rawRange(begin, end, min, max);
+        return;
+    }
+
+    const PyramidLevel &level = mPyramid[l];
+    size_t bs = level.blockSize, blocks = level.min.size(),
+           first = (begin + bs - 1) / bs, last = end / bs;
+    if (first >= last) {
+        pyramidRange(l - 1, begin, end, min, max);
+        return;
+    }
+
+    /* Complete blocks of this level, and the remainders on either side */
+    min = std::numeric_limits<float>::infinity();
+    max = -std::numeric_limits<float>::infinity();
+    for (size_t j = first; j < last; ++j) {
+        min = std::min(min, level.min[j % blocks]);
+        max = std::max(max, level.max[j % blocks]);
+    }
+    float partMin, partMax;
+    if (begin < first * bs) {
+        pyramidRange(l - 1, begin, first * bs, partMin, partMax);
+        min = std::min(min, partMin);
+        max = std::max(max, partMax);
+    }
+    if (last * bs < end) {
+        pyramidRange(l - 1, last * bs, end, partMin, partMax);
+        min = std::min(min, partMin);
+        max = std::max(max, partMax);
+    }
+}
+
+void Graph::sampleRange(size_t begin, size_t end, float &min, float &max) const {
+    if (begin >= end || end > sampleCount())
+        throw std::runtime_error("Graph::sampleRange(): invalid range!");
+
+    if (mRing.empty()) {
+        auto segment = mValues.segment((Eigen::Index) begin, (Eigen::Index) (end - begin));
+        min = segment.minCoeff();
+        max = segment.maxCoeff();
+        return;
+    }
+
+    /* Start at the coarsest level whose blocks fit into the range */
+    size_t oldest = mRingTotal - mRingCount;
+    int l = (int) mPyramid.size() - 1;
+    while (l >= 0 && mPyramid[l].blockSize > end - begin)
+        --l;
+    pyramidRange(l, oldest + begin, oldest + end, min, max);
+}
+
+void Graph::setQueueCapacity(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity)
+        size *= 2;
+    mQueue.assign(capacity > 0 ? size : 0, 0.f);
+    mQueueRead = mQueueWrite = 0;
+    mQueueScreen = findScreen(this);
+}
+
+size_t Graph::enqueueBatch(const float *values, size_t count) {
+    size_t capacity = mQueue.size();
+    if (capacity == 0)
+        throw std::runtime_error("Graph::enqueueBatch(): call setQueueCapacity() first!");
+
+    size_t write = mQueueWrite.load(std::memory_order_relaxed),
+           read = mQueueRead.load(std::memory_order_acquire);
+    count = std::min(count, capacity - (write - read));
+    if (count == 0)
+        return 0;
+
+    for (size_t i = 0; i < count; ++i)
+        mQueue[(write + i) & (capacity - 1)] = values[i];
+    mQueueWrite.store(write + count);
+
+    requestDrain();
+    return count;
+}
+
+size_t Graph::drainQueue() {
+    /* Clear the flag before looking for samples: a producer either sees
+       it cleared and requests another drain, or its samples are seen here */
+    mDrainRequested = false;
+
+    size_t capacity = mQueue.size();
+    size_t read = mQueueRead.load(std::memory_order_relaxed),
+           write = mQueueWrite.load();
+    size_t count = write - read;
+    if (count == 0)
+        return 0;
+
+    /* With the ring buffer disabled, the samples are consumed but discarded */
+    bool keep = !mRing.empty();
+    if (keep) {
+        size_t start = read & (capacity - 1),
+               first = std::min(count, capacity - start);
+        pushBatch(mQueue.data() + start, first);
+        pushBatch(mQueue.data(), count - first);
+    }
+
+    mQueueRead.store(write, std::memory_order_release);
+    return keep ? count : 0;
+}
+
+void Graph::requestDrain() {
+    if (mDrainRequested.exchange(true))
+        return;
+
+    Screen *screen = mQueueScreen;
+    if (!screen) {
+        /* Not yet part of a screen: draw() will request the drain */
+        mDrainRequested = false;
+        return;
+    }
+
+    /* The reference keeps the graph alive until the frame is drawn */
+    ref<Graph> self = this;
+    screen->requestAnimationFrame([self](double) mutable { self->drainQueue(); });
+}
+
 Vector2i Graph::preferredSize(NVGcontext *) const {
     return Vector2i(180, 45);
 }
@@ -35,16 +297,54 @@ void Graph::draw(NVGcontext *ctx) {
     nvgFillColor(ctx, mBackgroundColor);
     nvgFill(ctx);
 
-    if (mValues.size() < 2)
+    if (!mQueue.empty() && !mQueueScreen) {
+        mQueueScreen = findScreen(this);
+        if (mQueueRead != mQueueWrite)
+            requestDrain();
+    }
+
+    size_t count = sampleCount(), columns = (size_t) std::max(mSize.x(), 2);
+    if (count < 2)
         return;
 
     nvgBeginPath(ctx);
     nvgMoveTo(ctx, mPos.x(), mPos.y()+mSize.y());
-    for (size_t i = 0; i < (size_t) mValues.size(); i++) {
-        float value = mValues[i];
-        float vx = mPos.x() + i * mSize.x() / (float) (mValues.size() - 1);
-        float vy = mPos.y() + (1-value) * mSize.y();
-        nvgLineTo(ctx, vx, vy);
+
+    if (count > 2 * columns) {
+        /* Decimate to the extrema of every pixel column. They are visited
+           in the order suggested by the first and last sample, which keeps
+           steep flanks from turning into zigzags. */
+        float dx = mSize.x() / (float) (columns - 1);
+        for (size_t c = 0; c < columns; ++c) {
+            size_t begin = c * count / columns, end = (c + 1) * count / columns;
+            float min, max;
+            sampleRange(begin, end, min, max);
+            bool rising = sample(begin) <= sample(end - 1);
+            float vx = mPos.x() + c * dx;
+            nvgLineTo(ctx, vx, mPos.y() + (1 - (rising ? min : max)) * mSize.y());
+            nvgLineTo(ctx, vx, mPos.y() + (1 - (rising ? max : min)) * mSize.y());
+        }
+    } else {
+        /* Plot the ring buffer in place, which consists of up to two pieces */
+        const float *pieces[2] = { mValues.data(), nullptr };
+        size_t sizes[2] = { count, 0 };
+        if (!mRing.empty()) {
+            pieces[0] = mRing.data() + mRingStart;
+            pieces[1] = mRing.data();
+            sizes[0] = std::min(count, mRing.size() - mRingStart);
+            sizes[1] = count - sizes[0];
+        }
+
+        float dx = mSize.x() / (float) (count - 1);
+        size_t i = 0;
+        for (int piece = 0; piece < 2; ++piece) {
+            for (size_t j = 0; j < sizes[piece]; ++j, ++i) {
+                float value = pieces[piece][j];
+                float vx = mPos.x() + i * dx;
+                float vy = mPos.y() + (1-value) * mSize.y();
+                nvgLineTo(ctx, vx, vy);
+            }
+        }
     }
 
     nvgLineTo(ctx, mPos.x() + mSize.x(), mPos.y() + mSize.y());
@@ -90,7 +390,15 @@ void Graph::save(Serializer &s) const {
     s.set("backgroundColor", mBackgroundColor);
     s.set("foregroundColor", mForegroundColor);
     s.set("textColor", mTextColor);
-    s.set("values", mValues);
+    s.set("capacity", (uint64_t) capacity());
+    if (mRing.empty()) {
+        s.set("values", mValues);
+    } else {
+        VectorXf values(mRingCount);
+        for (size_t i = 0; i < mRingCount; ++i)
+            values[i] = sample(i);
+        s.set("values", values);
+    }
 }
 
 bool Graph::load(Serializer &s) {
@@ -101,7 +409,16 @@ bool Graph::load(Serializer &s) {
     if (!s.get("backgroundColor", mBackgroundColor)) return false;
     if (!s.get("foregroundColor", mForegroundColor)) return false;
     if (!s.get("textColor", mTextColor)) return false;
-    if (!s.get("values", mValues)) return false;
+    /* Files written before the ring buffer existed have no capacity */
+    uint64_t capacity = 0;
+    std::vector<std::string> keys = s.keys();
+    if (std::find(keys.begin(), keys.end(), "capacity") != keys.end() &&
+        !s.get("capacity", capacity)) return false;
+    VectorXf values;
+    if (!s.get("values", values)) return false;
+    mRingStart = mRingCount = 0;
+    setCapacity((size_t) capacity);
+    setValues(values);
     return true;
 }
 
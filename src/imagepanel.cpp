@@ -11,13 +11,193 @@
 */
 
 #include <nanogui/imagepanel.h>
+#include <nanogui/thumbnailloader.h>
+#include <nanogui/textureatlas.h>
+#include <nanogui/screen.h>
 #include <nanogui/opengl.h>
 
 NAMESPACE_BEGIN(nanogui)
 
+namespace {
+    /* Draws the thumbnails with the rounded corners, drop shadow and border
+       of the NanoVG version. Every quad covers a thumbnail and its shadow. */
+    constexpr char const *const thumbnailVertexShader =
+        R"(#version 330
+        uniform vec2 screenSize;
+        in vec2 position;
+        in vec2 local;
+        in vec4 region;
+        in float opacity;
+        out vec2 localPosition;
+        out vec4 atlasRegion;
+        out float thumbnailOpacity;
+        void main() {
+            localPosition = local;
+            atlasRegion = region;
+            thumbnailOpacity = opacity;
+            gl_Position = vec4(2.0 * position.x / screenSize.x - 1.0,
+                               1.0 - 2.0 * position.y / screenSize.y,
+                               0.0, 1.0);
+        })";
+
+    constexpr char const *const thumbnailFragmentShader =
+        R"(#version 330
+        uniform sampler2D atlas;
+        uniform float thumbSize;
+        in vec2 localPosition;
+        in vec4 atlasRegion;
+        in float thumbnailOpacity;
+        out vec4 color;
+
+        float roundedRectDistance(vec2 p, vec2 extent, float radius) {
+            vec2 d = abs(p) - (extent - vec2(radius));
+            return min(max(d.x, d.y), 0.0) + length(max(d, 0.0)) - radius;
+        }
+
+        void main() {
+            vec2 center = vec2(0.5 * thumbSize);
+            float d = roundedRectDistance(localPosition - center, center, 5.0);
+            float inside = clamp(0.5 - d, 0.0, 1.0);
+
+            // Box gradient shadow, offset by one unit downwards.
+            float ds = roundedRectDistance(localPosition - center - vec2(0.0, 1.0),
+                                           center + vec2(1.0), 5.0);
+            float shadow = 0.5 * (1.0 - clamp((ds + 1.5) / 3.0, 0.0, 1.0)) * (1.0 - inside);
+
+            // Negative opacities denote placeholders with the given gray level.
+            vec4 image;
+            if (thumbnailOpacity < 0.0) {
+                image = vec4(1.0, 1.0, 1.0, -thumbnailOpacity);
+            } else {
+                vec2 uv = mix(atlasRegion.xy, atlasRegion.zw, localPosition / thumbSize);
+                image = texture(atlas, uv);
+                image.a *= thumbnailOpacity;
+            }
+            image = vec4(image.rgb * image.a, image.a) * inside;
+
+            // One unit wide border along the inside of the rounded rectangle.
+            float border = clamp(1.0 - abs(d + 0.5), 0.0, 1.0) * inside * (80.0 / 255.0);
+
+            color = image + vec4(0.0, 0.0, 0.0, shadow) * (1.0 - image.a);
+            color = vec4(border) + color * (1.0 - border);
+        })";
+}
+
+static Screen *findScreen(Widget *widget) {
+    while (widget->parent())
+        widget = widget->parent();
+    return dynamic_cast<Screen *>(widget);
+}
+
 ImagePanel::ImagePanel(Widget *parent)
     : Widget(parent), mThumbSize(64), mSpacing(10), mMargin(10),
-      mMouseIndex(-1) {}
+      mMouseIndex(-1), mLoader(nullptr), mUploadBudget(0.004), mPollRequested(false) {}
+
+ImagePanel::~ImagePanel() {
+    delete mLoader;
+    for (TextureAtlas *atlas : mAtlases)
+        delete atlas;
+    mShader.free();
+}
+
+void ImagePanel::setImages(const Images &data) {
+    delete mLoader;
+    mLoader = nullptr;
+    for (TextureAtlas *atlas : mAtlases)
+        delete atlas;
+    mAtlases.clear();
+    mThumbnails.clear();
+    mImages = data;
+    invalidateLayout();
+    markDirty();
+}
+
+void ImagePanel::loadDirectory(const std::string &path, int thumbnailSize) {
+    std::vector<std::string> filenames = listImageDirectory(path);
+    Images images;
+    for (const std::string &filename : filenames)
+        images.push_back(std::make_pair(0, filename.substr(0, filename.length() - 4)));
+    setImages(images);
+    mThumbnails.assign(filenames.size(), std::make_pair(-1, -1));
+    mLoader = new ThumbnailLoader(filenames, thumbnailSize > 0 ? thumbnailSize : 2 * mThumbSize);
+}
+
+void ImagePanel::clipRect(Vector2i &lower, Vector2i &upper) const {
+    lower = absolutePosition();
+    upper = lower + mSize;
+    for (const Widget *w = parent(); w; w = w->parent()) {
+        Vector2i p = w->absolutePosition();
+        lower = lower.cwiseMax(p);
+        upper = upper.cwiseMin(p + w->size());
+    }
+}
+
+std::pair<size_t, size_t> ImagePanel::visibleRange() const {
+    Vector2i position = absolutePosition(), lower, upper;
+    clipRect(lower, upper);
+    if ((upper.array() <= lower.array()).any())
+        return std::make_pair(0, 0);
+
+    int stride = mThumbSize + mSpacing, columns = gridSize().x();
+    int firstRow = std::max(0, (lower.y() - position.y() - mMargin) / stride);
+    int lastRow = std::max(0, (upper.y() - position.y() - mMargin + stride - 1) / stride);
+    return std::make_pair(std::min((size_t) firstRow * columns, mImages.size()),
+                          std::min((size_t) lastRow * columns, mImages.size()));
+}
+
+void ImagePanel::updateThumbnails() {
+    auto range = visibleRange();
+    mLoader->prioritize(range.first, range.second);
+    mLoader->fetch(mUploadBudget, [&](size_t index, const Vector2i &size, const uint8_t *data) {
+        if (data)
+            addThumbnail(index, size, data);
+    });
+
+    if (mLoader->finished()) {
+        delete mLoader;
+        mLoader = nullptr;
+        return;
+    }
+
+    requestPoll();
+}
+
+void ImagePanel::addThumbnail(size_t index, const Vector2i &size, const uint8_t *data) {
+    /* Crop the center square, which is what the panel shows */
+    int side = size.minCoeff();
+    Vector2i offset = (size - Vector2i::Constant(side)) / 2;
+    const uint8_t *square = data + ((size_t) offset.y() * size.x() + offset.x()) * 4;
+    size_t stride = (size_t) size.x() * 4;
+
+    int image = mAtlases.empty() ? -1 : mAtlases.back()->add(Vector2i::Constant(side), square, stride);
+    if (image < 0) {
+        /* The current atlas is full */
+        int atlasSize = std::max(2048, side + 1);
+        mAtlases.push_back(new TextureAtlas(Vector2i::Constant(atlasSize)));
+        image = mAtlases.back()->add(Vector2i::Constant(side), square, stride);
+    }
+    mThumbnails[index] = std::make_pair((int) mAtlases.size() - 1, image);
+}
+
+void ImagePanel::requestPoll() {
+    Screen *screen = findScreen(this);
+    if (mPollRequested || !screen)
+        return;
+    mPollRequested = true;
+    ref<ImagePanel> self = this;
+    screen->requestAnimationFrame([self](double) mutable { self->pollThumbnails(); });
+}
+
+void ImagePanel::pollThumbnails() {
+    mPollRequested = false;
+    if (!mLoader)
+        return;
+    /* Redraw once further thumbnails have been decoded */
+    if (mLoader->hasDecoded())
+        markDirty();
+    else
+        requestPoll();
+}
 
 Vector2i ImagePanel::gridSize() const {
     int nCols = 1 + std::max(0,
@@ -61,12 +241,118 @@ Vector2i ImagePanel::preferredSize(NVGcontext *) const {
     );
 }
 
+void ImagePanel::drawThumbnails(NVGcontext *ctx, const std::pair<size_t, size_t> &range) {
+    Screen *screen = findScreen(this);
+    if (!screen || range.first == range.second)
+        return;
+    // Flush the NanoVG draw stack, so that the thumbnails cover what was drawn before.
+    nvgEndFrame(ctx);
+
+    if (mShader.name().empty())
+        mShader.init("ImagePanelShader", thumbnailVertexShader, thumbnailFragmentShader);
+
+    Vector2f screenSize = screen->size().cast<float>();
+    float r = screen->pixelRatio();
+    Vector2i lower, upper;
+    clipRect(lower, upper);
+    glEnable(GL_SCISSOR_TEST);
+    glScissor((GLint) (lower.x() * r), (GLint) ((screenSize.y() - upper.y()) * r),
+              (GLsizei) ((upper.x() - lower.x()) * r), (GLsizei) ((upper.y() - lower.y()) * r));
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    mShader.bind();
+    mShader.setUniform("screenSize", screenSize);
+    mShader.setUniform("thumbSize", (float) mThumbSize);
+    mShader.setUniform("atlas", 0);
+    glActiveTexture(GL_TEXTURE0);
+
+    Vector2i grid = gridSize();
+    Vector2f origin = absolutePosition().cast<float>() + Vector2f::Constant((float) mMargin);
+    float shadow = 6.f;
+
+    // One draw call per atlas; placeholders are drawn along with the first one.
+    size_t batches = std::max(mAtlases.size(), (size_t) 1);
+    for (size_t batch = 0; batch < batches; ++batch) {
+        std::vector<float> positions, locals, regions, opacities;
+        for (size_t i = range.first; i < range.second; ++i) {
+            int atlas = mThumbnails[i].first;
+            if (atlas < 0 ? batch != 0 : (size_t) atlas != batch)
+                continue;
+            bool hover = mMouseIndex == (int) i;
+
+            Vector4f region = Vector4f::Zero();
+            float opacity = hover ? -40 / 255.f : -20 / 255.f;
+            if (atlas >= 0) {
+                const TextureAtlas *a = mAtlases[atlas];
+                Vector4i rect = a->region(mThumbnails[i].second);
+                Vector2f atlasSize = a->size().cast<float>();
+                // Inset by half a texel to avoid filtering with the padding.
+                region << (rect.x() + 0.5f) / atlasSize.x(), (rect.y() + 0.5f) / atlasSize.y(),
+                          (rect.x() + rect.z() - 0.5f) / atlasSize.x(),
+                          (rect.y() + rect.w() - 0.5f) / atlasSize.y();
+                opacity = hover ? 1.f : 0.7f;
+            }
+
+            Vector2f p = origin + Vector2f((float) (i % grid.x()), (float) (i / grid.x())) *
+                                      (float) (mThumbSize + mSpacing);
+            float lo = -shadow, hi = mThumbSize + shadow;
+            for (int corner = 0; corner < 4; ++corner) {
+                Vector2f local(corner & 1 ? hi : lo, corner & 2 ? hi : lo);
+                Vector2f position = p + local;
+                positions.insert(positions.end(), { position.x(), position.y() });
+                locals.insert(locals.end(), { local.x(), local.y() });
+                regions.insert(regions.end(), { region.x(), region.y(), region.z(), region.w() });
+                opacities.push_back(opacity);
+            }
+        }
+
+        uint32_t quads = (uint32_t) opacities.size() / 4;
+        if (quads == 0)
+            continue;
+
+        MatrixXu indices(3, 2 * quads);
+        for (uint32_t q = 0; q < quads; ++q) {
+            indices.col(2 * q) << 4 * q, 4 * q + 1, 4 * q + 2;
+            indices.col(2 * q + 1) << 4 * q + 2, 4 * q + 3, 4 * q + 1;
+        }
+        mShader.uploadIndices(indices);
+        mShader.uploadAttrib("position", Eigen::Map<const MatrixXf>(positions.data(), 2, 4 * quads));
+        mShader.uploadAttrib("local", Eigen::Map<const MatrixXf>(locals.data(), 2, 4 * quads));
+        mShader.uploadAttrib("region", Eigen::Map<const MatrixXf>(regions.data(), 4, 4 * quads));
+        mShader.uploadAttrib("opacity", Eigen::Map<const MatrixXf>(opacities.data(), 1, 4 * quads));
+        glBindTexture(GL_TEXTURE_2D, batch < mAtlases.size() ? mAtlases[batch]->texture() : 0);
+        mShader.drawIndexed(GL_TRIANGLES, 0, 2 * quads);
+    }
+
+    glDisable(GL_SCISSOR_TEST);
+}
+
 void ImagePanel::draw(NVGcontext* ctx) {
+    if (mLoader)
+        updateThumbnails();
+
+    auto range = visibleRange();
+    if (!mThumbnails.empty()) {
+        drawThumbnails(ctx, range);
+        return;
+    }
+
     Vector2i grid = gridSize();
 
-    for (size_t i=0; i<mImages.size(); ++i) {
+    for (size_t i=range.first; i<range.second; ++i) {
         Vector2i p = mPos + Vector2i::Constant(mMargin) +
             Vector2i((int) i % grid.x(), (int) i / grid.x()) * (mThumbSize + mSpacing);
+
+        if (mImages[i].first == 0) {
+            // Placeholder for an image that is still being loaded.
+            nvgBeginPath(ctx);
+            nvgRoundedRect(ctx, p.x(), p.y(), mThumbSize, mThumbSize, 5);
+            nvgFillColor(ctx, Color(255, mMouseIndex == (int) i ? 40 : 20));
+            nvgFill(ctx);
+            continue;
+        }
+
         int imgw, imgh;
 
         nvgImageSize(ctx, mImages[i].first, &imgw, &imgh);
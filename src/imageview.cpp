@@ -15,8 +15,23 @@
 #include <nanogui/window.h>
 #include <nanogui/screen.h>
 #include <nanogui/theme.h>
+#include <nanogui/tiledimage.h>
+#include <nanogui_resources.h>
 #include <cmath>
 
+#if defined(__GNUC__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <stb_truetype.h>
+
+#if defined(__GNUC__)
+#  pragma GCC diagnostic pop
+#endif
+
 NAMESPACE_BEGIN(nanogui)
 
 namespace {
@@ -44,10 +59,12 @@ namespace {
         R"(#version 330
         uniform vec2 scaleFactor;
         uniform vec2 position;
+        uniform vec2 uvOffset;
+        uniform vec2 uvScale;
         in vec2 vertex;
         out vec2 uv;
         void main() {
-            uv = vertex;
+            uv = uvOffset + vertex * uvScale;
             vec2 scaledVertex = (vertex * scaleFactor) + position;
             gl_Position  = vec4(2.0*scaledVertex.x - 1.0,
                                 1.0 - 2.0*scaledVertex.y,
@@ -58,12 +75,143 @@ namespace {
     constexpr char const *const defaultImageViewFragmentShader =
         R"(#version 330
         uniform sampler2D image;
+        uniform float exposureScale;
+        uniform float invGamma;
+        uniform int channel;
+        uniform bool falseColor;
         out vec4 color;
         in vec2 uv;
+
+        // Polynomial approximation of the Turbo colormap.
+        vec3 turbo(float x) {
+            const vec4 r4 = vec4(0.13572138, 4.61539260, -42.66032258, 132.13108234);
+            const vec4 g4 = vec4(0.09140261, 2.19418839, 4.84296658, -14.18503333);
+            const vec4 b4 = vec4(0.10667330, 12.64194608, -60.58204836, 110.36276771);
+            const vec2 r2 = vec2(-152.94239396, 59.28637943);
+            const vec2 g2 = vec2(4.27729857, 2.82956604);
+            const vec2 b2 = vec2(-89.90310912, 27.34824973);
+            x = clamp(x, 0.0, 1.0);
+            vec4 v4 = vec4(1.0, x, x * x, x * x * x);
+            vec2 v2 = v4.zw * v4.z;
+            return vec3(dot(v4, r4) + dot(v2, r2),
+                        dot(v4, g4) + dot(v2, g2),
+                        dot(v4, b4) + dot(v2, b2));
+        }
+
+        void main() {
+            vec4 value = texture(image, uv);
+            value.rgb *= exposureScale;
+            color = value;
+            if (channel == 0 && !falseColor) {
+                color.rgb = pow(max(value.rgb, 0.0), vec3(invGamma));
+                return;
+            }
+
+            float scalar;
+            if (channel >= 1 && channel <= 4)
+                scalar = value[channel - 1];
+            else
+                scalar = dot(value.rgb, vec3(0.2126, 0.7152, 0.0722));
+            if (channel == 4)
+                color.a = 1.0;
+            color.rgb = falseColor ? turbo(scalar) : vec3(pow(max(scalar, 0.0), invGamma));
+        })";
+
+    // Draws the vertical grid lines followed by the horizontal ones, one instance per line.
+    constexpr char const *const pixelGridVertexShader =
+        R"(#version 330
+        uniform vec2 screenSize;
+        uniform float pixelRatio;
+        uniform vec2 imageOrigin;
+        uniform vec2 imageExtent;
+        uniform float stride;
+        uniform ivec2 firstLine;
+        uniform int columns;
+        void main() {
+            float t = float(gl_VertexID);
+            vec2 p;
+            if (gl_InstanceID < columns)
+                p = vec2(imageOrigin.x + float(firstLine.x + gl_InstanceID) * stride,
+                         imageOrigin.y + t * imageExtent.y);
+            else
+                p = vec2(imageOrigin.x + t * imageExtent.x,
+                         imageOrigin.y + float(firstLine.y + gl_InstanceID - columns) * stride);
+            // Snap the lines to the centers of physical pixels.
+            p = (round(p * pixelRatio) + 0.5) / pixelRatio;
+            gl_Position = vec4(2.0 * p.x / screenSize.x - 1.0,
+                               1.0 - 2.0 * p.y / screenSize.y,
+                               0.0, 1.0);
+        })";
+
+    constexpr char const *const pixelGridFragmentShader =
+        R"(#version 330
+        uniform vec4 color;
+        out vec4 fragColor;
+        void main() {
+            fragColor = color;
+        })";
+
+    // Draws glyph quads whose positions are given in units of image pixels.
+    constexpr char const *const pixelInfoVertexShader =
+        R"(#version 330
+        uniform vec2 screenSize;
+        uniform vec2 origin;
+        uniform float stride;
+        in vec2 position;
+        in vec2 texcoord;
+        in vec4 color;
+        out vec2 uv;
+        out vec4 textColor;
+        void main() {
+            vec2 p = origin + position * stride;
+            uv = texcoord;
+            textColor = color;
+            gl_Position = vec4(2.0 * p.x / screenSize.x - 1.0,
+                               1.0 - 2.0 * p.y / screenSize.y,
+                               0.0, 1.0);
+        })";
+
+    constexpr char const *const pixelInfoFragmentShader =
+        R"(#version 330
+        uniform sampler2D glyphs;
+        in vec2 uv;
+        in vec4 textColor;
+        out vec4 fragColor;
         void main() {
-            color = texture(image, uv);
+            fragColor = vec4(textColor.rgb, textColor.a * texture(glyphs, uv).r);
         })";
 
+    /* Printable ASCII characters of the regular font, rasterized once and
+       scaled to the font size of the pixel information */
+    struct GlyphAtlas {
+        static constexpr int width = 512, height = 512, firstChar = 32, charCount = 95;
+        static constexpr float pixelHeight = 40.f;
+        std::vector<uint8_t> bitmap;
+        stbtt_bakedchar chars[charCount];
+        float ascent;
+
+        GlyphAtlas() : bitmap(width * height) {
+            if (stbtt_BakeFontBitmap(roboto_regular_ttf, 0, pixelHeight, bitmap.data(),
+                                     width, height, firstChar, charCount, chars) <= 0)
+                throw std::runtime_error("ImageView: could not rasterize the glyph atlas!");
+            stbtt_fontinfo font;
+            stbtt_InitFont(&font, roboto_regular_ttf, 0);
+            int ascentUnits, descentUnits, lineGap;
+            stbtt_GetFontVMetrics(&font, &ascentUnits, &descentUnits, &lineGap);
+            ascent = ascentUnits * stbtt_ScaleForPixelHeight(&font, pixelHeight);
+        }
+
+        const stbtt_bakedchar &glyph(char c) const {
+            int index = (unsigned char) c - firstChar;
+            return chars[index >= 0 && index < charCount ? index : '?' - firstChar];
+        }
+    };
+
+    const GlyphAtlas &glyphAtlas() {
+        static const GlyphAtlas atlas;
+        return atlas;
+    }
+
 }
 
 ImageView::ImageView(Widget* parent, GLuint imageID)
@@ -86,18 +234,52 @@ ImageView::ImageView(Widget* parent, GLuint imageID)
     mShader.bind();
     mShader.uploadIndices(indices);
     mShader.uploadAttrib("vertex", vertices);
+
+    mGridShader.init("ImageViewGridShader", pixelGridVertexShader,
+                     pixelGridFragmentShader);
+    mPixelInfoShader.init("ImageViewPixelInfoShader", pixelInfoVertexShader,
+                          pixelInfoFragmentShader);
 }
 
 ImageView::~ImageView() {
+    delete mTileCache;
     mShader.free();
+    mGridShader.free();
+    mPixelInfoShader.free();
+    if (mGlyphTexture)
+        glDeleteTextures(1, &mGlyphTexture);
 }
 
 void ImageView::bindImage(GLuint imageId) {
+    delete mTileCache;
+    mTileCache = nullptr;
     mImageID = imageId;
     updateImageParameters();
+    invalidatePixelInfo();
+    fit();
+}
+
+void ImageView::bindTiledImage(TiledImageSource *source) {
+    ref<TiledImageSource> keepAlive = source;
+    delete mTileCache;
+    mTileCache = new TileCache(source);
+    mTileCache->setMemoryBudget(mTileMemoryBudget);
+    mImageID = 0;
+    mImageSize = source->size();
+    invalidatePixelInfo();
     fit();
 }
 
+TiledImageSource *ImageView::tiledImage() {
+    return mTileCache ? mTileCache->source() : nullptr;
+}
+
+void ImageView::setTileMemoryBudget(size_t budget) {
+    mTileMemoryBudget = budget;
+    if (mTileCache)
+        mTileCache->setMemoryBudget(budget);
+}
+
 Vector2f ImageView::imageCoordinateAt(const Vector2f& position) const {
     auto imagePosition = position - mOffset;
     return imagePosition / mScale;
@@ -119,10 +301,12 @@ void ImageView::setImageCoordinateAt(const Vector2f& position, const Vector2f& i
 
     // Clamp offset so that the image remains near the screen.
     mOffset = mOffset.cwiseMin(sizeF()).cwiseMax(-scaledImageSizeF());
+    markDirty();
 }
 
 void ImageView::center() {
     mOffset = (sizeF() - scaledImageSizeF()) / 2;
+    markDirty();
 }
 
 void ImageView::fit() {
@@ -174,7 +358,8 @@ bool ImageView::gridVisible() const {
 }
 
 bool ImageView::pixelInfoVisible() const {
-    return mPixelInfoCallback && (mPixelInfoThreshold != -1) && (mScale > mPixelInfoThreshold);
+    return (mPixelInfoCallback || mPixelInfoBatchCallback) && (mPixelInfoThreshold != -1) &&
+           (mScale > mPixelInfoThreshold);
 }
 
 bool ImageView::helpersVisible() const {
@@ -305,19 +490,111 @@ void ImageView::draw(NVGcontext* ctx) {
               size().x() * r, size().y() * r);
     mShader.bind();
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, mImageID);
     mShader.setUniform("image", 0);
-    mShader.setUniform("scaleFactor", scaleFactor);
-    mShader.setUniform("position", imagePosition);
-    mShader.drawIndexed(GL_TRIANGLES, 0, 2);
+    // Custom image shaders need not support tone mapping.
+    mShader.setUniform("exposureScale", std::exp2(mExposure), false);
+    mShader.setUniform("invGamma", 1.f / mGamma, false);
+    mShader.setUniform("channel", (int) mChannel, false);
+    mShader.setUniform("falseColor", mFalseColor, false);
+    if (mTileCache) {
+        drawTiles(screenSize, r);
+    } else {
+        glBindTexture(GL_TEXTURE_2D, mImageID);
+        mShader.setUniform("scaleFactor", scaleFactor);
+        mShader.setUniform("position", imagePosition);
+        mShader.setUniform("uvOffset", Vector2f(0.f, 0.f), false);
+        mShader.setUniform("uvScale", Vector2f(1.f, 1.f), false);
+        mShader.drawIndexed(GL_TRIANGLES, 0, 2);
+    }
+    if (helpersVisible())
+        drawHelpers(screenSize, r);
     glDisable(GL_SCISSOR_TEST);
 
-    if (helpersVisible())
-        drawHelpers(ctx);
+    // Keep redrawing while tiles are being streamed in.
+    if (mTileCache && !mTilePollRequested && mTileCache->busy()) {
+        mTilePollRequested = true;
+        ref<ImageView> self = this;
+        const_cast<Screen*>(screen)->requestAnimationFrame(
+            [self](double) mutable { self->pollTiles(); });
+    }
 
     drawWidgetBorder(ctx);
 }
 
+void ImageView::drawTiles(const Vector2f& screenSize, float pixelRatio) {
+    TiledImageSource* source = mTileCache->source();
+    mTileCache->beginFrame();
+    mTileCache->upload(mTileUploadBudget);
+
+    // Pick the finest level whose pixels are not smaller than those of the screen.
+    int tileSize = source->tileSize(), coarsest = source->levelCount() - 1;
+    float screenPixelsPerPixel = mScale * pixelRatio;
+    int level = screenPixelsPerPixel >= 1 ? 0 : (int) std::floor(std::log2(1 / screenPixelsPerPixel));
+    level = std::min(level, coarsest);
+
+    // The range of tiles that intersect the widget.
+    float levelTileSize = (float) tileSize * (1 << level);
+    Vector2i count = source->tileCount(level);
+    Vector2i first = (clampedImageCoordinateAt(Vector2f::Zero()) / levelTileSize)
+                         .unaryExpr([](float x) { return std::floor(x); }).cast<int>()
+                         .cwiseMax(Vector2i::Zero());
+    Vector2i last = (clampedImageCoordinateAt(sizeF()) / levelTileSize)
+                        .unaryExpr([](float x) { return std::ceil(x); }).cast<int>()
+                        .cwiseMin(count);
+
+    Vector2f imageOrigin = absolutePosition().cast<float>() + mOffset;
+    for (int y = first.y(); y < last.y(); ++y) {
+        for (int x = first.x(); x < last.x(); ++x) {
+            Vector2i tile(x, y);
+
+            // Fall back to the finest resident tile of a coarser level.
+            int l = level;
+            GLuint texture = mTileCache->texture(level, tile);
+            if (!texture) {
+                mTileCache->request(level, tile);
+                // Make sure that the coarsest level is always available.
+                mTileCache->request(coarsest, tile / (1 << (coarsest - level)));
+                for (l = level + 1; l <= coarsest && !texture; ++l)
+                    texture = mTileCache->texture(l, tile / (1 << (l - level)));
+                --l;
+            }
+            if (!texture)
+                continue;
+
+            // The area of the image covered by the tile (in pixels of level 0).
+            Vector2f origin = tile.cast<float>() * levelTileSize;
+            Vector2f extent = (origin + Vector2f::Constant(levelTileSize))
+                                  .cwiseMin(imageSizeF()) - origin;
+
+            // Its texture coordinates within the tile of level l.
+            float levelScale = 1.f / (float) (1 << l);
+            Vector2i parent = tile / (1 << (l - level));
+            Vector2f uvOffset = (origin * levelScale - parent.cast<float>() * (float) tileSize) / (float) tileSize;
+            Vector2f uvScale = extent * levelScale / (float) tileSize;
+
+            glBindTexture(GL_TEXTURE_2D, texture);
+            mShader.setUniform("scaleFactor", Vector2f(mScale * extent.cwiseQuotient(screenSize)));
+            mShader.setUniform("position", Vector2f((imageOrigin + mScale * origin).cwiseQuotient(screenSize)));
+            mShader.setUniform("uvOffset", uvOffset);
+            mShader.setUniform("uvScale", uvScale);
+            mShader.drawIndexed(GL_TRIANGLES, 0, 2);
+        }
+    }
+}
+
+void ImageView::pollTiles() {
+    mTilePollRequested = false;
+    if (!mTileCache)
+        return;
+    if (mTileCache->hasLoadedTiles()) {
+        markDirty();
+    } else if (mTileCache->busy()) {
+        mTilePollRequested = true;
+        ref<ImageView> self = this;
+        screen()->requestAnimationFrame([self](double) mutable { self->pollTiles(); });
+    }
+}
+
 void ImageView::updateImageParameters() {
     // Query the width of the OpenGL texture.
     glBindTexture(GL_TEXTURE_2D, mImageID);
@@ -357,43 +634,45 @@ void ImageView::drawImageBorder(NVGcontext* ctx) const {
     nvgRestore(ctx);
 }
 
-void ImageView::drawHelpers(NVGcontext* ctx) const {
-    // We need to apply mPos after the transformation to account for the position of the widget
-    // relative to the parent.
-    Vector2f upperLeftCorner = positionForCoordinate(Vector2f::Zero()) + positionF();
-    Vector2f lowerRightCorner = positionForCoordinate(imageSizeF()) + positionF();
+void ImageView::drawHelpers(const Vector2f& screenSize, float pixelRatio) {
+    // The overlays are drawn in screen coordinates on top of the image.
+    Vector2f imageOrigin = absolutePosition().cast<float>() + mOffset;
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     if (gridVisible())
-        drawPixelGrid(ctx, upperLeftCorner, lowerRightCorner, mScale);
+        drawPixelGrid(screenSize, pixelRatio, imageOrigin, mScale);
     if (pixelInfoVisible())
-        drawPixelInfo(ctx, mScale);
+        drawPixelInfo(screenSize, imageOrigin, mScale);
 }
 
-void ImageView::drawPixelGrid(NVGcontext* ctx, const Vector2f& upperLeftCorner,
-                              const Vector2f& lowerRightCorner, float stride) {
-    nvgBeginPath(ctx);
-
-    // Draw the vertical grid lines
-    float currentX = upperLeftCorner.x();
-    while (currentX <= lowerRightCorner.x()) {
-        nvgMoveTo(ctx, std::round(currentX), std::round(upperLeftCorner.y()));
-        nvgLineTo(ctx, std::round(currentX), std::round(lowerRightCorner.y()));
-        currentX += stride;
-    }
-
-    // Draw the horizontal grid lines
-    float currentY = upperLeftCorner.y();
-    while (currentY <= lowerRightCorner.y()) {
-        nvgMoveTo(ctx, std::round(upperLeftCorner.x()), std::round(currentY));
-        nvgLineTo(ctx, std::round(lowerRightCorner.x()), std::round(currentY));
-        currentY += stride;
-    }
+void ImageView::drawPixelGrid(const Vector2f& screenSize, float pixelRatio,
+                              const Vector2f& imageOrigin, float stride) {
+    // Only the lines that cross the widget are drawn.
+    Vector2f widgetPosition = absolutePosition().cast<float>();
+    Vector2i firstLine = ((widgetPosition - imageOrigin) / stride)
+                             .unaryExpr([](float x) { return std::ceil(x); }).cast<int>()
+                             .cwiseMax(Vector2i::Zero());
+    Vector2i lastLine = ((widgetPosition + sizeF() - imageOrigin) / stride)
+                            .unaryExpr([](float x) { return std::floor(x); }).cast<int>()
+                            .cwiseMin(mImageSize);
+    Vector2i lineCount = (lastLine - firstLine + Vector2i::Ones()).cwiseMax(Vector2i::Zero());
+    if (lineCount.sum() == 0)
+        return;
 
-    nvgStrokeWidth(ctx, 1.0f);
-    nvgStrokeColor(ctx, Color(1.0f, 1.0f, 1.0f, 0.2f));
-    nvgStroke(ctx);
+    mGridShader.bind();
+    mGridShader.setUniform("screenSize", screenSize);
+    mGridShader.setUniform("pixelRatio", pixelRatio);
+    mGridShader.setUniform("imageOrigin", imageOrigin);
+    mGridShader.setUniform("imageExtent", Vector2f(imageSizeF() * stride));
+    mGridShader.setUniform("stride", stride);
+    mGridShader.setUniform("firstLine", firstLine);
+    mGridShader.setUniform("columns", lineCount.x());
+    mGridShader.setUniform("color", Color(1.0f, 1.0f, 1.0f, 0.2f));
+    mGridShader.drawArrayInstanced(GL_LINES, 0, 2, (uint32_t) lineCount.sum());
 }
 
-void ImageView::drawPixelInfo(NVGcontext* ctx, float stride) const {
+void ImageView::drawPixelInfo(const Vector2f& screenSize, const Vector2f& imageOrigin,
+                              float stride) {
     // Extract the image coordinates at the two corners of the widget.
     Vector2i topLeft = clampedImageCoordinateAt(Vector2f::Zero())
                            .unaryExpr([](float x) { return std::floor(x); })
@@ -403,50 +682,127 @@ void ImageView::drawPixelInfo(NVGcontext* ctx, float stride) const {
                                .unaryExpr([](float x) { return std::ceil(x); })
                                .cast<int>();
 
-    // Extract the positions for where to draw the text.
-    Vector2f currentCellPosition =
-        (positionF() + positionForCoordinate(topLeft.cast<float>()));
-
-    float xInitialPosition = currentCellPosition.x();
-    int xInitialIndex = topLeft.x();
-
     // Properly scale the pixel information for the given stride.
-    auto fontSize = stride * mFontScaleFactor;
     static constexpr float maxFontSize = 30.0f;
-    fontSize = fontSize > maxFontSize ? maxFontSize : fontSize;
-    nvgBeginPath(ctx);
-    nvgFontSize(ctx, fontSize);
-    nvgTextAlign(ctx, NVG_ALIGN_CENTER | NVG_ALIGN_TOP);
-    nvgFontFace(ctx, "sans");
-    while (topLeft.y() != bottomRight.y()) {
-        while (topLeft.x() != bottomRight.x()) {
-            writePixelInfo(ctx, currentCellPosition, topLeft, stride, fontSize);
-            currentCellPosition.x() += stride;
-            ++topLeft.x();
+    float fontSize = std::min(stride * mFontScaleFactor, maxFontSize);
+
+    // The glyph quads only need to be rebuilt when the visible pixels or
+    // the font size relative to a pixel change.
+    if (topLeft != mPixelInfoFirst || bottomRight - topLeft != mPixelInfoCount) {
+        updatePixelInfo(topLeft, bottomRight - topLeft);
+        updatePixelInfoQuads(fontSize / stride);
+    } else if (fontSize / stride != mPixelInfoFontScale) {
+        updatePixelInfoQuads(fontSize / stride);
+    }
+    if (mPixelInfoQuads == 0)
+        return;
+
+    if (!mGlyphTexture) {
+        const GlyphAtlas &atlas = glyphAtlas();
+        glGenTextures(1, &mGlyphTexture);
+        glBindTexture(GL_TEXTURE_2D, mGlyphTexture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, atlas.width, atlas.height, 0, GL_RED,
+                     GL_UNSIGNED_BYTE, atlas.bitmap.data());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    mPixelInfoShader.bind();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, mGlyphTexture);
+    mPixelInfoShader.setUniform("glyphs", 0);
+    mPixelInfoShader.setUniform("screenSize", screenSize);
+    mPixelInfoShader.setUniform("origin", Vector2f(imageOrigin + mPixelInfoFirst.cast<float>() * stride));
+    mPixelInfoShader.setUniform("stride", stride);
+    mPixelInfoShader.drawIndexed(GL_TRIANGLES, 0, 2 * mPixelInfoQuads);
+}
+
+void ImageView::updatePixelInfo(const Vector2i& first, const Vector2i& count) {
+    std::vector<PixelInfo> pixelInfo((size_t) count.x() * (size_t) count.y());
+
+    if (mPixelInfoBatchCallback) {
+        auto batch = mPixelInfoBatchCallback(first, count);
+        if (batch.size() != pixelInfo.size())
+            throw std::runtime_error("ImageView: the pixel info batch callback returned " +
+                                     std::to_string(batch.size()) + " entries, expected " +
+                                     std::to_string(pixelInfo.size()) + "!");
+        for (size_t i = 0; i < batch.size(); ++i)
+            pixelInfo[i] = PixelInfo { tokenize(batch[i].first), batch[i].second };
+    } else {
+        // Reuse the information of the pixels that remain visible.
+        for (int y = 0; y < count.y(); ++y) {
+            for (int x = 0; x < count.x(); ++x) {
+                Vector2i pixel = first + Vector2i(x, y), cached = pixel - mPixelInfoFirst;
+                PixelInfo &info = pixelInfo[(size_t) y * count.x() + x];
+                if ((cached.array() >= 0).all() && (cached.array() < mPixelInfoCount.array()).all()) {
+                    info = std::move(mPixelInfo[(size_t) cached.y() * mPixelInfoCount.x() + cached.x()]);
+                } else {
+                    auto pixelData = mPixelInfoCallback(pixel);
+                    info = PixelInfo { tokenize(pixelData.first), pixelData.second };
+                }
+            }
         }
-        currentCellPosition.x() = xInitialPosition;
-        currentCellPosition.y() += stride;
-        ++topLeft.y();
-        topLeft.x() = xInitialIndex;
     }
+
+    mPixelInfo = std::move(pixelInfo);
+    mPixelInfoFirst = first;
+    mPixelInfoCount = count;
 }
 
-void ImageView::writePixelInfo(NVGcontext* ctx, const Vector2f& cellPosition,
-                               const Vector2i& pixel, float stride, float fontSize) const {
-    auto pixelData = mPixelInfoCallback(pixel);
-    auto pixelDataRows = tokenize(pixelData.first);
+void ImageView::updatePixelInfoQuads(float fontScale) {
+    const GlyphAtlas &atlas = glyphAtlas();
+    // Size of a pixel of the glyph atlas in units of image pixels.
+    float texelScale = fontScale / atlas.pixelHeight;
+
+    std::vector<float> positions, texcoords, colors;
+    for (int y = 0; y < mPixelInfoCount.y(); ++y) {
+        for (int x = 0; x < mPixelInfoCount.x(); ++x) {
+            const PixelInfo &info = mPixelInfo[(size_t) y * mPixelInfoCount.x() + x];
+            // Center the rows of text within the pixel.
+            float top = y + (1 - fontScale * info.rows.size()) / 2;
+            for (const std::string &row : info.rows) {
+                float width = 0;
+                for (char c : row)
+                    width += atlas.glyph(c).xadvance;
+                float penX = x + 0.5f - width * texelScale / 2;
+                float baseline = top + atlas.ascent * texelScale;
+                for (char c : row) {
+                    const stbtt_bakedchar &g = atlas.glyph(c);
+                    float x0 = penX + g.xoff * texelScale, y0 = baseline + g.yoff * texelScale;
+                    float x1 = x0 + (g.x1 - g.x0) * texelScale, y1 = y0 + (g.y1 - g.y0) * texelScale;
+                    float u0 = g.x0 / (float) atlas.width, v0 = g.y0 / (float) atlas.height;
+                    float u1 = g.x1 / (float) atlas.width, v1 = g.y1 / (float) atlas.height;
+                    positions.insert(positions.end(), { x0, y0, x1, y0, x0, y1, x1, y1 });
+                    texcoords.insert(texcoords.end(), { u0, v0, u1, v0, u0, v1, u1, v1 });
+                    for (int i = 0; i < 4; ++i)
+                        colors.insert(colors.end(), { info.color.r(), info.color.g(),
+                                                      info.color.b(), info.color.w() });
+                    penX += g.xadvance * texelScale;
+                }
+                top += fontScale;
+            }
+        }
+    }
 
-    // If no data is provided for this pixel then simply return.
-    if (pixelDataRows.empty())
+    mPixelInfoFontScale = fontScale;
+    mPixelInfoQuads = (uint32_t) (positions.size() / 8);
+    if (mPixelInfoQuads == 0)
         return;
 
-    nvgFillColor(ctx, pixelData.second);
-    float yOffset = (stride - fontSize * pixelDataRows.size()) / 2;
-    for (size_t i = 0; i != pixelDataRows.size(); ++i) {
-        nvgText(ctx, cellPosition.x() + stride / 2, cellPosition.y() + yOffset,
-                pixelDataRows[i].data(), nullptr);
-        yOffset += fontSize;
+    MatrixXu indices(3, 2 * mPixelInfoQuads);
+    for (uint32_t i = 0; i < mPixelInfoQuads; ++i) {
+        indices.col(2 * i) << 4 * i, 4 * i + 1, 4 * i + 2;
+        indices.col(2 * i + 1) << 4 * i + 2, 4 * i + 3, 4 * i + 1;
     }
+
+    mPixelInfoShader.bind();
+    mPixelInfoShader.uploadIndices(indices);
+    mPixelInfoShader.uploadAttrib("position", Eigen::Map<const MatrixXf>(positions.data(), 2, 4 * mPixelInfoQuads));
+    mPixelInfoShader.uploadAttrib("texcoord", Eigen::Map<const MatrixXf>(texcoords.data(), 2, 4 * mPixelInfoQuads));
+    mPixelInfoShader.uploadAttrib("color", Eigen::Map<const MatrixXf>(colors.data(), 4, 4 * mPixelInfoQuads));
 }
 
 NAMESPACE_END(nanogui)
@@ -12,6 +12,7 @@
 #include <nanogui/label.h>
 #include <nanogui/theme.h>
 #include <nanogui/opengl.h>
+#include <nanogui/textmetrics.h>
 #include <nanogui/serializer/core.h>
 
 NAMESPACE_BEGIN(nanogui)
@@ -36,17 +37,15 @@ void Label::setTheme(Theme *theme) {
 Vector2i Label::preferredSize(NVGcontext *ctx) const {
     if (mCaption == "")
         return Vector2i::Zero();
-    nvgFontFace(ctx, mFont.c_str());
-    nvgFontSize(ctx, fontSize());
     if (mFixedSize.x() > 0) {
         float bounds[4];
-        nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
-        nvgTextBoxBounds(ctx, mPos.x(), mPos.y(), mFixedSize.x(), mCaption.c_str(), nullptr, bounds);
+        textBoxBounds(ctx, mFont, fontSize(), NVG_ALIGN_LEFT | NVG_ALIGN_TOP, 1.f,
+                      mPos.x(), mPos.y(), mFixedSize.x(), mCaption, bounds);
         return Vector2i(mFixedSize.x(), bounds[3] - bounds[1]);
     } else {
-        nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
         return Vector2i(
-            nvgTextBounds(ctx, 0, 0, mCaption.c_str(), nullptr, nullptr) + 2,
+            textBounds(ctx, mFont, fontSize(), NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE,
+                       0, 0, mCaption) + 2,
             fontSize()
         );
     }
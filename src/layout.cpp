@@ -20,6 +20,11 @@
 
 NAMESPACE_BEGIN(nanogui)
 
+void Layout::invalidate() {
+    for (auto widget : mWidgets)
+        widget->invalidateLayout();
+}
+
 BoxLayout::BoxLayout(Orientation orientation, Alignment alignment,
           int margin, int spacing)
     : mOrientation(orientation), mAlignment(alignment), mMargin(margin),
@@ -48,7 +53,7 @@ Vector2i BoxLayout::preferredSize(NVGcontext *ctx, const Widget *widget) const {
         else
             size[axis1] += mSpacing;
 
-        Vector2i ps = w->preferredSize(ctx), fs = w->fixedSize();
+        Vector2i ps = w->cachedPreferredSize(ctx), fs = w->fixedSize();
         Vector2i targetSize(
             fs[0] ? fs[0] : ps[0],
             fs[1] ? fs[1] : ps[1]
@@ -91,7 +96,7 @@ void BoxLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
         else
             position += mSpacing;
 
-        Vector2i ps = w->preferredSize(ctx), fs = w->fixedSize();
+        Vector2i ps = w->cachedPreferredSize(ctx), fs = w->fixedSize();
         Vector2i targetSize(
             fs[0] ? fs[0] : ps[0],
             fs[1] ? fs[1] : ps[1]
@@ -118,7 +123,7 @@ void BoxLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
 
         w->setPosition(pos);
         w->setSize(targetSize);
-        w->performLayout(ctx);
+        w->performLayoutIfNeeded(ctx);
         position += targetSize[axis1];
     }
 }
@@ -139,7 +144,7 @@ Vector2i GroupLayout::preferredSize(NVGcontext *ctx, const Widget *widget) const
             height += (label == nullptr) ? mSpacing : mGroupSpacing;
         first = false;
 
-        Vector2i ps = c->preferredSize(ctx), fs = c->fixedSize();
+        Vector2i ps = c->cachedPreferredSize(ctx), fs = c->fixedSize();
         Vector2i targetSize(
             fs[0] ? fs[0] : ps[0],
             fs[1] ? fs[1] : ps[1]
@@ -175,7 +180,7 @@ void GroupLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
 
         bool indentCur = indent && label == nullptr;
         Vector2i ps = Vector2i(availableWidth - (indentCur ? mGroupIndent : 0),
-                               c->preferredSize(ctx).y());
+                               c->cachedPreferredSize(ctx).y());
         Vector2i fs = c->fixedSize();
 
         Vector2i targetSize(
@@ -185,7 +190,7 @@ void GroupLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
 
         c->setPosition(Vector2i(mMargin + (indentCur ? mGroupIndent : 0), height));
         c->setSize(targetSize);
-        c->performLayout(ctx);
+        c->performLayoutIfNeeded(ctx);
 
         height += targetSize.y();
 
@@ -237,7 +242,7 @@ void GridLayout::computeLayout(NVGcontext *ctx, const Widget *widget, std::vecto
                 w = widget->children()[child++];
             } while (!w->visible());
 
-            Vector2i ps = w->preferredSize(ctx);
+            Vector2i ps = w->cachedPreferredSize(ctx);
             Vector2i fs = w->fixedSize();
             Vector2i targetSize(
                 fs[0] ? fs[0] : ps[0],
@@ -257,7 +262,9 @@ void GridLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
         fs_w[1] ? fs_w[1] : widget->height()
     );
 
-    /* Compute minimum row / column sizes */
+    /* Compute minimum row / column sizes (measuring the children
+       concurrently during a parallel layout) */
+    Widget::cachePreferredSizes(ctx, widget->children());
     std::vector<int> grid[2];
     computeLayout(ctx, widget, grid);
     int dim[2] = { (int) grid[0].size(), (int) grid[1].size() };
@@ -293,19 +300,22 @@ void GridLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
 
     size_t numChildren = widget->children().size();
     size_t child = 0;
+    std::vector<Widget *> placed;
 
     Vector2i pos = start;
-    for (int i2 = 0; i2 < dim[axis2]; i2++) {
+    for (int i2 = 0; i2 < dim[axis2] && child < numChildren; i2++) {
         pos[axis1] = start[axis1];
         for (int i1 = 0; i1 < dim[axis1]; i1++) {
             Widget *w = nullptr;
-            do {
-                if (child >= numChildren)
-                    return;
+            while (!w && child < numChildren) {
                 w = widget->children()[child++];
-            } while (!w->visible());
+                if (!w->visible())
+                    w = nullptr;
+            }
+            if (!w)
+                break;
 
-            Vector2i ps = w->preferredSize(ctx);
+            Vector2i ps = w->cachedPreferredSize(ctx);
             Vector2i fs = w->fixedSize();
             Vector2i targetSize(
                 fs[0] ? fs[0] : ps[0],
@@ -334,11 +344,14 @@ void GridLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
             }
             w->setPosition(itemPos);
             w->setSize(targetSize);
-            w->performLayout(ctx);
+            placed.push_back(w);
             pos[axis1] += grid[axis1][i1] + mSpacing[axis1];
         }
         pos[axis2] += grid[axis2][i2] + mSpacing[axis2];
     }
+
+    /* The children are independent once placed */
+    Widget::performLayouts(ctx, placed);
 }
 
 AdvancedGridLayout::AdvancedGridLayout(const std::vector<int> &cols, const std::vector<int> &rows, int margin)
@@ -386,7 +399,7 @@ void AdvancedGridLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
 
             int itemPos = grid[axis][anchor.pos[axis]];
             int cellSize  = grid[axis][anchor.pos[axis] + anchor.size[axis]] - itemPos;
-            int ps = w->preferredSize(ctx)[axis], fs = w->fixedSize()[axis];
+            int ps = w->cachedPreferredSize(ctx)[axis], fs = w->fixedSize()[axis];
             int targetSize = fs ? fs : ps;
 
             switch (anchor.align[axis]) {
@@ -408,7 +421,7 @@ void AdvancedGridLayout::performLayout(NVGcontext *ctx, Widget *widget) const {
             size[axis] = targetSize;
             w->setPosition(pos);
             w->setSize(size);
-            w->performLayout(ctx);
+            w->performLayoutIfNeeded(ctx);
         }
     }
 }
@@ -442,7 +455,7 @@ void AdvancedGridLayout::computeLayout(NVGcontext *ctx, const Widget *widget,
                 const Anchor &anchor = pair.second;
                 if ((anchor.size[axis] == 1) != (phase == 0))
                     continue;
-                int ps = w->preferredSize(ctx)[axis], fs = w->fixedSize()[axis];
+                int ps = w->cachedPreferredSize(ctx)[axis], fs = w->fixedSize()[axis];
                 int targetSize = fs ? fs : ps;
 
                 if (anchor.pos[axis] + anchor.size[axis] > (int) grid.size())
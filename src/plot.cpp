@@ -0,0 +1,384 @@
+/*
+    src/plot.cpp -- Plot of many long time series that are rendered with
+    OpenGL
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/plot.h>
+#include <nanogui/opengl.h>
+#include <nanogui/serializer/core.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Round the spacing of roughly 'count' ticks to 1, 2 or 5 times a power of ten */
+static double tickSpacing(double range, int count) {
+    double step = range / (double) std::max(count, 1),
+           magnitude = std::pow(10.0, std::floor(std::log10(step))),
+           fraction = step / magnitude;
+    return magnitude * (fraction <= 1 ? 1 : fraction <= 2 ? 2 : fraction <= 5 ? 5 : 10);
+}
+
+Plot::Plot(Widget *parent)
+    : GLCanvas(parent), mXRange(0.0, 1.0), mYRange(0.f, 1.f),
+      mAxisColor(255, 160), mAutoScroll(false) {
+    mBackgroundColor = Color(35, 255);
+    mDrawBorder = false;
+
+    /* Samples are positioned relative to the left edge of the view, which
+       the CPU computes in double precision */
+    mShader.init(
+        "plot_shader",
+
+        /* Vertex shader */
+        "#version 330\n"
+        "uniform vec2 viewSize;\n"
+        "uniform float yMin;\n"
+        "uniform float xBase;\n"
+        "uniform float xStep;\n"
+        "uniform int firstVertex;\n"
+        "in float value;\n"
+        "void main() {\n"
+        "    float x = (xBase + float(gl_VertexID - firstVertex) * xStep) / viewSize.x;\n"
+        "    float y = (value - yMin) / viewSize.y;\n"
+        "    gl_Position = vec4(2.0 * x - 1.0, 2.0 * y - 1.0, 0.0, 1.0);\n"
+        "}",
+
+        /* Fragment shader */
+        "#version 330\n"
+        "uniform vec4 color;\n"
+        "out vec4 outColor;\n"
+        "void main() {\n"
+        "    outColor = color;\n"
+        "}"
+    );
+}
+
+Plot::~Plot() {
+    for (auto &s : mSeries)
+        glDeleteBuffers(1, &s.buffer);
+    mShader.free();
+}
+
+Plot::Series &Plot::series(int index) {
+    if (index < 0 || index >= (int) mSeries.size())
+        throw std::runtime_error("Plot: invalid series index!");
+    return mSeries[index];
+}
+
+const Plot::Series &Plot::series(int index) const {
+    if (index < 0 || index >= (int) mSeries.size())
+        throw std::runtime_error("Plot: invalid series index!");
+    return mSeries[index];
+}
+
+int Plot::addSeries(const std::string &name, size_t capacity, const Color &color) {
+    if (capacity == 0)
+        throw std::runtime_error("Plot::addSeries(): the capacity must be positive!");
+
+    Series s;
+    s.name = name;
+    s.color = color;
+    s.visible = true;
+    s.capacity = capacity;
+    s.start = s.size = s.total = 0;
+    s.xStart = 0.0;
+    s.xStep = 1.0;
+    s.min = std::numeric_limits<float>::infinity();
+    s.max = -std::numeric_limits<float>::infinity();
+
+    glGenBuffers(1, &s.buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, s.buffer);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) ((capacity + 1) * sizeof(float)),
+                 nullptr, GL_DYNAMIC_DRAW);
+
+    mSeries.push_back(s);
+    markDirty();
+    return (int) mSeries.size() - 1;
+}
+
+void Plot::removeSeries(int index) {
+    glDeleteBuffers(1, &series(index).buffer);
+    mSeries.erase(mSeries.begin() + index);
+    markDirty();
+}
+
+void Plot::setSeriesSampling(int index, double start, double step) {
+    Series &s = series(index);
+    s.xStart = start;
+    s.xStep = step;
+    markDirty();
+}
+
+void Plot::upload(Series &s, size_t pos, const float *values, size_t count) {
+    if (count == 0)
+        return;
+
+    Eigen::Map<const Eigen::ArrayXf> map(values, (Eigen::Index) count);
+    s.min = std::min(s.min, map.minCoeff());
+    s.max = std::max(s.max, map.maxCoeff());
+
+    glBindBuffer(GL_ARRAY_BUFFER, s.buffer);
+    while (count > 0) {
+        size_t n = std::min(count, s.capacity - pos);
+        glBufferSubData(GL_ARRAY_BUFFER, (GLintptr) (pos * sizeof(float)),
+                        (GLsizeiptr) (n * sizeof(float)), values);
+        if (pos == 0)
+            glBufferSubData(GL_ARRAY_BUFFER, (GLintptr) (s.capacity * sizeof(float)),
+                            (GLsizeiptr) sizeof(float), values);
+        values += n;
+        count -= n;
+        pos = 0;
+    }
+}
+
+void Plot::setSeriesData(int index, size_t offset, const float *values, size_t count) {
+    Series &s = series(index);
+    if (offset > s.size || offset + count > s.capacity)
+        throw std::runtime_error("Plot::setSeriesData(): range out of bounds!");
+
+    upload(s, (s.start + offset) % s.capacity, values, count);
+    size_t size = std::max(s.size, offset + count);
+    s.total += size - s.size;
+    s.size = size;
+    markDirty();
+}
+
+void Plot::appendSeries(int index, const float *values, size_t count) {
+    Series &s = series(index);
+
+    /* Only the last 'capacity' samples survive */
+    if (count > s.capacity) {
+        s.total += count - s.capacity;
+        values += count - s.capacity;
+        count = s.capacity;
+    }
+
+    upload(s, (s.start + s.size) % s.capacity, values, count);
+    size_t overflow = std::max(s.size + count, s.capacity) - s.capacity;
+    s.start = (s.start + overflow) % s.capacity;
+    s.size = std::min(s.size + count, s.capacity);
+    s.total += count;
+    markDirty();
+}
+
+void Plot::fitView() {
+    double xMin = std::numeric_limits<double>::infinity(), xMax = -xMin;
+    float yMin = std::numeric_limits<float>::infinity(), yMax = -yMin;
+    for (const auto &s : mSeries) {
+        if (!s.visible || s.size == 0)
+            continue;
+        double x0 = s.xStart + (double) (s.total - s.size) * s.xStep,
+               x1 = s.xStart + (double) (s.total - 1) * s.xStep;
+        xMin = std::min(xMin, std::min(x0, x1));
+        xMax = std::max(xMax, std::max(x0, x1));
+        yMin = std::min(yMin, s.min);
+        yMax = std::max(yMax, s.max);
+    }
+    if (xMin > xMax)
+        return;
+
+    if (xMin == xMax) { xMin -= 0.5; xMax += 0.5; }
+    if (yMin == yMax) { yMin -= 0.5f; yMax += 0.5f; }
+    mXRange = Vector2d(xMin, xMax);
+    mYRange = Vector2f(yMin, yMax);
+    markDirty();
+}
+
+bool Plot::mouseDragEvent(const Vector2i &, const Vector2i &rel, int, int) {
+    double shiftX = -rel.x() * (mXRange[1] - mXRange[0]) / mSize.x();
+    float shiftY = rel.y() * (mYRange[1] - mYRange[0]) / mSize.y();
+    mXRange += Vector2d::Constant(shiftX);
+    mYRange += Vector2f::Constant(shiftY);
+    mAutoScroll = false;
+    markDirty();
+    return true;
+}
+
+bool Plot::scrollEvent(const Vector2i &p, const Vector2f &rel) {
+    /* Zoom around the cursor, or the right edge while following new samples */
+    double u = mAutoScroll ? 1.0 : (p.x() - mPos.x()) / (double) mSize.x(),
+           center = mXRange[0] + u * (mXRange[1] - mXRange[0]),
+           scale = std::pow(1.1, -rel.y());
+    mXRange = Vector2d(center + (mXRange[0] - center) * scale,
+                       center + (mXRange[1] - center) * scale);
+    markDirty();
+    return true;
+}
+
+void Plot::drawGL() {
+    double width = mXRange[1] - mXRange[0];
+    float height = mYRange[1] - mYRange[0];
+    if (mSeries.empty() || width == 0 || height == 0)
+        return;
+
+    mShader.bind();
+    mShader.setUniform("viewSize", Vector2f((float) width, height));
+    mShader.setUniform("yMin", mYRange[0]);
+    GLint value = mShader.attrib("value");
+    glEnableVertexAttribArray(value);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    for (const auto &s : mSeries) {
+        if (!s.visible || s.size < 2)
+            continue;
+
+        mShader.setUniform("color", Vector4f(s.color));
+        mShader.setUniform("xStep", (float) s.xStep);
+        glBindBuffer(GL_ARRAY_BUFFER, s.buffer);
+        glVertexAttribPointer(value, 1, GL_FLOAT, GL_FALSE, 0, 0);
+
+        /* The samples from 'start' to the end of the buffer, followed by the
+           copy of the first sample if the series wraps around, and then the
+           remaining samples from the beginning of the buffer */
+        size_t head = std::min(s.size, s.capacity - s.start);
+        bool wraps = head < s.size;
+        size_t firsts[2] = { s.start, 0 }, counts[2] = { head + (wraps ? 1 : 0), s.size - head },
+               offsets[2] = { 0, head };
+        double oldest = (double) (s.total - s.size);
+
+        /* Range of retained samples that intersects the view, extended by one
+           sample on each side so that the line reaches the edges */
+        double lo = 0, hi = (double) s.size;
+        if (s.xStep != 0) {
+            double i0 = (mXRange[0] - s.xStart) / s.xStep - oldest,
+                   i1 = (mXRange[1] - s.xStart) / s.xStep - oldest;
+            lo = std::max(lo, std::floor(std::min(i0, i1)) - 1);
+            hi = std::min(hi, std::ceil(std::max(i0, i1)) + 1);
+        }
+
+        for (int piece = 0; piece < 2; ++piece) {
+            double begin = std::max(lo, (double) offsets[piece]),
+                   end = std::min(hi + 1, (double) (offsets[piece] + counts[piece]));
+            if (end - begin < 2)
+                continue;
+            size_t skip = (size_t) begin - offsets[piece],
+                   first = firsts[piece] + skip, count = (size_t) end - (size_t) begin;
+            double x = s.xStart + (oldest + begin) * s.xStep;
+            mShader.setUniform("xBase", (float) (x - mXRange[0]));
+            mShader.setUniform("firstVertex", (int32_t) first);
+            glDrawArrays(GL_LINE_STRIP, (GLint) first, (GLsizei) count);
+        }
+    }
+
+    glDisable(GL_BLEND);
+    glDisableVertexAttribArray(value);
+}
+
+void Plot::drawAxes(NVGcontext *ctx) {
+    Color gridColor = mAxisColor;
+    gridColor.w() *= 0.3f;
+
+    nvgFontFace(ctx, "sans");
+    nvgFontSize(ctx, 13.0f);
+    nvgFillColor(ctx, mAxisColor);
+    nvgStrokeColor(ctx, gridColor);
+    nvgStrokeWidth(ctx, 1.0f);
+
+    char buf[32];
+    for (int axis = 0; axis < 2; ++axis) {
+        Vector2d range = axis == 0 ? mXRange : mYRange.cast<double>();
+        double extent = range[1] - range[0];
+        int pixels = axis == 0 ? mSize.x() : mSize.y();
+        if (!(extent > 0) || pixels <= 0)
+            continue;
+
+        double step = tickSpacing(extent, pixels / (axis == 0 ? 100 : 50));
+        double first = std::ceil(range[0] / step), last = std::floor(range[1] / step);
+        /* Enough significant digits to tell neighboring ticks apart far from zero */
+        double magnitude = std::max(std::abs(range[0]), std::abs(range[1]));
+        int digits = (int) std::ceil(std::log10(std::max(magnitude / step, 1.0))) + 1;
+        digits = std::min(15, std::max(6, digits));
+        nvgTextAlign(ctx, axis == 0 ? (NVG_ALIGN_LEFT | NVG_ALIGN_BOTTOM)
+                                    : (NVG_ALIGN_LEFT | NVG_ALIGN_TOP));
+
+        /* Grid lines first, then the labels on top of them */
+        for (int pass = 0; pass < 2; ++pass) {
+            if (pass == 0)
+                nvgBeginPath(ctx);
+            for (double k = first; k <= last && k - first < 100; ++k) {
+                double value = k * step;
+                float t = (float) ((value - range[0]) / extent);
+                Vector2f pos = axis == 0
+                    ? Vector2f(std::round(mPos.x() + t * mSize.x()) + 0.5f, mPos.y() + mSize.y())
+                    : Vector2f(mPos.x(), std::round(mPos.y() + (1 - t) * mSize.y()) + 0.5f);
+
+                if (pass == 0) {
+                    nvgMoveTo(ctx, pos.x(), pos.y());
+                    if (axis == 0)
+                        nvgLineTo(ctx, pos.x(), mPos.y());
+                    else
+                        nvgLineTo(ctx, mPos.x() + mSize.x(), pos.y());
+                    continue;
+                }
+
+                /* Avoid labels like 1.2e-08 instead of zero */
+                if (std::abs(value) < step * 1e-4)
+                    value = 0.0;
+                snprintf(buf, sizeof(buf), "%.*g", digits, value);
+                nvgText(ctx, pos.x() + 3, pos.y() + (axis == 0 ? -2 : 2), buf, nullptr);
+            }
+            if (pass == 0)
+                nvgStroke(ctx);
+        }
+    }
+}
+
+void Plot::draw(NVGcontext *ctx) {
+    if (mAutoScroll) {
+        /* Move the view so that the most recent sample is at its right edge */
+        double newest = -std::numeric_limits<double>::infinity();
+        for (const auto &s : mSeries)
+            if (s.visible && s.size > 0)
+                newest = std::max(newest, s.xStart + (double) (s.total - 1) * s.xStep);
+        if (std::isfinite(newest))
+            mXRange = Vector2d(newest - (mXRange[1] - mXRange[0]), newest);
+    }
+
+    GLCanvas::draw(ctx);
+
+    nvgSave(ctx);
+    nvgIntersectScissor(ctx, mPos.x(), mPos.y(), mSize.x(), mSize.y());
+    drawAxes(ctx);
+
+    /* Legend */
+    nvgFontSize(ctx, 15.0f);
+    nvgTextAlign(ctx, NVG_ALIGN_RIGHT | NVG_ALIGN_TOP);
+    float y = mPos.y() + 4;
+    for (const auto &s : mSeries) {
+        if (!s.visible || s.name.empty())
+            continue;
+        nvgFillColor(ctx, s.color);
+        nvgText(ctx, mPos.x() + mSize.x() - 5, y, s.name.c_str(), nullptr);
+        y += 16;
+    }
+    nvgRestore(ctx);
+}
+
+void Plot::save(Serializer &s) const {
+    GLCanvas::save(s);
+    s.set("xRange", mXRange);
+    s.set("yRange", mYRange);
+    s.set("axisColor", mAxisColor);
+    s.set("autoScroll", mAutoScroll);
+}
+
+bool Plot::load(Serializer &s) {
+    if (!GLCanvas::load(s)) return false;
+    if (!s.get("xRange", mXRange)) return false;
+    if (!s.get("yRange", mYRange)) return false;
+    if (!s.get("axisColor", mAxisColor)) return false;
+    if (!s.get("autoScroll", mAutoScroll)) return false;
+    return true;
+}
+
+NAMESPACE_END(nanogui)
@@ -28,7 +28,7 @@ void Popup::performLayout(NVGcontext *ctx) {
     } else {
         mChildren[0]->setPosition(Vector2i::Zero());
         mChildren[0]->setSize(mSize);
-        mChildren[0]->performLayout(ctx);
+        mChildren[0]->performLayoutIfNeeded(ctx);
     }
     if (mSide == Side::Left)
         mAnchorPos[0] -= size()[0];
@@ -37,7 +37,11 @@ void Popup::performLayout(NVGcontext *ctx) {
 void Popup::refreshRelativePlacement() {
     mParentWindow->refreshRelativePlacement();
     mVisible &= mParentWindow->visibleRecursive();
-    mPos = mParentWindow->position() + mAnchorPos - Vector2i(0, mAnchorHeight);
+    Vector2i pos = mParentWindow->position() + mAnchorPos - Vector2i(0, mAnchorHeight);
+    if (pos != mPos) {
+        mPos = pos;
+        invalidateParentIndex();
+    }
 }
 
 void Popup::draw(NVGcontext* ctx) {
@@ -0,0 +1,154 @@
+/*
+    src/profiler.cpp -- Frame time measurements for a Screen
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/profiler.h>
+#include <nanogui/widget.h>
+
+#if defined(__GNUG__)
+#  include <cxxabi.h>
+#  include <cstdlib>
+#endif
+
+NAMESPACE_BEGIN(nanogui)
+
+FrameProfiler *FrameProfiler::sActive = nullptr;
+
+static std::string className(const std::type_info &type) {
+    std::string name = type.name();
+#if defined(__GNUG__)
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+    if (status == 0 && demangled)
+        name = demangled;
+    free(demangled);
+#endif
+    /* Strip namespaces */
+    size_t pos = name.rfind("::");
+    if (pos != std::string::npos)
+        name = name.substr(pos + 2);
+    else if (name.compare(0, 6, "class ") == 0)
+        name = name.substr(6);
+    return name;
+}
+
+FrameProfiler::FrameProfiler(size_t capacity)
+    : mTotalFrames(0), mWidgetInstrumentation(false) {
+    setCapacity(capacity);
+}
+
+void FrameProfiler::setCapacity(size_t capacity) {
+    if (capacity == 0)
+        throw std::runtime_error("FrameProfiler::setCapacity(): capacity must be positive!");
+    mFrames.assign(capacity, FrameTimings());
+    mTotalFrames = 0;
+}
+
+const FrameTimings &FrameProfiler::frame(size_t index) const {
+    size_t count = frameCount();
+    if (index >= count)
+        throw std::out_of_range("FrameProfiler::frame(): index out of range!");
+    return mFrames[(mTotalFrames - count + index) % mFrames.size()];
+}
+
+std::vector<FrameTimings> FrameProfiler::frames() const {
+    std::vector<FrameTimings> result;
+    result.reserve(frameCount());
+    for (size_t i = 0; i < frameCount(); ++i)
+        result.push_back(frame(i));
+    return result;
+}
+
+FrameTimings FrameProfiler::average() const {
+    FrameTimings result;
+    size_t count = frameCount();
+    if (count == 0)
+        return result;
+    for (size_t i = 0; i < count; ++i) {
+        const FrameTimings &f = mFrames[i];
+        result.layout += f.layout;
+        result.contents += f.contents;
+        result.widgets += f.widgets;
+        result.flush += f.flush;
+        result.swap += f.swap;
+        result.total += f.total;
+    }
+    result.layout /= count;
+    result.contents /= count;
+    result.widgets /= count;
+    result.flush /= count;
+    result.swap /= count;
+    result.total /= count;
+    return result;
+}
+
+FrameTimings FrameProfiler::peak() const {
+    FrameTimings result;
+    for (size_t i = 0; i < frameCount(); ++i) {
+        const FrameTimings &f = mFrames[i];
+        result.layout = std::max(result.layout, f.layout);
+        result.contents = std::max(result.contents, f.contents);
+        result.widgets = std::max(result.widgets, f.widgets);
+        result.flush = std::max(result.flush, f.flush);
+        result.swap = std::max(result.swap, f.swap);
+        result.total = std::max(result.total, f.total);
+    }
+    return result;
+}
+
+std::vector<WidgetClassStats> FrameProfiler::widgetStats() const {
+    std::vector<WidgetClassStats> result;
+    result.reserve(mWidgetStats.size());
+    for (const auto &it : mWidgetStats)
+        result.push_back(it.second);
+    std::sort(result.begin(), result.end(),
+              [](const WidgetClassStats &a, const WidgetClassStats &b) {
+                  return a.time > b.time;
+              });
+    return result;
+}
+
+void FrameProfiler::clear() {
+    mTotalFrames = 0;
+    mCurrent = FrameTimings();
+    mWidgetStats.clear();
+    mStack.clear();
+}
+
+void FrameProfiler::commitFrame() {
+    mFrames[mTotalFrames % mFrames.size()] = mCurrent;
+    mTotalFrames++;
+    mCurrent = FrameTimings();
+}
+
+void FrameProfiler::setActive(FrameProfiler *profiler) {
+    sActive = profiler;
+    if (profiler)
+        profiler->mStack.clear();
+}
+
+void FrameProfiler::endWidget(const Widget *widget) {
+    Scope scope = mStack.back();
+    mStack.pop_back();
+
+    double time = elapsed(scope.start);
+    if (!mStack.empty())
+        mStack.back().children += time;
+
+    auto it = mWidgetStats.find(typeid(*widget));
+    if (it == mWidgetStats.end()) {
+        it = mWidgetStats.emplace(typeid(*widget), WidgetClassStats()).first;
+        it->second.name = className(typeid(*widget));
+    }
+    it->second.time += time - scope.children;
+    it->second.calls++;
+}
+
+NAMESPACE_END(nanogui)
@@ -16,7 +16,15 @@
 #include <nanogui/opengl.h>
 #include <nanogui/window.h>
 #include <nanogui/popup.h>
+#include <nanogui/layout.h>
+#include <nanogui/glutil.h>
+#include <nanogui/graph.h>
+#include <nanogui/profiler.h>
+#include <nanogui/textmetrics.h>
+#include <nanogui/threadpool.h>
 #include <map>
+#include <limits>
+#include <algorithm>
 #include <iostream>
 
 #if defined(_WIN32)
@@ -38,6 +46,12 @@
 /* Allow enforcing the GL2 implementation of NanoVG */
 #define NANOVG_GL3_IMPLEMENTATION
 #include <nanovg_gl.h>
+#include <nanovg_gl_utils.h>
+
+#if defined(NANOGUI_HEADLESS)
+#  include <EGL/egl.h>
+#  include <EGL/eglext.h>
+#endif
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -123,7 +137,14 @@ static float get_pixel_ratio(GLFWwindow *window) {
 Screen::Screen()
     : Widget(nullptr), mGLFWWindow(nullptr), mNVGContext(nullptr),
       mCursor(Cursor::Arrow), mBackground(0.3f, 0.3f, 0.32f, 1.f),
-      mShutdownGLFWOnDestruct(false), mFullscreen(false) {
+      mShutdownGLFWOnDestruct(false), mFullscreen(false), mSkippedFrames(0),
+      mPartialRedraw(false), mParallelLayout(false), mDamageAll(true),
+      mRedrawRegion(Vector4i::Zero()), mRetainedFrame(nullptr),
+      mProfiler(nullptr), mProfilerOverlay(nullptr), mTextMetrics(nullptr),
+      mNextAnimationFrame(0),
+      mRedrawTime(std::numeric_limits<double>::infinity()),
+      mEGLDisplay(nullptr), mEGLConfig(nullptr), mEGLContext(nullptr),
+      mEGLSurface(nullptr) {
     memset(mCursors, 0, sizeof(GLFWcursor *) * (int) Cursor::CursorCount);
 }
 
@@ -133,7 +154,14 @@ Screen::Screen(const Vector2i &size, const std::string &caption, bool resizable,
                unsigned int glMajor, unsigned int glMinor)
     : Widget(nullptr), mGLFWWindow(nullptr), mNVGContext(nullptr),
       mCursor(Cursor::Arrow), mBackground(0.3f, 0.3f, 0.32f, 1.f), mCaption(caption),
-      mShutdownGLFWOnDestruct(false), mFullscreen(fullscreen) {
+      mShutdownGLFWOnDestruct(false), mFullscreen(fullscreen), mSkippedFrames(0),
+      mPartialRedraw(false), mParallelLayout(false), mDamageAll(true),
+      mRedrawRegion(Vector4i::Zero()), mRetainedFrame(nullptr),
+      mProfiler(nullptr), mProfilerOverlay(nullptr), mTextMetrics(nullptr),
+      mNextAnimationFrame(0),
+      mRedrawTime(std::numeric_limits<double>::infinity()),
+      mEGLDisplay(nullptr), mEGLConfig(nullptr), mEGLContext(nullptr),
+      mEGLSurface(nullptr) {
     memset(mCursors, 0, sizeof(GLFWcursor *) * (int) Cursor::CursorCount);
 
     /* Request a forward compatible OpenGL glMajor.glMinor core profile context.
@@ -286,6 +314,17 @@ Screen::Screen(const Vector2i &size, const std::string &caption, bool resizable,
         }
     );
 
+    /* The window contents were damaged (e.g. uncovered by another
+       window), so the next call to drawAll() must not be skipped */
+    glfwSetWindowRefreshCallback(mGLFWWindow,
+        [](GLFWwindow *w) {
+            auto it = __nanogui_screens.find(w);
+            if (it == __nanogui_screens.end())
+                return;
+            it->second->markDirty();
+        }
+    );
+
     // notify when the screen has lost focus (e.g. application switch)
     glfwSetWindowFocusCallback(mGLFWWindow,
         [](GLFWwindow *w, int focused) {
@@ -324,6 +363,113 @@ void Screen::initialize(GLFWwindow *window, bool shutdownGLFWOnDestruct) {
     }
 #endif
 
+    initializeContext();
+
+    mVisible = glfwGetWindowAttrib(window, GLFW_VISIBLE) != 0;
+    __nanogui_screens[mGLFWWindow] = this;
+
+    for (int i=0; i < (int) Cursor::CursorCount; ++i)
+        mCursors[i] = glfwCreateStandardCursor(GLFW_ARROW_CURSOR + i);
+}
+
+void Screen::initializeHeadless(const Vector2i &size, float pixelRatio) {
+#if !defined(NANOGUI_HEADLESS)
+    (void) size; (void) pixelRatio;
+    throw std::runtime_error("Screen::initializeHeadless(): NanoGUI was "
+                             "compiled without headless support!");
+#else
+    if (mGLFWWindow || mEGLContext)
+        throw std::runtime_error("Screen::initializeHeadless(): already initialized!");
+
+    /* Prefer a display that does not depend on a windowing system */
+    EGLDisplay display = EGL_NO_DISPLAY;
+#if defined(EGL_PLATFORM_SURFACELESS_MESA)
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)
+        eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay)
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+                                     EGL_DEFAULT_DISPLAY, nullptr);
+#endif
+    if (display == EGL_NO_DISPLAY)
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+        throw std::runtime_error("Could not initialize EGL!");
+
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_DEPTH_SIZE, 24, EGL_STENCIL_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint nConfigs = 0;
+    if (!eglChooseConfig(display, configAttribs, &config, 1, &nConfigs) || nConfigs < 1)
+        throw std::runtime_error("Could not find a suitable EGL configuration!");
+
+    /* Same kind of context as the one requested from GLFW by default */
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION_KHR, 3,
+        EGL_CONTEXT_MINOR_VERSION_KHR, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+        EGL_NONE
+    };
+    if (!eglBindAPI(EGL_OPENGL_API))
+        throw std::runtime_error("EGL does not support desktop OpenGL!");
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+    if (context == EGL_NO_CONTEXT)
+        throw std::runtime_error("Could not create an OpenGL 3.3 context!");
+
+    mEGLDisplay = display;
+    mEGLConfig = config;
+    mEGLContext = context;
+    mPixelRatio = pixelRatio;
+    mSize = size;
+    mFBSize = (size.cast<float>() * pixelRatio).cast<int>();
+    createHeadlessSurface();
+
+#if defined(NANOGUI_GLAD)
+    if (!gladInitialized) {
+        gladInitialized = true;
+        if (!gladLoadGLLoader((GLADloadproc) eglGetProcAddress))
+            throw std::runtime_error("Could not initialize GLAD!");
+        glGetError(); // pull and ignore unhandled errors like GL_INVALID_ENUM
+    }
+#endif
+
+    mVisible = true;
+    initializeContext();
+#endif
+}
+
+void Screen::createHeadlessSurface() {
+#if defined(NANOGUI_HEADLESS)
+    EGLSurface surface = eglCreatePbufferSurface(mEGLDisplay, mEGLConfig,
+        std::array<EGLint, 5>{{ EGL_WIDTH, std::max(mFBSize.x(), 1),
+                                EGL_HEIGHT, std::max(mFBSize.y(), 1),
+                                EGL_NONE }}.data());
+    if (surface == EGL_NO_SURFACE)
+        throw std::runtime_error("Could not create an offscreen EGL surface!");
+    if (!eglMakeCurrent(mEGLDisplay, surface, surface, mEGLContext)) {
+        eglDestroySurface(mEGLDisplay, surface);
+        throw std::runtime_error("Could not activate the EGL context!");
+    }
+    if (mEGLSurface)
+        eglDestroySurface(mEGLDisplay, mEGLSurface);
+    mEGLSurface = surface;
+#endif
+}
+
+void Screen::makeContextCurrent() {
+    if (mGLFWWindow)
+        glfwMakeContextCurrent(mGLFWWindow);
+#if defined(NANOGUI_HEADLESS)
+    else if (mEGLContext)
+        eglMakeCurrent(mEGLDisplay, mEGLSurface, mEGLSurface, mEGLContext);
+#endif
+}
+
+void Screen::initializeContext() {
     /* Detect framebuffer properties and set up compatible NanoVG context */
     GLint nStencilBits = 0, nSamples = 0;
     glGetFramebufferAttachmentParameteriv(GL_DRAW_FRAMEBUFFER,
@@ -343,17 +489,16 @@ void Screen::initialize(GLFWwindow *window, bool shutdownGLFWOnDestruct) {
     if (mNVGContext == nullptr)
         throw std::runtime_error("Could not initialize NanoVG!");
 
-    mVisible = glfwGetWindowAttrib(window, GLFW_VISIBLE) != 0;
+    mTextMetrics = new TextMetricsCache();
+    mTextMetrics->setPixelRatio(mPixelRatio);
+    TextMetricsCache::registerCache(mNVGContext, mTextMetrics);
+
     setTheme(new Theme(mNVGContext));
     mMousePos = Vector2i::Zero();
     mMouseState = mModifiers = 0;
     mDragActive = false;
     mLastInteraction = glfwGetTime();
     mProcessEvents = true;
-    __nanogui_screens[mGLFWWindow] = this;
-
-    for (int i=0; i < (int) Cursor::CursorCount; ++i)
-        mCursors[i] = glfwCreateStandardCursor(GLFW_ARROW_CURSOR + i);
 
     /// Fixes retina display-related font rendering issue (#185)
     nvgBeginFrame(mNVGContext, mSize[0], mSize[1], mPixelRatio);
@@ -361,21 +506,42 @@ void Screen::initialize(GLFWwindow *window, bool shutdownGLFWOnDestruct) {
 }
 
 Screen::~Screen() {
-    __nanogui_screens.erase(mGLFWWindow);
+    if (mGLFWWindow)
+        __nanogui_screens.erase(mGLFWWindow);
+    if (mEGLContext)
+        makeContextCurrent();
+    if (mRetainedFrame) {
+        mRetainedFrame->free();
+        delete mRetainedFrame;
+    }
+    setProfiling(false);
     for (int i=0; i < (int) Cursor::CursorCount; ++i) {
         if (mCursors[i])
             glfwDestroyCursor(mCursors[i]);
     }
-    if (mNVGContext)
+    if (mNVGContext) {
+        TextMetricsCache::registerCache(mNVGContext, nullptr);
         nvgDeleteGL3(mNVGContext);
+    }
+    delete mTextMetrics;
     if (mGLFWWindow && mShutdownGLFWOnDestruct)
         glfwDestroyWindow(mGLFWWindow);
+#if defined(NANOGUI_HEADLESS)
+    if (mEGLContext) {
+        eglMakeCurrent(mEGLDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroySurface(mEGLDisplay, mEGLSurface);
+        eglDestroyContext(mEGLDisplay, mEGLContext);
+    }
+#endif
 }
 
 void Screen::setVisible(bool visible) {
     if (mVisible != visible) {
         mVisible = visible;
+        markDirty();
 
+        if (!mGLFWWindow)
+            return;
         if (visible)
             glfwShowWindow(mGLFWWindow);
         else
@@ -385,12 +551,19 @@ void Screen::setVisible(bool visible) {
 
 void Screen::setCaption(const std::string &caption) {
     if (caption != mCaption) {
-        glfwSetWindowTitle(mGLFWWindow, caption.c_str());
+        if (mGLFWWindow)
+            glfwSetWindowTitle(mGLFWWindow, caption.c_str());
         mCaption = caption;
     }
 }
 
 void Screen::setSize(const Vector2i &size) {
+    if (headless()) {
+        resizeCallbackEvent((int) (size.x() * mPixelRatio),
+                            (int) (size.y() * mPixelRatio));
+        return;
+    }
+
     Widget::setSize(size);
 
 #if defined(_WIN32) || defined(__linux__)
@@ -400,46 +573,538 @@ void Screen::setSize(const Vector2i &size) {
 #endif
 }
 
+void Screen::setPartialRedraw(bool partialRedraw) {
+    if (partialRedraw && (mGLFWWindow || mEGLContext)) {
+        GLint sampleBuffers = 0;
+        makeContextCurrent();
+        glGetIntegerv(GL_SAMPLE_BUFFERS, &sampleBuffers);
+        if (sampleBuffers > 0)
+            throw std::runtime_error(
+                "Screen::setPartialRedraw(): not supported with a multisampled framebuffer!");
+    }
+    mPartialRedraw = partialRedraw;
+    markDirty();
+}
+
+void Screen::setProfiling(bool profiling) {
+    if (profiling && !mProfiler) {
+        mProfiler = new FrameProfiler();
+    } else if (!profiling && mProfiler) {
+        setProfilerOverlay(false);
+        delete mProfiler;
+        mProfiler = nullptr;
+    }
+}
+
+void Screen::setProfilerOverlay(bool overlay) {
+    if (overlay && !mProfilerOverlay) {
+        setProfiling(true);
+        /* Not a child widget: it neither receives events nor takes part in
+           the layout, and is drawn on top of everything else */
+        mProfilerOverlay = new Graph(nullptr, "Frame time");
+        mProfilerOverlay->incRef();
+        mProfilerOverlay->setTheme(mTheme);
+    } else if (!overlay && mProfilerOverlay) {
+        mProfilerOverlay->decRef();
+        mProfilerOverlay = nullptr;
+    }
+    markDirty();
+}
+
+void Screen::updateProfilerOverlay() {
+    Vector2i size = mProfilerOverlay->preferredSize(mNVGContext);
+    mProfilerOverlay->setSize(size);
+    mProfilerOverlay->setPosition(Vector2i(mSize.x() - size.x() - 10, 10));
+
+    size_t count = mProfiler->frameCount();
+    if (count > 0) {
+        /* The top of the graph corresponds to two frames at 60 Hz */
+        const float scale = 1.f / 33.33f;
+        VectorXf &values = mProfilerOverlay->values();
+        values.resize(count);
+        for (size_t i = 0; i < count; ++i)
+            values[i] = std::min((float) mProfiler->frame(i).total * scale, 1.f);
+
+        FrameTimings avg = mProfiler->average();
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.2f ms", mProfiler->frame(count - 1).total);
+        mProfilerOverlay->setHeader(buf);
+        snprintf(buf, sizeof(buf), "avg %.2f ms, peak %.2f ms", avg.total,
+                 mProfiler->peak().total);
+        mProfilerOverlay->setFooter(buf);
+    }
+
+    addDamage(mProfilerOverlay, mProfilerOverlay->position());
+}
+
+void Screen::performLayout() {
+    auto start = FrameProfiler::Clock::now();
+
+    if (!mParallelLayout) {
+        Widget::performLayout(mNVGContext);
+    } else {
+        /* Put the screen into the state that changes to its descendants
+           would produce, so that concurrent layouts of the windows only read
+           it (see Widget::parallelLayoutFor()). This also damages the whole
+           screen, which avoids concurrent updates of the damaged regions. */
+        invalidateLayout();
+        markDirty();
+        mSpatialIndexValid = false;
+
+        /* Popups are placed relative to their parent windows, which are laid
+           out at the same time, so they are handled afterwards */
+        std::vector<Widget *> windows, popups;
+        for (auto child : mChildren)
+            (dynamic_cast<Popup *>(child) ? popups : windows).push_back(child);
+
+        auto layoutChild = [this](Widget *c) {
+            Vector2i pref = c->cachedPreferredSize(mNVGContext), fix = c->fixedSize();
+            c->setSize(Vector2i(
+                fix[0] ? fix[0] : pref[0],
+                fix[1] ? fix[1] : pref[1]
+            ));
+            c->performLayoutIfNeeded(mNVGContext);
+        };
+
+        sParallelLayout = true;
+        try {
+            if (mLayout) {
+                mLayout->performLayout(mNVGContext, this);
+            } else {
+                parallelLayoutFor(windows, layoutChild);
+                for (auto popup : popups)
+                    layoutChild(popup);
+            }
+        } catch (...) {
+            sParallelLayout = false;
+            throw;
+        }
+        sParallelLayout = false;
+    }
+
+    if (mProfiler)
+        mProfiler->current().layout += FrameProfiler::elapsed(start);
+}
+
+/* Convert a region in screen coordinates into an OpenGL (x, y, width, height)
+   rectangle in framebuffer pixels, rounding outwards */
+static Vector4i framebufferRegion(const Vector4i &region, const Vector2i &fbSize,
+                                  float pixelRatio) {
+    int x0 = (int) std::floor(region.x() * pixelRatio),
+        y0 = (int) std::floor(region.y() * pixelRatio),
+        x1 = (int) std::ceil((region.x() + region.z()) * pixelRatio),
+        y1 = (int) std::ceil((region.y() + region.w()) * pixelRatio);
+    x0 = std::max(x0, 0); y0 = std::max(y0, 0);
+    x1 = std::min(x1, fbSize.x()); y1 = std::min(y1, fbSize.y());
+    return Vector4i(x0, fbSize.y() - y1, x1 - x0, y1 - y0);
+}
+
+int Screen::requestAnimationFrame(const std::function<void(double)> &callback) {
+    int id;
+    {
+        std::lock_guard<std::mutex> guard(mAnimationFramesMutex);
+        id = mNextAnimationFrame++;
+        mAnimationFrames.emplace_back(id, callback);
+    }
+    /* Wake up the main loop in case the request came from another thread */
+    if (mGLFWWindow)
+        glfwPostEmptyEvent();
+    return id;
+}
+
+void Screen::cancelAnimationFrame(int id) {
+    std::lock_guard<std::mutex> guard(mAnimationFramesMutex);
+    for (auto it = mAnimationFrames.begin(); it != mAnimationFrames.end(); ++it) {
+        if (it->first == id) {
+            mAnimationFrames.erase(it);
+            return;
+        }
+    }
+}
+
+void Screen::scheduleRedraw(Widget *widget, double time) {
+    if (widget == this) {
+        mRedrawTime = std::min(mRedrawTime, time);
+        return;
+    }
+    for (auto &entry : mScheduledRedraws) {
+        if (entry.second.get() == widget) {
+            entry.first = std::min(entry.first, time);
+            return;
+        }
+    }
+    mScheduledRedraws.emplace_back(time, widget);
+}
+
+double Screen::nextFrameTime() const {
+    bool framesPending;
+    {
+        std::lock_guard<std::mutex> guard(mAnimationFramesMutex);
+        framesPending = !mAnimationFrames.empty();
+    }
+    if (mDirty || framesPending)
+        return -std::numeric_limits<double>::infinity();
+    double time = mRedrawTime;
+    for (const auto &entry : mScheduledRedraws)
+        time = std::min(time, entry.first);
+    return time;
+}
+
+void Screen::runScheduled() {
+    double time = glfwGetTime();
+
+    if (mRedrawTime <= time) {
+        mRedrawTime = std::numeric_limits<double>::infinity();
+        markDirty();
+    }
+
+    if (!mScheduledRedraws.empty()) {
+        /* Keep the entries that are not due yet */
+        std::vector<ref<Widget>> due;
+        auto it = std::remove_if(mScheduledRedraws.begin(), mScheduledRedraws.end(),
+            [&](std::pair<double, ref<Widget>> &entry) {
+                if (entry.first > time)
+                    return false;
+                due.push_back(entry.second);
+                return true;
+            });
+        mScheduledRedraws.erase(it, mScheduledRedraws.end());
+        for (auto &widget : due)
+            widget->markDirty();
+    }
+
+    /* Callbacks that request another frame are invoked during the next one */
+    std::vector<std::pair<int, std::function<void(double)>>> frames;
+    {
+        std::lock_guard<std::mutex> guard(mAnimationFramesMutex);
+        frames.swap(mAnimationFrames);
+    }
+    for (auto &frame : frames)
+        frame.second(time);
+}
+
 void Screen::drawAll() {
+    runScheduled();
+
+    if (!mDirty) {
+        /* Nothing changed since the last frame -- keep showing it */
+        mSkippedFrames++;
+        return;
+    }
+
+    auto frameStart = FrameProfiler::Clock::now();
+
+    /* Updating the overlay must not by itself cause another frame */
+    if (mProfilerOverlay)
+        updateProfilerOverlay();
+
+    /* Reset before drawing so that changes made while drawing (e.g. by
+       widgets animating themselves) trigger another frame */
+    clearDirty();
+
+    bool partial = updateRedrawRegions();
+    if (partial && mRedrawRegions.empty()) {
+        /* Only widgets outside of the visible area changed */
+        mSkippedFrames++;
+        return;
+    }
+
+    makeContextCurrent();
     glClearColor(mBackground[0], mBackground[1], mBackground[2], mBackground[3]);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
-    drawContents();
-    drawWidgets();
+    if (!partial) {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+        auto contentsStart = FrameProfiler::Clock::now();
+        drawContents();
+        if (mProfiler)
+            mProfiler->current().contents += FrameProfiler::elapsed(contentsStart);
+        drawWidgets();
+
+        if (mPartialRedraw) {
+            /* Retain the complete frame for subsequent partial redraws */
+            if (mRetainedFrame && mRetainedFrame->size() != mFBSize) {
+                mRetainedFrame->free();
+                delete mRetainedFrame;
+                mRetainedFrame = nullptr;
+            }
+            if (!mRetainedFrame) {
+                mRetainedFrame = new GLFramebuffer();
+                mRetainedFrame->init(mFBSize, 1);
+            }
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mRetainedFrame->framebuffer());
+            glBlitFramebuffer(0, 0, mFBSize.x(), mFBSize.y(), 0, 0, mFBSize.x(),
+                              mFBSize.y(), GL_COLOR_BUFFER_BIT, GL_NEAREST);
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        }
+    } else {
+        /* Every region is drawn like a separate frame into the back buffer.
+           Widgets may draw outside of the region (e.g. drop shadows), hence
+           only the region itself is copied into the retained frame before
+           the next one is cleared. */
+        for (const Vector4i &region : mRedrawRegions) {
+            Vector4i r = framebufferRegion(region, mFBSize, mPixelRatio);
+            mRedrawRegion = region;
+
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(r[0], r[1], r[2], r[3]);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+            auto contentsStart = FrameProfiler::Clock::now();
+            drawContents();
+            if (mProfiler)
+                mProfiler->current().contents += FrameProfiler::elapsed(contentsStart);
+            drawWidgets();
+
+            glDisable(GL_SCISSOR_TEST);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mRetainedFrame->framebuffer());
+            glBlitFramebuffer(r[0], r[1], r[0] + r[2], r[1] + r[3], r[0], r[1],
+                              r[0] + r[2], r[1] + r[3], GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        }
+        mRedrawRegion = Vector4i::Zero();
+        mRedrawRegions.clear();
+
+        /* The back buffer contents are undefined after a swap, so present
+           the complete retained frame */
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, mRetainedFrame->framebuffer());
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, mFBSize.x(), mFBSize.y(), 0, 0, mFBSize.x(),
+                          mFBSize.y(), GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
 
-    glfwSwapBuffers(mGLFWWindow);
+    /* Headless screens keep the frame in the back buffer for readPixels() */
+    if (mGLFWWindow) {
+        auto swapStart = FrameProfiler::Clock::now();
+        glfwSwapBuffers(mGLFWWindow);
+        if (mProfiler)
+            mProfiler->current().swap = FrameProfiler::elapsed(swapStart);
+    }
+
+    if (mProfiler) {
+        mProfiler->current().total = FrameProfiler::elapsed(frameStart);
+        mProfiler->commitFrame();
+    }
+}
+
+std::vector<uint8_t> Screen::readPixels() {
+    std::vector<uint8_t> pixels((size_t) mFBSize.prod() * 4);
+    if (pixels.empty())
+        return pixels;
+
+    makeContextCurrent();
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glReadBuffer(mGLFWWindow ? GL_FRONT : GL_BACK);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, mFBSize.x(), mFBSize.y(), GL_RGBA, GL_UNSIGNED_BYTE,
+                 pixels.data());
+
+    /* OpenGL returns the rows from the bottom up */
+    size_t rowSize = (size_t) mFBSize.x() * 4;
+    std::vector<uint8_t> row(rowSize);
+    for (int y = 0; y < mFBSize.y() / 2; ++y) {
+        uint8_t *top = pixels.data() + y * rowSize,
+                *bottom = pixels.data() + (mFBSize.y() - 1 - y) * rowSize;
+        memcpy(row.data(), top, rowSize);
+        memcpy(top, bottom, rowSize);
+        memcpy(bottom, row.data(), rowSize);
+    }
+    return pixels;
+}
+
+void Screen::addDamage(const Widget *widget, const Vector2i &pos) {
+    if (mDamageAll)
+        return;
+
+    /* Changes to the screen itself and an excessive number of separate
+       regions are both handled by repainting everything */
+    if (widget == this || mDamage.size() >= 64) {
+        mDamageAll = true;
+        mDamage.clear();
+        return;
+    }
+
+    /* Windows and popups draw drop shadows and anchor arrows outside of
+       their bounds, everything else is clipped by the parent widget */
+    int margin = 1;
+    if (widget->parent() == this && widget->theme())
+        margin = widget->theme()->mWindowDropShadowSize + 15;
+
+    mDamage.push_back(Vector4i(pos.x() - margin, pos.y() - margin,
+                               widget->width() + 2 * margin,
+                               widget->height() + 2 * margin));
+}
+
+bool Screen::updateRedrawRegions() {
+    bool damageAll = mDamageAll;
+    mRedrawRegions.clear();
+    mDamageAll = false;
+
+    if (!mPartialRedraw || damageAll || !mRetainedFrame ||
+        mRetainedFrame->size() != mFBSize) {
+        mDamage.clear();
+        return false;
+    }
+
+    /* Clip the damaged regions against the screen */
+    for (const Vector4i &d : mDamage) {
+        Vector2i p0 = d.head<2>().cwiseMax(0),
+                 p1 = (d.head<2>() + d.tail<2>()).cwiseMin(mSize);
+        if ((p1.array() <= p0.array()).any())
+            continue;
+        mRedrawRegions.push_back(Vector4i(p0.x(), p0.y(), p1.x() - p0.x(), p1.y() - p0.y()));
+    }
+    mDamage.clear();
+
+    /* Repeatedly merge the pair of regions whose bounding box adds the
+       least area. Overlapping regions are always merged, since they would
+       otherwise be drawn twice; the number of passes is limited to 4. */
+    auto regionArea = [](const Vector4i &r) { return (long) r.z() * (long) r.w(); };
+    while (mRedrawRegions.size() > 1) {
+        long bestCost = std::numeric_limits<long>::max();
+        size_t bestI = 0, bestJ = 0;
+        Vector4i bestUnion = Vector4i::Zero();
+        for (size_t i = 0; i < mRedrawRegions.size(); ++i) {
+            for (size_t j = i + 1; j < mRedrawRegions.size(); ++j) {
+                const Vector4i &a = mRedrawRegions[i], &b = mRedrawRegions[j];
+                Vector2i p0 = a.head<2>().cwiseMin(b.head<2>()),
+                         p1 = (a.head<2>() + a.tail<2>()).cwiseMax(b.head<2>() + b.tail<2>());
+                Vector4i u(p0.x(), p0.y(), p1.x() - p0.x(), p1.y() - p0.y());
+                bool overlap = a.x() < b.x() + b.z() && b.x() < a.x() + a.z() &&
+                               a.y() < b.y() + b.w() && b.y() < a.y() + a.w();
+                long cost = overlap ? -1 : regionArea(u) - regionArea(a) - regionArea(b);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestI = i; bestJ = j;
+                    bestUnion = u;
+                }
+            }
+        }
+        if (bestCost > 0 && mRedrawRegions.size() <= 4)
+            break;
+        mRedrawRegions[bestI] = bestUnion;
+        mRedrawRegions.erase(mRedrawRegions.begin() + bestJ);
+    }
+
+    long area = 0;
+    for (const Vector4i &r : mRedrawRegions)
+        area += regionArea(r);
+
+    /* Not worth the additional passes when most of the screen changed */
+    if (area * 2 > (long) mSize.x() * (long) mSize.y()) {
+        mRedrawRegions.clear();
+        return false;
+    }
+
+    return true;
+}
+
+void Screen::cullWidgets(Widget *widget, const Vector2i &offset,
+                         std::vector<Widget *> &culled) {
+    const Vector4i &r = mRedrawRegion;
+    for (auto child : widget->mChildren) {
+        if (!child->mVisible)
+            continue;
+        Vector2i pos = offset + child->mPos;
+        int margin = 1;
+        if (widget == this && child->mTheme)
+            margin = child->mTheme->mWindowDropShadowSize + 15;
+        bool overlap = pos.x() - margin < r.x() + r.z() &&
+                       pos.y() - margin < r.y() + r.w() &&
+                       pos.x() + child->mSize.x() + margin > r.x() &&
+                       pos.y() + child->mSize.y() + margin > r.y();
+        if (!overlap) {
+            child->mCulled = true;
+            culled.push_back(child);
+        } else if (!child->mChildren.empty()) {
+            cullWidgets(child, pos, culled);
+        }
+    }
 }
 
 void Screen::drawWidgets() {
     if (!mVisible)
         return;
 
-    glfwMakeContextCurrent(mGLFWWindow);
+    makeContextCurrent();
 
-    glfwGetFramebufferSize(mGLFWWindow, &mFBSize[0], &mFBSize[1]);
-    glfwGetWindowSize(mGLFWWindow, &mSize[0], &mSize[1]);
+    /* The size of a headless screen only changes through resizeCallbackEvent() */
+    if (mGLFWWindow) {
+        glfwGetFramebufferSize(mGLFWWindow, &mFBSize[0], &mFBSize[1]);
+        glfwGetWindowSize(mGLFWWindow, &mSize[0], &mSize[1]);
 
 #if defined(_WIN32) || defined(__linux__)
-    mSize = (mSize.cast<float>() / mPixelRatio).cast<int>();
-    mFBSize = (mSize.cast<float>() * mPixelRatio).cast<int>();
+        mSize = (mSize.cast<float>() / mPixelRatio).cast<int>();
+        mFBSize = (mSize.cast<float>() * mPixelRatio).cast<int>();
 #else
-    /* Recompute pixel ratio on OSX */
-    if (mSize[0])
-        mPixelRatio = (float) mFBSize[0] / (float) mSize[0];
+        /* Recompute pixel ratio on OSX */
+        if (mSize[0]) {
+            float pixelRatio = (float) mFBSize[0] / (float) mSize[0];
+            /* Text is measured at the resolution of the framebuffer */
+            if (mTextMetrics)
+                mTextMetrics->setPixelRatio(pixelRatio);
+            mPixelRatio = pixelRatio;
+        }
 #endif
+    }
 
     glViewport(0, 0, mFBSize[0], mFBSize[1]);
     glBindSampler(0, 0);
+
+    auto drawStart = FrameProfiler::Clock::now();
+    bool instrument = mProfiler && mProfiler->widgetInstrumentation();
+    if (instrument)
+        FrameProfiler::setActive(mProfiler);
+
+    /* Render the layers of cached windows before starting the frame */
+    for (auto child : mChildren) {
+        Window *window = dynamic_cast<Window *>(child);
+        if (window && window->visible() && window->layerCaching())
+            window->updateLayer(mNVGContext, mPixelRatio);
+    }
+
     nvgBeginFrame(mNVGContext, mSize[0], mSize[1], mPixelRatio);
 
-    draw(mNVGContext);
+    if (mRedrawRegion.tail<2>().prod() == 0) {
+        draw(mNVGContext);
+    } else {
+        /* Partial redraw: only draw what intersects the current region */
+        std::vector<Widget *> culled;
+        cullWidgets(this, mPos, culled);
+
+        nvgSave(mNVGContext);
+        nvgScissor(mNVGContext, mRedrawRegion.x(), mRedrawRegion.y(),
+                   mRedrawRegion.z(), mRedrawRegion.w());
+        draw(mNVGContext);
+        nvgRestore(mNVGContext);
+
+        for (auto widget : culled)
+            widget->mCulled = false;
+    }
+
+    if (instrument)
+        FrameProfiler::setActive(nullptr);
+
+    if (mProfilerOverlay)
+        mProfilerOverlay->draw(mNVGContext);
 
     double elapsed = glfwGetTime() - mLastInteraction;
 
+    const Widget *widget = findWidget(mMousePos);
+    bool hasTooltip = widget && !widget->tooltip().empty();
+
+    /* Wake up when a pending tooltip appears, then keep redrawing until it
+       has completely faded in */
+    if (hasTooltip && elapsed < 0.5f)
+        scheduleRedraw(this, mLastInteraction + 0.5);
+    else if (hasTooltip && elapsed < 1.f)
+        markDirty();
+
     if (elapsed > 0.5f) {
         /* Draw tooltips */
-        const Widget *widget = findWidget(mMousePos);
-        if (widget && !widget->tooltip().empty()) {
+        if (hasTooltip) {
             int tooltipWidth = 150;
 
             float bounds[4];
@@ -450,13 +1115,14 @@ void Screen::drawWidgets() {
             Vector2i pos = widget->absolutePosition() +
                            Vector2i(widget->width() / 2, widget->height() + 10);
 
-            nvgTextBounds(mNVGContext, pos.x(), pos.y(),
-                            widget->tooltip().c_str(), nullptr, bounds);
+            textBounds(mNVGContext, "sans", 15.0f, NVG_ALIGN_LEFT | NVG_ALIGN_TOP,
+                       pos.x(), pos.y(), widget->tooltip(), bounds);
             int h = (bounds[2] - bounds[0]) / 2;
             if (h > tooltipWidth / 2) {
                 nvgTextAlign(mNVGContext, NVG_ALIGN_CENTER | NVG_ALIGN_TOP);
-                nvgTextBoxBounds(mNVGContext, pos.x(), pos.y(), tooltipWidth,
-                                widget->tooltip().c_str(), nullptr, bounds);
+                textBoxBounds(mNVGContext, "sans", 15.0f,
+                              NVG_ALIGN_CENTER | NVG_ALIGN_TOP, 1.1f, pos.x(),
+                              pos.y(), tooltipWidth, widget->tooltip(), bounds);
 
                 h = (bounds[2] - bounds[0]) / 2;
             }
@@ -482,7 +1148,14 @@ void Screen::drawWidgets() {
         }
     }
 
+    auto flushStart = FrameProfiler::Clock::now();
     nvgEndFrame(mNVGContext);
+    if (mProfiler) {
+        FrameTimings &timings = mProfiler->current();
+        timings.widgets += std::chrono::duration<double, std::milli>(
+            flushStart - drawStart).count();
+        timings.flush += FrameProfiler::elapsed(flushStart);
+    }
 }
 
 bool Screen::keyboardEvent(int key, int scancode, int action, int modifiers) {
@@ -520,7 +1193,11 @@ bool Screen::cursorPosCallbackEvent(double x, double y) {
 #endif
 
     bool ret = false;
-    mLastInteraction = glfwGetTime();
+    double time = glfwGetTime();
+    /* Hide a tooltip that may currently be visible */
+    if (time - mLastInteraction > 0.5)
+        markDirty();
+    mLastInteraction = time;
     try {
         p -= Vector2i(1, 2);
 
@@ -528,7 +1205,8 @@ bool Screen::cursorPosCallbackEvent(double x, double y) {
             Widget *widget = findWidget(p);
             if (widget != nullptr && widget->cursor() != mCursor) {
                 mCursor = widget->cursor();
-                glfwSetCursor(mGLFWWindow, mCursors[(int) mCursor]);
+                if (mGLFWWindow)
+                    glfwSetCursor(mGLFWWindow, mCursors[(int) mCursor]);
             }
         } else {
             ret = mDragWidget->mouseDragEvent(
@@ -541,6 +1219,9 @@ bool Screen::cursorPosCallbackEvent(double x, double y) {
 
         mMousePos = p;
 
+        if (ret)
+            markDirty();
+
         return ret;
     } catch (const std::exception &e) {
         std::cerr << "Caught exception in event handler: " << e.what() << std::endl;
@@ -575,7 +1256,8 @@ bool Screen::mouseButtonCallbackEvent(int button, int action, int modifiers) {
 
         if (dropWidget != nullptr && dropWidget->cursor() != mCursor) {
             mCursor = dropWidget->cursor();
-            glfwSetCursor(mGLFWWindow, mCursors[(int) mCursor]);
+            if (mGLFWWindow)
+                glfwSetCursor(mGLFWWindow, mCursors[(int) mCursor]);
         }
 
         if (action == GLFW_PRESS && (button == GLFW_MOUSE_BUTTON_1 || button == GLFW_MOUSE_BUTTON_2)) {
@@ -590,8 +1272,11 @@ bool Screen::mouseButtonCallbackEvent(int button, int action, int modifiers) {
             mDragWidget = nullptr;
         }
 
-        return mouseButtonEvent(mMousePos, button, action == GLFW_PRESS,
-                                mModifiers);
+        bool ret = mouseButtonEvent(mMousePos, button, action == GLFW_PRESS,
+                                    mModifiers);
+        if (ret)
+            markDirty();
+        return ret;
     } catch (const std::exception &e) {
         std::cerr << "Caught exception in event handler: " << e.what() << std::endl;
         return false;
@@ -601,7 +1286,10 @@ bool Screen::mouseButtonCallbackEvent(int button, int action, int modifiers) {
 bool Screen::keyCallbackEvent(int key, int scancode, int action, int mods) {
     mLastInteraction = glfwGetTime();
     try {
-        return keyboardEvent(key, scancode, action, mods);
+        bool ret = keyboardEvent(key, scancode, action, mods);
+        if (ret)
+            markDirty();
+        return ret;
     } catch (const std::exception &e) {
         std::cerr << "Caught exception in event handler: " << e.what() << std::endl;
         return false;
@@ -611,7 +1299,10 @@ bool Screen::keyCallbackEvent(int key, int scancode, int action, int mods) {
 bool Screen::charCallbackEvent(unsigned int codepoint) {
     mLastInteraction = glfwGetTime();
     try {
-        return keyboardCharacterEvent(codepoint);
+        bool ret = keyboardCharacterEvent(codepoint);
+        if (ret)
+            markDirty();
+        return ret;
     } catch (const std::exception &e) {
         std::cerr << "Caught exception in event handler: " << e.what()
                   << std::endl;
@@ -623,7 +1314,10 @@ bool Screen::dropCallbackEvent(int count, const char **filenames) {
     std::vector<std::string> arg(count);
     for (int i = 0; i < count; ++i)
         arg[i] = filenames[i];
-    return dropEvent(arg);
+    bool ret = dropEvent(arg);
+    if (ret)
+        markDirty();
+    return ret;
 }
 
 bool Screen::scrollCallbackEvent(double x, double y) {
@@ -637,7 +1331,10 @@ bool Screen::scrollCallbackEvent(double x, double y) {
                     return false;
             }
         }
-        return scrollEvent(mMousePos, Vector2f(x, y));
+        bool ret = scrollEvent(mMousePos, Vector2f(x, y));
+        if (ret)
+            markDirty();
+        return ret;
     } catch (const std::exception &e) {
         std::cerr << "Caught exception in event handler: " << e.what()
                   << std::endl;
@@ -645,20 +1342,31 @@ bool Screen::scrollCallbackEvent(double x, double y) {
     }
 }
 
-bool Screen::resizeCallbackEvent(int, int) {
+bool Screen::resizeCallbackEvent(int width, int height) {
     Vector2i fbSize, size;
-    glfwGetFramebufferSize(mGLFWWindow, &fbSize[0], &fbSize[1]);
-    glfwGetWindowSize(mGLFWWindow, &size[0], &size[1]);
+    if (mGLFWWindow) {
+        glfwGetFramebufferSize(mGLFWWindow, &fbSize[0], &fbSize[1]);
+        glfwGetWindowSize(mGLFWWindow, &size[0], &size[1]);
 
 #if defined(_WIN32) || defined(__linux__)
-    size = (size.cast<float>() / mPixelRatio).cast<int>();
+        size = (size.cast<float>() / mPixelRatio).cast<int>();
 #endif
+    } else {
+        /* Headless: the arguments specify the new framebuffer size */
+        fbSize = Vector2i(width, height);
+        size = (fbSize.cast<float>() / mPixelRatio).cast<int>();
+    }
 
     if (fbSize == Vector2i(0, 0) || size == Vector2i(0, 0))
         return false;
 
+    bool resizeSurface = headless() && fbSize != mFBSize;
     mFBSize = fbSize; mSize = size;
+    if (resizeSurface)
+        createHeadlessSurface();
     mLastInteraction = glfwGetTime();
+    invalidateLayout();
+    markDirty();
 
     try {
         return resizeEvent(mSize);
@@ -700,7 +1408,7 @@ void Screen::disposeWindow(Window *window) {
 
 void Screen::centerWindow(Window *window) {
     if (window->size() == Vector2i::Zero()) {
-        window->setSize(window->preferredSize(mNVGContext));
+        window->setSize(window->cachedPreferredSize(mNVGContext));
         window->performLayout(mNVGContext);
     }
     window->setPosition((mSize - window->size()) / 2);
@@ -709,6 +1417,8 @@ void Screen::centerWindow(Window *window) {
 void Screen::moveWindowToFront(Window *window) {
     mChildren.erase(std::remove(mChildren.begin(), mChildren.end(), window), mChildren.end());
     mChildren.push_back(window);
+    mSpatialIndexValid = false;
+    markDirty();
     /* Brute force topological sort (no problem for a few windows..) */
     bool changed = false;
     do {
@@ -0,0 +1,111 @@
+/*
+    src/spatialindex.cpp -- Uniform grid over the bounds of child widgets
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/spatialindex.h>
+#include <nanogui/widget.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+NAMESPACE_BEGIN(nanogui)
+
+void SpatialIndex::build(const std::vector<Widget *> &children) {
+    mCellStart.clear();
+    mItems.clear();
+    mCells = Vector2i::Zero();
+
+    Vector2i lo = Vector2i::Constant(std::numeric_limits<int>::max()),
+             hi = Vector2i::Constant(std::numeric_limits<int>::min());
+    size_t count = 0;
+    for (const Widget *child : children) {
+        if (child->width() <= 0 || child->height() <= 0)
+            continue; /* Can't contain anything */
+        lo = lo.cwiseMin(child->position());
+        hi = hi.cwiseMax(child->position() + child->size());
+        count++;
+    }
+    if (count == 0)
+        return;
+
+    /* Aim for about one cell per child, with cells shaped like the bounds */
+    Vector2i extent = hi - lo;
+    float aspect = (float) extent.x() / (float) extent.y();
+    int nx = (int) std::ceil(std::sqrt(count * aspect));
+    nx = std::max(1, std::min(nx, 512));
+    int ny = std::max(1, std::min((int) ((count + nx - 1) / nx), 512));
+
+    std::vector<Vector4i, Eigen::aligned_allocator<Vector4i>> ranges(children.size());
+    while (true) {
+        mCells = Vector2i(nx, ny);
+        mCellSize = ((extent + mCells - Vector2i::Ones()).array() / mCells.array())
+                        .matrix().cwiseMax(Vector2i::Ones());
+        mOrigin = lo;
+        mCellStart.assign((size_t) nx * ny + 1, 0);
+
+        size_t total = 0;
+        for (size_t i = 0; i < children.size(); ++i) {
+            const Widget *child = children[i];
+            if (child->width() <= 0 || child->height() <= 0) {
+                ranges[i] = Vector4i(0, 0, -1, -1);
+                continue;
+            }
+            Vector2i c0 = ((child->position() - lo).array() / mCellSize.array()).matrix(),
+                     c1 = ((child->position() + child->size() - lo - Vector2i::Ones())
+                               .array() / mCellSize.array()).matrix();
+            c1 = c1.cwiseMin(mCells - Vector2i::Ones());
+            ranges[i] = Vector4i(c0.x(), c0.y(), c1.x(), c1.y());
+            for (int y = c0.y(); y <= c1.y(); ++y)
+                for (int x = c0.x(); x <= c1.x(); ++x)
+                    mCellStart[y * nx + x + 1]++;
+            total += (size_t) (c1.x() - c0.x() + 1) * (c1.y() - c0.y() + 1);
+        }
+
+        /* Many large, overlapping children would need lots of memory per
+           cell -- use a coarser grid in that case */
+        if (total <= 8 * count + (size_t) nx * ny || (nx == 1 && ny == 1))
+            break;
+        nx = std::max(1, nx / 2);
+        ny = std::max(1, ny / 2);
+    }
+
+    for (size_t i = 1; i < mCellStart.size(); ++i)
+        mCellStart[i] += mCellStart[i - 1];
+
+    /* Children are visited in order, hence every cell lists them back to front */
+    mItems.resize(mCellStart.back());
+    std::vector<uint32_t> cursor(mCellStart.begin(), mCellStart.end() - 1);
+    for (size_t i = 0; i < children.size(); ++i) {
+        const Vector4i &r = ranges[i];
+        for (int y = r.y(); y <= r.w(); ++y)
+            for (int x = r.x(); x <= r.z(); ++x)
+                mItems[cursor[y * nx + x]++] = (uint32_t) i;
+    }
+}
+
+SpatialIndex::Range SpatialIndex::query(const Vector2i &p) const {
+    Range range { nullptr, nullptr };
+    if (mCellStart.empty())
+        return range;
+
+    Vector2i d = p - mOrigin;
+    if ((d.array() < 0).any())
+        return range;
+    Vector2i c = (d.array() / mCellSize.array()).matrix();
+    if ((c.array() >= mCells.array()).any())
+        return range;
+
+    size_t cell = (size_t) c.y() * mCells.x() + c.x();
+    range.first = mItems.data() + mCellStart[cell];
+    range.last = mItems.data() + mCellStart[cell + 1];
+    return range;
+}
+
+NAMESPACE_END(nanogui)
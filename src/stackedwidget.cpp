@@ -35,14 +35,15 @@ void StackedWidget::performLayout(NVGcontext *ctx) {
     for (auto child : mChildren) {
         child->setPosition(Vector2i::Zero());
         child->setSize(mSize);
-        child->performLayout(ctx);
     }
+    performLayouts(ctx, mChildren);
 }
 
 Vector2i StackedWidget::preferredSize(NVGcontext *ctx) const {
+    cachePreferredSizes(ctx, mChildren);
     Vector2i size = Vector2i::Zero();
     for (auto child : mChildren)
-        size = size.cwiseMax(child->preferredSize(ctx));
+        size = size.cwiseMax(child->cachedPreferredSize(ctx));
     return size;
 }
 
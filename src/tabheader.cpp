@@ -14,6 +14,7 @@
 #include <nanogui/tabheader.h>
 #include <nanogui/theme.h>
 #include <nanogui/opengl.h>
+#include <nanogui/textmetrics.h>
 #include <numeric>
 
 NAMESPACE_BEGIN(nanogui)
@@ -22,9 +23,9 @@ TabHeader::TabButton::TabButton(TabHeader &header, const std::string &label)
     : mHeader(&header), mLabel(label) { }
 
 Vector2i TabHeader::TabButton::preferredSize(NVGcontext *ctx) const {
-    // No need to call nvg font related functions since this is done by the tab header implementation
     float bounds[4];
-    int labelWidth = nvgTextBounds(ctx, 0, 0, mLabel.c_str(), nullptr, bounds);
+    int labelWidth = textBounds(ctx, mHeader->font(), mHeader->fontSize(),
+                                NVG_ALIGN_LEFT | NVG_ALIGN_TOP, 0, 0, mLabel, bounds);
     int buttonWidth = labelWidth + 2 * mHeader->theme()->mTabButtonHorizontalPadding;
     int buttonHeight = bounds[3] - bounds[1] + 2 * mHeader->theme()->mTabButtonVerticalPadding;
     return Vector2i(buttonWidth, buttonHeight);
@@ -32,29 +33,33 @@ Vector2i TabHeader::TabButton::preferredSize(NVGcontext *ctx) const {
 
 void TabHeader::TabButton::calculateVisibleString(NVGcontext *ctx) {
     // The size must have been set in by the enclosing tab header.
-    NVGtextRow displayedText;
-    nvgTextBreakLines(ctx, mLabel.c_str(), nullptr, mSize.x(), &displayedText, 1);
+    const std::string &font = mHeader->font();
+    float fontSize = mHeader->fontSize();
+    const int align = NVG_ALIGN_LEFT | NVG_ALIGN_TOP;
+    mVisibleText.first = mLabel.c_str();
 
     // Check to see if the text need to be truncated.
-    if (displayedText.next[0]) {
-        auto truncatedWidth = nvgTextBounds(ctx, 0.0f, 0.0f,
-                                            displayedText.start, displayedText.end, nullptr);
-        auto dotsWidth = nvgTextBounds(ctx, 0.0f, 0.0f, dots, nullptr, nullptr);
-        while ((truncatedWidth + dotsWidth + mHeader->theme()->mTabButtonHorizontalPadding) > mSize.x()
-                && displayedText.end != displayedText.start) {
-            --displayedText.end;
-            truncatedWidth = nvgTextBounds(ctx, 0.0f, 0.0f,
-                                           displayedText.start, displayedText.end, nullptr);
-        }
+    float labelWidth = textBounds(ctx, font, fontSize, align, 0, 0, mLabel);
+    std::vector<NVGglyphPosition> glyphs(mLabel.size());
+    int nglyphs = glyphs.empty() ? 0 :
+        textGlyphPositions(ctx, font, fontSize, align, 0, 0, mLabel,
+                           glyphs.data(), (int) glyphs.size());
+    if (labelWidth > mSize.x() && nglyphs > 0) {
+        float dotsWidth = textBounds(ctx, font, fontSize, align, 0, 0, dots);
+        float available = mSize.x() - dotsWidth - mHeader->theme()->mTabButtonHorizontalPadding;
+
+        // Keep the longest prefix of glyphs that fits next to the dots.
+        int visible = 0;
+        while (visible + 1 < nglyphs && glyphs[visible + 1].x <= available)
+            ++visible;
 
         // Remember the truncated width to know where to display the dots.
-        mVisibleWidth = truncatedWidth;
-        mVisibleText.last = displayedText.end;
+        mVisibleWidth = glyphs[visible].x;
+        mVisibleText.last = glyphs[visible].str;
     } else {
         mVisibleText.last = nullptr;
         mVisibleWidth = 0;
     }
-    mVisibleText.first = displayedText.start;
 }
 
 void TabHeader::TabButton::drawAtPosition(NVGcontext *ctx, const Vector2i& position, bool active) {
@@ -152,6 +157,7 @@ TabHeader::TabHeader(Widget* parent, const std::string& font)
 void TabHeader::setActiveTab(int tabIndex) {
     assert(tabIndex < tabCount());
     mActiveTab = tabIndex;
+    markDirty();
     if (mCallback)
         mCallback(tabIndex);
 }
@@ -171,6 +177,7 @@ void TabHeader::addTab(const std::string & label) {
 void TabHeader::addTab(int index, const std::string &label) {
     assert(index <= tabCount());
     mTabButtons.insert(std::next(mTabButtons.begin(), index), TabButton(*this, label));
+    invalidateLayout();
     setActiveTab(index);
 }
 
@@ -183,6 +190,8 @@ int TabHeader::removeTab(const std::string &label) {
     mTabButtons.erase(element);
     if (index == mActiveTab && index != 0)
         setActiveTab(index - 1);
+    invalidateLayout();
+    markDirty();
     return index;
 }
 
@@ -191,6 +200,8 @@ void TabHeader::removeTab(int index) {
     mTabButtons.erase(std::next(mTabButtons.begin(), index));
     if (index == mActiveTab && index != 0)
         setActiveTab(index - 1);
+    invalidateLayout();
+    markDirty();
 }
 
 const std::string& TabHeader::tabLabelAt(int index) const {
@@ -300,10 +311,6 @@ void TabHeader::performLayout(NVGcontext* ctx) {
 }
 
 Vector2i TabHeader::preferredSize(NVGcontext* ctx) const {
-    // Set up the nvg context for measuring the text inside the tab buttons.
-    nvgFontFace(ctx, mFont.c_str());
-    nvgFontSize(ctx, fontSize());
-    nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
     Vector2i size = Vector2i(2*theme()->mTabControlWidth, 0);
     for (auto& tab : mTabButtons) {
         auto tabPreferred = tab.preferredSize(ctx);
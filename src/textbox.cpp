@@ -16,6 +16,7 @@
 #include <nanogui/screen.h>
 #include <nanogui/textbox.h>
 #include <nanogui/opengl.h>
+#include <nanogui/textmetrics.h>
 #include <nanogui/theme.h>
 #include <nanogui/serializer/core.h>
 #include <regex>
@@ -51,6 +52,7 @@ TextBox::TextBox(Widget *parent,const std::string &value)
 void TextBox::setEditable(bool editable) {
     mEditable = editable;
     setCursor(editable ? Cursor::IBeam : Cursor::Arrow);
+    markDirty();
 }
 
 void TextBox::setTheme(Theme *theme) {
@@ -69,14 +71,16 @@ Vector2i TextBox::preferredSize(NVGcontext *ctx) const {
         float uh = size(1) * 0.4f;
         uw = w * uh / h;
     } else if (!mUnits.empty()) {
-        uw = nvgTextBounds(ctx, 0, 0, mUnits.c_str(), nullptr, nullptr);
+        uw = textBounds(ctx, "sans", fontSize(), NVG_ALIGN_RIGHT | NVG_ALIGN_MIDDLE,
+                        0, 0, mUnits);
     }
     float sw = 0;
     if (mSpinnable) {
         sw = 14.f;
     }
 
-    float ts = nvgTextBounds(ctx, 0, 0, mValue.c_str(), nullptr, nullptr);
+    float ts = textBounds(ctx, "sans", fontSize(), NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE,
+                          0, 0, mValue);
     size(0) = size(1) + ts + uw + sw;
     return size;
 }
@@ -137,7 +141,8 @@ void TextBox::draw(NVGcontext* ctx) {
         nvgFill(ctx);
         unitWidth += 2;
     } else if (!mUnits.empty()) {
-        unitWidth = nvgTextBounds(ctx, 0, 0, mUnits.c_str(), nullptr, nullptr);
+        unitWidth = textBounds(ctx, "sans", fontSize(),
+                               NVG_ALIGN_RIGHT | NVG_ALIGN_MIDDLE, 0, 0, mUnits);
         nvgFillColor(ctx, Color(255, mEnabled ? 64 : 32));
         nvgTextAlign(ctx, NVG_ALIGN_RIGHT | NVG_ALIGN_MIDDLE);
         nvgText(ctx, mPos.x() + mSize.x() - xSpacing, drawPos.y(),
@@ -179,20 +184,21 @@ void TextBox::draw(NVGcontext* ctx) {
         nvgFontFace(ctx, "sans");
     }
 
+    int align = NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE;
     switch (mAlignment) {
         case Alignment::Left:
-            nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
             drawPos.x() += xSpacing + spinArrowsWidth;
             break;
         case Alignment::Right:
-            nvgTextAlign(ctx, NVG_ALIGN_RIGHT | NVG_ALIGN_MIDDLE);
+            align = NVG_ALIGN_RIGHT | NVG_ALIGN_MIDDLE;
             drawPos.x() += mSize.x() - unitWidth - xSpacing;
             break;
         case Alignment::Center:
-            nvgTextAlign(ctx, NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE);
+            align = NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE;
             drawPos.x() += mSize.x() * 0.5f;
             break;
     }
+    nvgTextAlign(ctx, align);
 
     nvgFontSize(ctx, fontSize());
     nvgFillColor(ctx, mEnabled && (!mCommitted || !mValue.empty()) ?
@@ -218,14 +224,14 @@ void TextBox::draw(NVGcontext* ctx) {
         const int maxGlyphs = 1024;
         NVGglyphPosition glyphs[maxGlyphs];
         float textBound[4];
-        nvgTextBounds(ctx, drawPos.x(), drawPos.y(), mValueTemp.c_str(),
-                      nullptr, textBound);
+        textBounds(ctx, "sans", fontSize(), align, drawPos.x(), drawPos.y(),
+                   mValueTemp, textBound);
         float lineh = textBound[3] - textBound[1];
 
         // find cursor positions
         int nglyphs =
-            nvgTextGlyphPositions(ctx, drawPos.x(), drawPos.y(),
-                                  mValueTemp.c_str(), nullptr, glyphs, maxGlyphs);
+            textGlyphPositions(ctx, "sans", fontSize(), align, drawPos.x(),
+                               drawPos.y(), mValueTemp, glyphs, maxGlyphs);
         updateCursor(ctx, textBound[2], glyphs, nglyphs);
 
         // compute text offset
@@ -243,12 +249,12 @@ void TextBox::draw(NVGcontext* ctx) {
 
         // draw text with offset
         nvgText(ctx, drawPos.x(), drawPos.y(), mValueTemp.c_str(), nullptr);
-        nvgTextBounds(ctx, drawPos.x(), drawPos.y(), mValueTemp.c_str(),
-                      nullptr, textBound);
+        textBounds(ctx, "sans", fontSize(), align, drawPos.x(), drawPos.y(),
+                   mValueTemp, textBound);
 
         // recompute cursor positions
-        nglyphs = nvgTextGlyphPositions(ctx, drawPos.x(), drawPos.y(),
-                mValueTemp.c_str(), nullptr, glyphs, maxGlyphs);
+        nglyphs = textGlyphPositions(ctx, "sans", fontSize(), align, drawPos.x(),
+                                     drawPos.y(), mValueTemp, glyphs, maxGlyphs);
 
         if (mCursorPos > -1) {
             if (mSelectionPos > -1) {
@@ -318,6 +324,7 @@ bool TextBox::mouseButtonEvent(const Vector2i &p, int button, bool down,
                 if (time - mLastClick < 0.25) {
                     /* Double-click: reset to default value */
                     mValue = mDefaultValue;
+                    invalidateLayout();
                     if (mCallback)
                         mCallback(mValue);
 
@@ -397,6 +404,10 @@ bool TextBox::focusEvent(bool focused) {
         mValidFormat = (mValueTemp == "") || checkFormat(mValueTemp, mFormat);
     }
 
+    /* The committed value determines the preferred size */
+    if (mValue != backup)
+        invalidateLayout();
+
     return true;
 }
 
@@ -0,0 +1,393 @@
+/*
+    src/textmetrics.cpp -- Cache for the results of NanoVG text
+    measurements
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/textmetrics.h>
+#include <nanogui/opengl.h>
+#include <algorithm>
+#include <cstring>
+
+NAMESPACE_BEGIN(nanogui)
+
+static std::unordered_map<NVGcontext *, TextMetricsCache *> __nanogui_text_caches;
+static std::mutex __nanogui_text_caches_mutex;
+
+/* Set the font state used by a measurement, which happens between
+   nvgSave() and nvgRestore() to leave the state of the caller untouched */
+static void setFontState(NVGcontext *ctx, const std::string &font, float size,
+                         int align, float lineHeight) {
+    nvgFontFace(ctx, font.c_str());
+    nvgFontSize(ctx, size);
+    nvgTextAlign(ctx, align);
+    nvgTextLineHeight(ctx, lineHeight);
+}
+
+/* NanoVG only rasterizes glyphs into the atlas of a context while measuring,
+   but skips glyphs that no longer fit. Measurement contexts are therefore
+   replaced after a number of uses. */
+static const size_t maxMeasureContextUses = 1024;
+
+/* Renderer callbacks of the measurement contexts, which never draw */
+static int measureRenderCreate(void *) { return 1; }
+static int measureRenderCreateTexture(void *, int, int, int, int, const unsigned char *) { return 1; }
+static int measureRenderDeleteTexture(void *, int) { return 1; }
+static int measureRenderUpdateTexture(void *, int, int, int, int, int, const unsigned char *) { return 1; }
+static void measureRenderDelete(void *) { }
+
+TextMetricsCache::TextMetricsCache(size_t capacity)
+    : mCapacity(std::max(capacity, (size_t) 1)), mHits(0), mMisses(0),
+      mGeneration(0), mPixelRatio(1.f), mContextGeneration(0) { }
+
+TextMetricsCache::~TextMetricsCache() {
+    for (auto &context : mIdleContexts)
+        nvgDeleteInternal(context.ctx);
+}
+
+void TextMetricsCache::addFont(const std::string &name, const unsigned char *data,
+                               size_t size) {
+    {
+        std::lock_guard<std::mutex> guard(mContextMutex);
+        auto it = std::find_if(mFonts.begin(), mFonts.end(),
+                               [&name](const Font &font) { return font.name == name; });
+        if (it != mFonts.end()) {
+            if (it->data == data && it->size == size)
+                return;
+            it->data = data;
+            it->size = size;
+        } else {
+            mFonts.push_back(Font { name, data, size });
+        }
+        mContextGeneration++;
+        for (auto &context : mIdleContexts)
+            nvgDeleteInternal(context.ctx);
+        mIdleContexts.clear();
+    }
+    clear();
+}
+
+void TextMetricsCache::setPixelRatio(float pixelRatio) {
+    {
+        std::lock_guard<std::mutex> guard(mContextMutex);
+        if (pixelRatio == mPixelRatio)
+            return;
+        mPixelRatio = pixelRatio;
+    }
+    clear();
+}
+
+void TextMetricsCache::setCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> guard(mMutex);
+    mCapacity = std::max(capacity, (size_t) 1);
+    while (mEntries.size() > mCapacity) {
+        mIndex.erase(mEntries.back().key);
+        mEntries.pop_back();
+    }
+}
+
+void TextMetricsCache::clear() {
+    std::lock_guard<std::mutex> guard(mMutex);
+    mIndex.clear();
+    mEntries.clear();
+    mGeneration++;
+}
+
+NVGcontext *TextMetricsCache::createContext(const std::vector<Font> &fonts) {
+    NVGparams params;
+    memset(&params, 0, sizeof(NVGparams));
+    params.renderCreate = measureRenderCreate;
+    params.renderCreateTexture = measureRenderCreateTexture;
+    params.renderDeleteTexture = measureRenderDeleteTexture;
+    params.renderUpdateTexture = measureRenderUpdateTexture;
+    params.renderDelete = measureRenderDelete;
+
+    NVGcontext *ctx = nvgCreateInternal(&params);
+    if (!ctx)
+        throw std::runtime_error("TextMetricsCache: could not create a measurement context!");
+    for (const auto &font : fonts) {
+        /* NanoVG does not modify or free the data */
+        if (nvgCreateFontMem(ctx, font.name.c_str(), (unsigned char *) font.data,
+                             (int) font.size, 0) == -1) {
+            nvgDeleteInternal(ctx);
+            throw std::runtime_error("TextMetricsCache: could not load font \"" +
+                                     font.name + "\"!");
+        }
+    }
+    return ctx;
+}
+
+bool TextMetricsCache::acquireContext(const std::string &font, MeasureContext &context,
+                                      float &pixelRatio) {
+    std::vector<Font> fonts;
+    {
+        std::lock_guard<std::mutex> guard(mContextMutex);
+        auto it = std::find_if(mFonts.begin(), mFonts.end(),
+                               [&font](const Font &f) { return f.name == font; });
+        if (it == mFonts.end())
+            return false;
+        pixelRatio = mPixelRatio;
+        if (!mIdleContexts.empty()) {
+            context = mIdleContexts.back();
+            mIdleContexts.pop_back();
+            return true;
+        }
+        fonts = mFonts;
+        context.generation = mContextGeneration;
+    }
+
+    /* Loading the fonts does not require the lock */
+    context.ctx = createContext(fonts);
+    context.uses = 0;
+    return true;
+}
+
+void TextMetricsCache::releaseContext(MeasureContext &context) {
+    {
+        std::lock_guard<std::mutex> guard(mContextMutex);
+        if (context.generation == mContextGeneration &&
+            ++context.uses < maxMeasureContextUses) {
+            mIdleContexts.push_back(context);
+            return;
+        }
+    }
+    nvgDeleteInternal(context.ctx);
+}
+
+bool TextMetricsCache::Key::operator==(const Key &k) const {
+    return hash == k.hash && kind == k.kind && align == k.align &&
+           size == k.size && lineHeight == k.lineHeight &&
+           breakWidth == k.breakWidth && *font == *k.font && *text == *k.text;
+}
+
+size_t TextMetricsCache::hashKey(const Key &key) {
+    size_t hash = std::hash<std::string>()(*key.text);
+    auto combine = [&hash](size_t value) {
+        hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    };
+    combine(std::hash<std::string>()(*key.font));
+    combine(std::hash<float>()(key.size));
+    combine(std::hash<float>()(key.lineHeight));
+    combine(std::hash<float>()(key.breakWidth));
+    combine((size_t) key.align * 4 + (size_t) key.kind);
+    return hash;
+}
+
+const TextMetricsCache::Entry &TextMetricsCache::lookup(NVGcontext *ctx, Key key,
+                                                       std::unique_lock<std::mutex> &guard) {
+    key.hash = hashKey(key);
+
+    auto it = mIndex.find(key);
+    if (it != mIndex.end()) {
+        mHits++;
+        mEntries.splice(mEntries.begin(), mEntries, it->second);
+        return *it->second;
+    }
+    mMisses++;
+    size_t generation = mGeneration;
+
+    /* Measure without holding the lock, so that other threads can look up
+       and measure text at the same time */
+    std::list<Entry> entries(1);
+    Entry &entry = entries.front();
+    entry.font = *key.font;
+    entry.text = *key.text;
+    entry.key = key;
+    entry.key.font = &entry.font;
+    entry.key.text = &entry.text;
+    entry.advance = 0.f;
+    std::fill(entry.bounds, entry.bounds + 4, 0.f);
+
+    guard.unlock();
+    measure(ctx, entry);
+    guard.lock();
+
+    /* Another thread may have measured the same text in the meantime */
+    it = mIndex.find(entry.key);
+    if (it != mIndex.end()) {
+        mEntries.splice(mEntries.begin(), mEntries, it->second);
+        return *it->second;
+    }
+
+    /* The cache was cleared while measuring (e.g. because the pixel ratio
+       changed), so the result is only returned to this caller */
+    if (generation != mGeneration) {
+        static thread_local std::list<Entry> scratch;
+        scratch.swap(entries);
+        return scratch.front();
+    }
+
+    if (mEntries.size() >= mCapacity) {
+        mIndex.erase(mEntries.back().key);
+        mEntries.pop_back();
+    }
+    /* Splicing keeps the address of the entry, which its key refers to */
+    mEntries.splice(mEntries.begin(), entries);
+    mIndex.emplace(entry.key, mEntries.begin());
+    return entry;
+}
+
+void TextMetricsCache::measure(NVGcontext *ctx, Entry &entry) {
+    MeasureContext context;
+    float pixelRatio = 1.f;
+    std::unique_lock<std::mutex> shared(mSharedMutex, std::defer_lock);
+    if (acquireContext(entry.font, context, pixelRatio)) {
+        ctx = context.ctx;
+    } else {
+        /* Unregistered font: fall back to the context of the caller */
+        shared.lock();
+        context.ctx = nullptr;
+    }
+
+    nvgSave(ctx);
+    /* NanoVG measures text at the resolution given by the transform and
+       the device pixel ratio of the current frame, which the measurement
+       contexts don't have */
+    if (context.ctx)
+        nvgScale(ctx, pixelRatio, pixelRatio);
+    const Key &key = entry.key;
+    setFontState(ctx, entry.font, key.size, key.align, key.lineHeight);
+    const char *str = entry.text.c_str(),
+               *end = str + entry.text.size();
+    switch (key.kind) {
+        case Kind::Bounds:
+            entry.advance = nvgTextBounds(ctx, 0, 0, str, end, entry.bounds);
+            break;
+
+        case Kind::BoxBounds:
+            nvgTextBoxBounds(ctx, 0, 0, key.breakWidth, str, end, entry.bounds);
+            break;
+
+        case Kind::Glyphs: {
+                /* There are never more glyphs than bytes */
+                std::vector<NVGglyphPosition> positions(entry.text.size());
+                int count = positions.empty() ? 0 :
+                    nvgTextGlyphPositions(ctx, 0, 0, str, end, positions.data(),
+                                          (int) positions.size());
+                entry.glyphs.resize((size_t) count);
+                for (int i = 0; i < count; ++i) {
+                    const NVGglyphPosition &p = positions[i];
+                    entry.glyphs[i] = Glyph { (size_t) (p.str - str), p.x, p.minx, p.maxx };
+                }
+            }
+            break;
+    }
+    nvgRestore(ctx);
+
+    if (context.ctx)
+        releaseContext(context);
+}
+
+float TextMetricsCache::textBounds(NVGcontext *ctx, const std::string &font,
+                                   float size, int align, float x, float y,
+                                   const std::string &text, float *bounds) {
+    std::unique_lock<std::mutex> guard(mMutex);
+    const Entry &entry =
+        lookup(ctx, Key { Kind::Bounds, align, size, 0.f, 0.f, &font, &text, 0 }, guard);
+    if (bounds) {
+        bounds[0] = entry.bounds[0] + x; bounds[1] = entry.bounds[1] + y;
+        bounds[2] = entry.bounds[2] + x; bounds[3] = entry.bounds[3] + y;
+    }
+    return entry.advance;
+}
+
+void TextMetricsCache::textBoxBounds(NVGcontext *ctx, const std::string &font,
+                                     float size, int align, float lineHeight,
+                                     float x, float y, float breakWidth,
+                                     const std::string &text, float *bounds) {
+    std::unique_lock<std::mutex> guard(mMutex);
+    const Entry &entry = lookup(ctx, Key { Kind::BoxBounds, align, size, lineHeight,
+                                           breakWidth, &font, &text, 0 }, guard);
+    bounds[0] = entry.bounds[0] + x; bounds[1] = entry.bounds[1] + y;
+    bounds[2] = entry.bounds[2] + x; bounds[3] = entry.bounds[3] + y;
+}
+
+int TextMetricsCache::textGlyphPositions(NVGcontext *ctx, const std::string &font,
+                                         float size, int align, float x, float y,
+                                         const std::string &text,
+                                         NVGglyphPosition *positions,
+                                         int maxPositions) {
+    (void) y; /* Glyph positions are horizontal only */
+    std::unique_lock<std::mutex> guard(mMutex);
+    const Entry &entry =
+        lookup(ctx, Key { Kind::Glyphs, align, size, 0.f, 0.f, &font, &text, 0 }, guard);
+    int count = std::min((int) entry.glyphs.size(), std::max(maxPositions, 0));
+    for (int i = 0; i < count; ++i) {
+        const Glyph &g = entry.glyphs[i];
+        positions[i].str = text.c_str() + g.offset;
+        positions[i].x = g.x + x;
+        positions[i].minx = g.minx + x;
+        positions[i].maxx = g.maxx + x;
+    }
+    return count;
+}
+
+TextMetricsCache *TextMetricsCache::find(NVGcontext *ctx) {
+    std::lock_guard<std::mutex> guard(__nanogui_text_caches_mutex);
+    auto it = __nanogui_text_caches.find(ctx);
+    return it != __nanogui_text_caches.end() ? it->second : nullptr;
+}
+
+void TextMetricsCache::registerCache(NVGcontext *ctx, TextMetricsCache *cache) {
+    std::lock_guard<std::mutex> guard(__nanogui_text_caches_mutex);
+    if (cache)
+        __nanogui_text_caches[ctx] = cache;
+    else
+        __nanogui_text_caches.erase(ctx);
+}
+
+float textBounds(NVGcontext *ctx, const std::string &font, float size, int align,
+                 float x, float y, const std::string &text, float *bounds) {
+    TextMetricsCache *cache = TextMetricsCache::find(ctx);
+    if (cache)
+        return cache->textBounds(ctx, font, size, align, x, y, text, bounds);
+
+    nvgSave(ctx);
+    setFontState(ctx, font, size, align, 1.f);
+    float advance = nvgTextBounds(ctx, x, y, text.c_str(),
+                                  text.c_str() + text.size(), bounds);
+    nvgRestore(ctx);
+    return advance;
+}
+
+void textBoxBounds(NVGcontext *ctx, const std::string &font, float size, int align,
+                   float lineHeight, float x, float y, float breakWidth,
+                   const std::string &text, float *bounds) {
+    TextMetricsCache *cache = TextMetricsCache::find(ctx);
+    if (cache) {
+        cache->textBoxBounds(ctx, font, size, align, lineHeight, x, y,
+                             breakWidth, text, bounds);
+        return;
+    }
+
+    nvgSave(ctx);
+    setFontState(ctx, font, size, align, lineHeight);
+    nvgTextBoxBounds(ctx, x, y, breakWidth, text.c_str(),
+                     text.c_str() + text.size(), bounds);
+    nvgRestore(ctx);
+}
+
+int textGlyphPositions(NVGcontext *ctx, const std::string &font, float size,
+                       int align, float x, float y, const std::string &text,
+                       NVGglyphPosition *positions, int maxPositions) {
+    TextMetricsCache *cache = TextMetricsCache::find(ctx);
+    if (cache)
+        return cache->textGlyphPositions(ctx, font, size, align, x, y, text,
+                                         positions, maxPositions);
+
+    nvgSave(ctx);
+    setFontState(ctx, font, size, align, 1.f);
+    int count = nvgTextGlyphPositions(ctx, x, y, text.c_str(),
+                                      text.c_str() + text.size(), positions,
+                                      maxPositions);
+    nvgRestore(ctx);
+    return count;
+}
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,206 @@
+/*
+    src/textureatlas.cpp -- Packs many small images into a single texture
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/textureatlas.h>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+NAMESPACE_BEGIN(nanogui)
+
+TextureAtlas::TextureAtlas(const Vector2i &size, int padding)
+    : mSize(size), mPadding(padding), mTexture(0), mImageCount(0), mWastedArea(0),
+      mVersion(0) {
+    if (size.minCoeff() <= 0 || padding < 0)
+        throw std::runtime_error("TextureAtlas: invalid size or padding!");
+    mSkyline.push_back(SkylineNode { 0, 0, size.x() });
+
+    /* Start out transparent, so that the padding between images is too */
+    std::vector<uint8_t> zero((size_t) size.x() * (size_t) size.y() * 4, 0);
+    glGenTextures(1, &mTexture);
+    glBindTexture(GL_TEXTURE_2D, mTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.x(), size.y(), 0, GL_RGBA,
+                 GL_UNSIGNED_BYTE, zero.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+TextureAtlas::~TextureAtlas() {
+    glDeleteTextures(1, &mTexture);
+}
+
+int TextureAtlas::fit(size_t i, int width, int height) const {
+    int x = mSkyline[i].x, y = 0, remaining = width;
+    if (x + width > mSize.x())
+        return -1;
+    while (remaining > 0) {
+        if (i == mSkyline.size())
+            return -1;
+        y = std::max(y, mSkyline[i].y);
+        if (y + height > mSize.y())
+            return -1;
+        remaining -= mSkyline[i].width;
+        ++i;
+    }
+    return y;
+}
+
+bool TextureAtlas::allocate(const Vector2i &size, Vector2i &position) {
+    /* Bottom-left heuristic: lowest top edge, then narrowest segment */
+    int bestTop = INT_MAX, bestWidth = INT_MAX;
+    size_t best = mSkyline.size();
+    for (size_t i = 0; i < mSkyline.size(); ++i) {
+        int y = fit(i, size.x(), size.y());
+        if (y < 0)
+            continue;
+        if (y + size.y() < bestTop || (y + size.y() == bestTop && mSkyline[i].width < bestWidth)) {
+            best = i;
+            bestTop = y + size.y();
+            bestWidth = mSkyline[i].width;
+            position = Vector2i(mSkyline[i].x, y);
+        }
+    }
+    if (best == mSkyline.size())
+        return false;
+
+    /* Raise the skyline over the new rectangle */
+    mSkyline.insert(mSkyline.begin() + best,
+                    SkylineNode { position.x(), position.y() + size.y(), size.x() });
+    for (size_t i = best + 1; i < mSkyline.size(); ++i) {
+        SkylineNode &node = mSkyline[i], &prev = mSkyline[i - 1];
+        int shrink = prev.x + prev.width - node.x;
+        if (shrink <= 0)
+            break;
+        node.x += shrink;
+        node.width -= shrink;
+        if (node.width > 0)
+            break;
+        mSkyline.erase(mSkyline.begin() + i);
+        --i;
+    }
+
+    /* Merge neighboring segments at the same height */
+    for (size_t i = 0; i + 1 < mSkyline.size(); ++i) {
+        if (mSkyline[i].y == mSkyline[i + 1].y) {
+            mSkyline[i].width += mSkyline[i + 1].width;
+            mSkyline.erase(mSkyline.begin() + i + 1);
+            --i;
+        }
+    }
+    return true;
+}
+
+void TextureAtlas::upload(const Image &image) {
+    glBindTexture(GL_TEXTURE_2D, mTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, image.position.x(), image.position.y(),
+                    image.size.x(), image.size.y(), GL_RGBA, GL_UNSIGNED_BYTE,
+                    image.data.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+int TextureAtlas::add(const Vector2i &size, const uint8_t *data, size_t stride) {
+    if (size.minCoeff() <= 0)
+        throw std::runtime_error("TextureAtlas::add(): invalid image size!");
+    if (stride == 0)
+        stride = (size_t) size.x() * 4;
+
+    Vector2i position, padded = size + Vector2i::Constant(mPadding);
+    if (!allocate(padded, position)) {
+        /* Repacking only helps if removed images left enough space */
+        if (mWastedArea < (size_t) padded.x() * (size_t) padded.y())
+            return -1;
+        defragment();
+        if (!allocate(padded, position))
+            return -1;
+    }
+
+    Image image { position, size, std::vector<uint8_t>((size_t) size.x() * size.y() * 4), true };
+    for (int y = 0; y < size.y(); ++y)
+        memcpy(image.data.data() + (size_t) y * size.x() * 4, data + y * stride,
+               (size_t) size.x() * 4);
+    upload(image);
+
+    int id;
+    if (!mFreeIds.empty()) {
+        id = mFreeIds.back();
+        mFreeIds.pop_back();
+        mImages[id] = std::move(image);
+    } else {
+        id = (int) mImages.size();
+        mImages.push_back(std::move(image));
+    }
+    mImageCount++;
+    return id;
+}
+
+void TextureAtlas::remove(int id) {
+    if (id < 0 || id >= (int) mImages.size() || !mImages[id].valid)
+        throw std::runtime_error("TextureAtlas::remove(): invalid image!");
+    Image &image = mImages[id];
+    mWastedArea += (size_t) (image.size.x() + mPadding) * (image.size.y() + mPadding);
+    image.valid = false;
+    image.data = std::vector<uint8_t>();
+    mFreeIds.push_back(id);
+    mImageCount--;
+}
+
+Vector4i TextureAtlas::region(int id) const {
+    if (id < 0 || id >= (int) mImages.size() || !mImages[id].valid)
+        throw std::runtime_error("TextureAtlas::region(): invalid image!");
+    const Image &image = mImages[id];
+    return Vector4i(image.position.x(), image.position.y(), image.size.x(), image.size.y());
+}
+
+float TextureAtlas::occupancy() const {
+    size_t area = 0;
+    for (const Image &image : mImages)
+        if (image.valid)
+            area += (size_t) image.size.x() * image.size.y();
+    return area / (float) ((size_t) mSize.x() * mSize.y());
+}
+
+void TextureAtlas::defragment() {
+    /* Tall images first, which packs tightly with the skyline heuristic */
+    std::vector<int> order;
+    for (int i = 0; i < (int) mImages.size(); ++i)
+        if (mImages[i].valid)
+            order.push_back(i);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return mImages[a].size.y() > mImages[b].size.y();
+    });
+
+    std::vector<SkylineNode> skyline = std::move(mSkyline);
+    std::vector<Vector2i> positions;
+    mSkyline = { SkylineNode { 0, 0, mSize.x() } };
+    for (int id : order) {
+        Vector2i position;
+        if (!allocate(mImages[id].size + Vector2i::Constant(mPadding), position)) {
+            /* Rare, since the heuristic packs sorted images more tightly:
+               keep the current layout */
+            mSkyline = std::move(skyline);
+            return;
+        }
+        positions.push_back(position);
+    }
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        Image &image = mImages[order[i]];
+        image.position = positions[i];
+        upload(image);
+    }
+    mWastedArea = 0;
+    mVersion++;
+}
+
+NAMESPACE_END(nanogui)
@@ -13,6 +13,7 @@
 
 #include <nanogui/theme.h>
 #include <nanogui/opengl.h>
+#include <nanogui/textmetrics.h>
 #include <nanogui/entypo.h>
 #include <nanogui_resources.h>
 
@@ -88,6 +89,14 @@ Theme::Theme(NVGcontext *ctx) {
                                   entypo_ttf_size, 0);
     if (mFontNormal == -1 || mFontBold == -1 || mFontIcons == -1)
         throw std::runtime_error("Could not load fonts!");
+
+    /* Allow measuring text without the NanoVG context (e.g. during a
+       parallel layout) */
+    if (TextMetricsCache *cache = TextMetricsCache::find(ctx)) {
+        cache->addFont("sans", roboto_regular_ttf, roboto_regular_ttf_size);
+        cache->addFont("sans-bold", roboto_bold_ttf, roboto_bold_ttf_size);
+        cache->addFont("icons", entypo_ttf, entypo_ttf_size);
+    }
 }
 
 NAMESPACE_END(nanogui)
@@ -0,0 +1,116 @@
+/*
+    src/threadpool.cpp -- Pool of worker threads for data-parallel loops
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/threadpool.h>
+#include <algorithm>
+#include <atomic>
+
+NAMESPACE_BEGIN(nanogui)
+
+struct ThreadPool::Loop {
+    std::function<void(size_t)> func;
+    size_t count;
+    std::atomic<size_t> next { 0 }, finished { 0 };
+    std::exception_ptr error;
+};
+
+ThreadPool::ThreadPool(size_t threadCount) : mShutdown(false) {
+    for (size_t i = 0; i < threadCount; ++i)
+        mThreads.emplace_back([this] { workerMain(); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        mShutdown = true;
+    }
+    mWorkAvailable.notify_all();
+    for (auto &thread : mThreads)
+        thread.join();
+}
+
+void ThreadPool::work(Loop &loop) {
+    size_t i;
+    while ((i = loop.next++) < loop.count) {
+        try {
+            loop.func(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(mMutex);
+            if (!loop.error)
+                loop.error = std::current_exception();
+        }
+        if (++loop.finished == loop.count) {
+            /* Lock to avoid a lost wakeup of the thread that started the loop */
+            std::lock_guard<std::mutex> guard(mMutex);
+            mLoopFinished.notify_all();
+        }
+    }
+}
+
+void ThreadPool::workerMain() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+        mWorkAvailable.wait(lock, [this] { return mShutdown || !mLoops.empty(); });
+        if (mShutdown)
+            return;
+
+        /* Prefer the innermost of nested loops, whose iterations are
+           awaited by the iterations of the enclosing ones */
+        std::shared_ptr<Loop> loop = mLoops.back();
+        if (loop->next >= loop->count) {
+            mLoops.pop_back();
+            continue;
+        }
+
+        lock.unlock();
+        work(*loop);
+        lock.lock();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)> &func) {
+    if (count == 0)
+        return;
+    if (mThreads.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i)
+            func(i);
+        return;
+    }
+
+    auto loop = std::make_shared<Loop>();
+    loop->func = func;
+    loop->count = count;
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        mLoops.push_back(loop);
+    }
+    mWorkAvailable.notify_all();
+
+    work(*loop);
+
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        auto it = std::find(mLoops.begin(), mLoops.end(), loop);
+        if (it != mLoops.end())
+            mLoops.erase(it);
+        mLoopFinished.wait(lock, [&] { return loop->finished == loop->count; });
+    }
+
+    if (loop->error)
+        std::rethrow_exception(loop->error);
+}
+
+ThreadPool *ThreadPool::shared() {
+    static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+    return &pool;
+}
+
+NAMESPACE_END(nanogui)
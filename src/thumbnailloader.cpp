@@ -0,0 +1,160 @@
+/*
+    src/thumbnailloader.cpp -- Decodes images into thumbnails on worker
+    threads
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/thumbnailloader.h>
+#include <nanogui/threadpool.h>
+#include <nanogui/opengl.h>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__GNUC__)
+#  pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#endif
+#if defined(_WIN32)
+#  pragma warning(push)
+#  pragma warning(disable: 4457 4456 4005 4312)
+#endif
+
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#if defined(_WIN32)
+#  pragma warning(pop)
+#endif
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Decoding runs on a pool of its own that occupies at most half of the
+   cores, so that it never delays the loops of ThreadPool::shared() (e.g.
+   a parallel layout). The thread of each loader participates as well. */
+static ThreadPool *decoderPool() {
+    static ThreadPool pool(std::max(std::thread::hardware_concurrency() / 2, 1u) - 1);
+    return &pool;
+}
+
+ThumbnailLoader::ThumbnailLoader(const std::vector<std::string> &filenames, int thumbnailSize)
+    : mFilenames(filenames), mThumbnailSize(thumbnailSize), mFetched(0),
+      mClaimed(filenames.size(), false), mNext(0), mPriorityBegin(0), mPriorityEnd(0),
+      mCancelled(false) {
+    if (thumbnailSize <= 0)
+        throw std::runtime_error("ThumbnailLoader: invalid thumbnail size!");
+    mThread = std::thread([this] {
+        /* Every iteration decodes one file, but not necessarily the i-th:
+           the order is determined by claim() */
+        decoderPool()->parallelFor(mFilenames.size(), [this](size_t) {
+            size_t index;
+            if (mCancelled || !claim(index))
+                return;
+            Thumbnail thumbnail = decode(index);
+            std::lock_guard<std::mutex> guard(mMutex);
+            mDecoded.push_back(std::move(thumbnail));
+        });
+    });
+}
+
+ThumbnailLoader::~ThumbnailLoader() {
+    mCancelled = true;
+    mThread.join();
+}
+
+void ThumbnailLoader::prioritize(size_t begin, size_t end) {
+    std::lock_guard<std::mutex> guard(mMutex);
+    mPriorityBegin = std::min(begin, mFilenames.size());
+    mPriorityEnd = std::min(end, mFilenames.size());
+}
+
+bool ThumbnailLoader::claim(size_t &index) {
+    std::lock_guard<std::mutex> guard(mMutex);
+    for (size_t i = mPriorityBegin; i < mPriorityEnd; ++i) {
+        if (!mClaimed[i]) {
+            mClaimed[i] = true;
+            index = i;
+            return true;
+        }
+    }
+    while (mNext < mClaimed.size() && mClaimed[mNext])
+        mNext++;
+    if (mNext == mClaimed.size())
+        return false;
+    mClaimed[mNext] = true;
+    index = mNext;
+    return true;
+}
+
+ThumbnailLoader::Thumbnail ThumbnailLoader::decode(size_t index) const {
+    Thumbnail thumbnail { index, 0, 0, { } };
+    int w, h, n;
+    uint8_t *data = stbi_load(mFilenames[index].c_str(), &w, &h, &n, 4);
+    if (!data)
+        return thumbnail;
+
+    /* Downscale with a box filter so that the smaller side fits */
+    float scale = std::min(1.f, mThumbnailSize / (float) std::min(w, h));
+    int tw = std::max(1, (int) std::round(w * scale)),
+        th = std::max(1, (int) std::round(h * scale));
+    thumbnail.width = tw;
+    thumbnail.height = th;
+    thumbnail.data.resize((size_t) tw * (size_t) th * 4);
+
+    for (int ty = 0; ty < th; ++ty) {
+        int y0 = (int) ((int64_t) ty * h / th), y1 = std::max(y0 + 1, (int) ((int64_t) (ty + 1) * h / th));
+        for (int tx = 0; tx < tw; ++tx) {
+            int x0 = (int) ((int64_t) tx * w / tw), x1 = std::max(x0 + 1, (int) ((int64_t) (tx + 1) * w / tw));
+            uint32_t sum[4] = { 0, 0, 0, 0 };
+            for (int y = y0; y < y1; ++y) {
+                const uint8_t *row = data + ((size_t) y * w + x0) * 4;
+                for (int x = x0; x < x1; ++x, row += 4)
+                    for (int c = 0; c < 4; ++c)
+                        sum[c] += row[c];
+            }
+            uint32_t count = (uint32_t) ((y1 - y0) * (x1 - x0));
+            uint8_t *target = thumbnail.data.data() + ((size_t) ty * tw + tx) * 4;
+            for (int c = 0; c < 4; ++c)
+                target[c] = (uint8_t) ((sum[c] + count / 2) / count);
+        }
+    }
+
+    stbi_image_free(data);
+    return thumbnail;
+}
+
+size_t ThumbnailLoader::fetch(double budget,
+                              const std::function<void(size_t, const Vector2i &, const uint8_t *)> &callback) {
+    double start = glfwGetTime();
+    size_t fetched = 0;
+
+    while (fetched == 0 || glfwGetTime() - start < budget) {
+        Thumbnail thumbnail;
+        {
+            std::lock_guard<std::mutex> guard(mMutex);
+            if (mDecoded.empty())
+                break;
+            thumbnail = std::move(mDecoded.front());
+            mDecoded.pop_front();
+        }
+
+        mFetched++;
+        fetched++;
+        callback(thumbnail.index, Vector2i(thumbnail.width, thumbnail.height),
+                 thumbnail.data.empty() ? nullptr : thumbnail.data.data());
+    }
+
+    return fetched;
+}
+
+bool ThumbnailLoader::hasDecoded() const {
+    std::lock_guard<std::mutex> guard(mMutex);
+    return !mDecoded.empty();
+}
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,299 @@
+/*
+    src/tiledimage.cpp -- Tiled image pyramids that are streamed to the
+    GPU on demand
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/tiledimage.h>
+#include <cstring>
+
+#if defined(_WIN32)
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Number of loaded tiles that may wait for their upload before the loader
+   thread pauses */
+static const size_t maxLoadedTiles = 16;
+
+/* Seconds before a tile that failed to load is requested again */
+static const double failedRetryInterval = 5.0;
+
+TiledImageSource::TiledImageSource(const Vector2i &size, int tileSize, const Loader &loader)
+    : mSize(size), mTileSize(tileSize), mLevelCount(1), mLoader(loader) {
+    if (size.minCoeff() <= 0 || tileSize <= 0)
+        throw std::runtime_error("TiledImageSource: invalid image or tile size!");
+    while (levelSize(mLevelCount - 1).maxCoeff() > tileSize)
+        mLevelCount++;
+}
+
+Vector2i TiledImageSource::levelSize(int level) const {
+    int64_t factor = (int64_t) 1 << level;
+    return Vector2i((int) ((mSize.x() + factor - 1) / factor),
+                    (int) ((mSize.y() + factor - 1) / factor));
+}
+
+Vector2i TiledImageSource::tileCount(int level) const {
+    Vector2i size = levelSize(level);
+    return Vector2i((size.x() + mTileSize - 1) / mTileSize,
+                    (size.y() + mTileSize - 1) / mTileSize);
+}
+
+bool TiledImageSource::loadTile(int level, const Vector2i &tile, uint8_t *data) {
+    if (!mLoader)
+        return false;
+    return mLoader(level, tile, data);
+}
+
+MappedImageSource::MappedImageSource(const std::string &filename, const Vector2i &size,
+                                     int tileSize, size_t offset)
+    : TiledImageSource(size, tileSize), mData(nullptr), mMappedSize(0), mOffset(offset) {
+    size_t levelOffset = 0;
+    for (int level = 0; level < mLevelCount; ++level) {
+        mLevelOffsets.push_back(levelOffset);
+        Vector2i count = tileCount(level);
+        levelOffset += (size_t) count.x() * (size_t) count.y() * tileBytes();
+    }
+    size_t required = offset + levelOffset;
+
+#if defined(_WIN32)
+    mFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (mFile == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("MappedImageSource: could not open \"" + filename + "\"!");
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(mFile, &fileSize);
+    mMappedSize = (size_t) fileSize.QuadPart;
+    mMapping = mMappedSize >= required
+        ? CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    if (mMapping)
+        mData = (const uint8_t *) MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+    if (!mData) {
+        if (mMapping)
+            CloseHandle(mMapping);
+        CloseHandle(mFile);
+        throw std::runtime_error("MappedImageSource: could not map \"" + filename +
+                                 "\" (is it large enough?)");
+    }
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("MappedImageSource: could not open \"" + filename + "\"!");
+    struct stat st;
+    void *data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t) st.st_size >= required) {
+        mMappedSize = (size_t) st.st_size;
+        data = mmap(nullptr, mMappedSize, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    /* The mapping remains valid after closing the file */
+    close(fd);
+    if (data == MAP_FAILED)
+        throw std::runtime_error("MappedImageSource: could not map \"" + filename +
+                                 "\" (is it large enough?)");
+    mData = (const uint8_t *) data;
+#endif
+}
+
+MappedImageSource::~MappedImageSource() {
+#if defined(_WIN32)
+    UnmapViewOfFile(mData);
+    CloseHandle(mMapping);
+    CloseHandle(mFile);
+#else
+    munmap((void *) mData, mMappedSize);
+#endif
+}
+
+bool MappedImageSource::loadTile(int level, const Vector2i &tile, uint8_t *data) {
+    Vector2i count = tileCount(level);
+    size_t index = (size_t) tile.y() * (size_t) count.x() + (size_t) tile.x();
+    memcpy(data, mData + mOffset + mLevelOffsets[level] + index * tileBytes(), tileBytes());
+    return true;
+}
+
+size_t MappedImageSource::fileSize(const Vector2i &size, int tileSize) {
+    ref<TiledImageSource> source = new TiledImageSource(size, tileSize);
+    size_t result = 0;
+    for (int level = 0; level < source->levelCount(); ++level) {
+        Vector2i count = source->tileCount(level);
+        result += (size_t) count.x() * (size_t) count.y() * source->tileBytes();
+    }
+    return result;
+}
+
+TileCache::TileCache(TiledImageSource *source)
+    : mSource(source), mMemoryBudget((size_t) 256 * 1024 * 1024), mFrame(0),
+      mShutdown(false) {
+    mThread = std::thread([this] { loaderMain(); });
+}
+
+TileCache::~TileCache() {
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        mShutdown = true;
+    }
+    mCondition.notify_all();
+    mThread.join();
+
+    for (auto &entry : mResident)
+        glDeleteTextures(1, &entry.second.texture);
+}
+
+void TileCache::loaderMain() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+        mCondition.wait(lock, [this] {
+            return mShutdown || (!mRequests.empty() && mLoaded.size() < maxLoadedTiles);
+        });
+        if (mShutdown)
+            return;
+
+        /* Newest request first: it belongs to the most recent view */
+        uint64_t key = mRequests.front();
+        mRequests.pop_front();
+        int level = (int) (key >> 48);
+        Vector2i tile((int) ((key >> 24) & 0xFFFFFF), (int) (key & 0xFFFFFF));
+
+        lock.unlock();
+        std::vector<uint8_t> data(mSource->tileBytes());
+        bool success;
+        try {
+            success = mSource->loadTile(level, tile, data.data());
+        } catch (const std::exception &) {
+            success = false;
+        }
+        double time = glfwGetTime();
+        lock.lock();
+
+        if (success) {
+            mLoaded.push_back(Loaded { key, std::move(data) });
+        } else {
+            mPending.erase(key);
+            mFailed[key] = time;
+        }
+    }
+}
+
+void TileCache::beginFrame() {
+    mFrame++;
+    std::lock_guard<std::mutex> guard(mMutex);
+    for (uint64_t key : mRequests)
+        mPending.erase(key);
+    mRequests.clear();
+}
+
+GLuint TileCache::texture(int level, const Vector2i &tile) {
+    auto it = mResident.find(key(level, tile));
+    if (it == mResident.end())
+        return 0;
+    Resident &resident = it->second;
+    resident.lastUsed = mFrame;
+    mLRU.splice(mLRU.begin(), mLRU, resident.lruEntry);
+    return resident.texture;
+}
+
+void TileCache::request(int level, const Vector2i &tile) {
+    uint64_t k = key(level, tile);
+    if (mResident.find(k) != mResident.end())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        if (mPending.count(k))
+            return;
+        auto it = mFailed.find(k);
+        if (it != mFailed.end()) {
+            if (glfwGetTime() - it->second < failedRetryInterval)
+                return;
+            mFailed.erase(it);
+        }
+        mPending.insert(k);
+        mRequests.push_front(k);
+    }
+    mCondition.notify_one();
+}
+
+size_t TileCache::upload(double budget) {
+    double start = glfwGetTime();
+    int tileSize = mSource->tileSize();
+    size_t uploaded = 0;
+
+    while (uploaded == 0 || glfwGetTime() - start < budget) {
+        Loaded loaded;
+        {
+            std::lock_guard<std::mutex> guard(mMutex);
+            if (mLoaded.empty())
+                break;
+            loaded = std::move(mLoaded.front());
+            mLoaded.pop_front();
+        }
+        /* The loader may continue */
+        mCondition.notify_one();
+
+        /* Evict the least recently used tiles until the new one fits into
+           the budget (which may have been lowered), unless they are needed
+           by the current frame. The last texture is recycled. */
+        GLuint texture = 0;
+        while (!mLRU.empty() && memoryUsage() + textureBytes() > mMemoryBudget) {
+            auto it = mResident.find(mLRU.back());
+            if (it->second.lastUsed == mFrame)
+                break;
+            if (texture)
+                glDeleteTextures(1, &texture);
+            texture = it->second.texture;
+            mResident.erase(it);
+            mLRU.pop_back();
+        }
+
+        if (texture) {
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, tileSize, tileSize, GL_RGBA,
+                            GL_UNSIGNED_BYTE, loaded.data.data());
+        } else {
+            glGenTextures(1, &texture);
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, tileSize, tileSize, 0, GL_RGBA,
+                         GL_UNSIGNED_BYTE, loaded.data.data());
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+        /* Smooth minification between two levels of the pyramid */
+        glGenerateMipmap(GL_TEXTURE_2D);
+
+        mLRU.push_front(loaded.key);
+        mResident[loaded.key] = Resident { texture, mFrame, mLRU.begin() };
+        {
+            std::lock_guard<std::mutex> guard(mMutex);
+            mPending.erase(loaded.key);
+        }
+        uploaded++;
+    }
+
+    return uploaded;
+}
+
+bool TileCache::hasLoadedTiles() const {
+    std::lock_guard<std::mutex> guard(mMutex);
+    return !mLoaded.empty();
+}
+
+bool TileCache::busy() const {
+    std::lock_guard<std::mutex> guard(mMutex);
+    return !mPending.empty();
+}
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,322 @@
+/*
+    src/virtuallist.cpp -- Scrollable list that only creates widgets for
+    the rows that are currently visible
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/virtuallist.h>
+#include <nanogui/label.h>
+#include <nanogui/screen.h>
+#include <nanogui/theme.h>
+#include <nanogui/opengl.h>
+#include <nanogui/serializer/core.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+/* Width of the scrollbar area and left margin of the rows */
+static const int scrollbarWidth = 12, rowMargin = 4;
+
+/* Rows need a NanoVG context for their layout, but the list may be modified
+   before it has been attached to a screen */
+static NVGcontext *findContext(Widget *widget) {
+    while (widget->parent())
+        widget = widget->parent();
+    Screen *screen = dynamic_cast<Screen *>(widget);
+    return screen ? screen->nvgContext() : nullptr;
+}
+
+VirtualList::VirtualList(Widget *parent)
+    : Widget(parent), mItemCount(0), mRowHeight(20), mSelectedIndex(-1),
+      mOffset(0.0), mDragScrollbar(false) { }
+
+void VirtualList::setItemCount(int itemCount) {
+    mItemCount = std::max(itemCount, 0);
+    if (mSelectedIndex >= mItemCount)
+        mSelectedIndex = -1;
+    invalidateLayout();
+    refresh();
+}
+
+void VirtualList::setRowHeight(int rowHeight) {
+    mRowHeight = std::max(rowHeight, 1);
+    invalidateLayout();
+    refresh();
+}
+
+void VirtualList::setTextCallback(const std::function<std::string(int)> &callback) {
+    mTextCallback = callback;
+    refresh();
+}
+
+void VirtualList::setRowFactory(const std::function<Widget *(VirtualList *)> &factory) {
+    mRowFactory = factory;
+    while (!mRows.empty()) {
+        removeChild(mRows.back());
+        mRows.pop_back();
+    }
+    mRowItems.clear();
+    refresh();
+}
+
+void VirtualList::setRowBinder(const std::function<void(Widget *, int)> &binder) {
+    mRowBinder = binder;
+    refresh();
+}
+
+void VirtualList::setSelectedIndex(int index) {
+    if (index < -1 || index >= mItemCount)
+        index = -1;
+    if (index == mSelectedIndex)
+        return;
+    mSelectedIndex = index;
+    markDirty();
+}
+
+float VirtualList::scroll() const {
+    double range = contentHeight() - mSize.y();
+    return range > 0 ? (float) (mOffset / range) : 0.f;
+}
+
+void VirtualList::setScroll(float scroll) {
+    setOffset(scroll * (contentHeight() - mSize.y()));
+}
+
+void VirtualList::setOffset(double offset) {
+    offset = std::max(0.0, std::min(offset, contentHeight() - mSize.y()));
+    if (offset == mOffset)
+        return;
+    mOffset = offset;
+    updateRows(findContext(this));
+    markDirty();
+}
+
+void VirtualList::scrollToItem(int index) {
+    if (index < 0 || index >= mItemCount)
+        return;
+    double top = (double) index * mRowHeight;
+    if (top < mOffset)
+        setOffset(top);
+    else if (top + mRowHeight > mOffset + mSize.y())
+        setOffset(top + mRowHeight - mSize.y());
+}
+
+int VirtualList::itemAt(int y) const {
+    if (y < 0 || y >= mSize.y())
+        return -1;
+    int index = (int) ((mOffset + y) / mRowHeight);
+    return index < mItemCount ? index : -1;
+}
+
+void VirtualList::refresh() {
+    std::fill(mRowItems.begin(), mRowItems.end(), -1);
+    /* Clamps the offset in case the content became shorter */
+    double offset = mOffset;
+    mOffset = -1.0;
+    setOffset(offset);
+}
+
+void VirtualList::updateRows(NVGcontext *ctx) {
+    int needed = std::min(mSize.y() / mRowHeight + 2, mItemCount);
+    needed = std::max(needed, 0);
+
+    if ((int) mRows.size() != needed) {
+        while ((int) mRows.size() > needed) {
+            removeChild(mRows.back());
+            mRows.pop_back();
+        }
+        while ((int) mRows.size() < needed) {
+            Widget *row = mRowFactory ? mRowFactory(this) : new Label(this, "");
+            if (!row || row->parent() != this)
+                throw std::runtime_error(
+                    "VirtualList: the row factory must create a child of the list!");
+            mRows.push_back(row);
+        }
+        /* The mapping from items to rows depends on the number of rows */
+        mRowItems.assign(mRows.size(), -1);
+    }
+    if (mRows.empty())
+        return;
+
+    int first = (int) (mOffset / mRowHeight);
+    Vector2i rowSize(mSize.x() - scrollbarWidth - rowMargin, mRowHeight);
+    for (int item = first; item < first + needed; ++item) {
+        size_t slot = (size_t) item % mRows.size();
+        Widget *row = mRows[slot];
+        if (item >= mItemCount) {
+            row->setVisible(false);
+            mRowItems[slot] = -1;
+            continue;
+        }
+
+        row->setVisible(true);
+        row->setPosition(Vector2i(rowMargin, (int) std::floor(item * (double) mRowHeight - mOffset)));
+        row->setSize(rowSize);
+
+        /* Only rows that show a different item than before are bound again */
+        if (mRowItems[slot] != item) {
+            mRowItems[slot] = item;
+            if (mRowBinder) {
+                mRowBinder(row, item);
+            } else if (mTextCallback) {
+                Label *label = dynamic_cast<Label *>(row);
+                if (label)
+                    label->setCaption(mTextCallback(item));
+            }
+        }
+        if (ctx)
+            row->performLayoutIfNeeded(ctx);
+    }
+}
+
+void VirtualList::selectItem(int index) {
+    index = std::max(0, std::min(index, mItemCount - 1));
+    if (mItemCount == 0 || index == mSelectedIndex)
+        return;
+    setSelectedIndex(index);
+    scrollToItem(index);
+    if (mCallback)
+        mCallback(index);
+}
+
+Vector2i VirtualList::preferredSize(NVGcontext *) const {
+    return Vector2i(200, mRowHeight * std::max(1, std::min(mItemCount, 10)));
+}
+
+void VirtualList::performLayout(NVGcontext *ctx) {
+    /* The visible area may have changed, so check the number of rows and
+       clamp the offset before positioning them */
+    mOffset = std::max(0.0, std::min(mOffset, contentHeight() - mSize.y()));
+    updateRows(ctx);
+}
+
+bool VirtualList::mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) {
+    if (!down)
+        mDragScrollbar = false;
+
+    if (button == GLFW_MOUSE_BUTTON_1 && down && contentHeight() > mSize.y() &&
+        p.x() - mPos.x() >= mSize.x() - scrollbarWidth) {
+        mDragScrollbar = true;
+        requestFocus();
+        return true;
+    }
+
+    if (Widget::mouseButtonEvent(p, button, down, modifiers))
+        return true;
+
+    if (button == GLFW_MOUSE_BUTTON_1 && down) {
+        int index = itemAt(p.y() - mPos.y());
+        if (index >= 0)
+            selectItem(index);
+        return true;
+    }
+    return false;
+}
+
+bool VirtualList::mouseDragEvent(const Vector2i &, const Vector2i &rel,
+                                 int, int) {
+    if (!mDragScrollbar)
+        return false;
+    /* Move the content so that the scrollbar handle follows the cursor */
+    double range = contentHeight() - mSize.y();
+    float scrollh = std::max(mSize.y() * (float) (mSize.y() / contentHeight()), 8.f),
+          travel = mSize.y() - 8 - scrollh;
+    if (range > 0 && travel > 0)
+        setOffset(mOffset + rel.y() * range / travel);
+    return true;
+}
+
+bool VirtualList::scrollEvent(const Vector2i &, const Vector2f &rel) {
+    if (contentHeight() <= mSize.y())
+        return false;
+    setOffset(mOffset - rel.y() * 3 * mRowHeight);
+    return true;
+}
+
+bool VirtualList::keyboardEvent(int key, int /* scancode */, int action, int /* modifiers */) {
+    if (action != GLFW_PRESS && action != GLFW_REPEAT)
+        return false;
+
+    int page = std::max(1, mSize.y() / mRowHeight - 1);
+    int current = mSelectedIndex;
+    switch (key) {
+        case GLFW_KEY_UP:        selectItem(current < 0 ? 0 : current - 1); break;
+        case GLFW_KEY_DOWN:      selectItem(current + 1); break;
+        case GLFW_KEY_PAGE_UP:   selectItem(current - page); break;
+        case GLFW_KEY_PAGE_DOWN: selectItem(std::max(current, 0) + page); break;
+        case GLFW_KEY_HOME:      selectItem(0); break;
+        case GLFW_KEY_END:       selectItem(mItemCount - 1); break;
+        default: return false;
+    }
+    return true;
+}
+
+void VirtualList::draw(NVGcontext *ctx) {
+    int listWidth = mSize.x() - scrollbarWidth;
+
+    if (mSelectedIndex >= 0) {
+        float y = (float) (mSelectedIndex * (double) mRowHeight - mOffset);
+        if (y + mRowHeight > 0 && y < mSize.y()) {
+            nvgBeginPath(ctx);
+            nvgRect(ctx, mPos.x(), mPos.y() + y, listWidth, mRowHeight);
+            nvgFillColor(ctx, Color(255, mFocused ? 48 : 24));
+            nvgFill(ctx);
+        }
+    }
+
+    Widget::draw(ctx);
+
+    if (contentHeight() <= mSize.y())
+        return;
+
+    float visible = (float) (mSize.y() / contentHeight());
+    float scrollh = std::max(mSize.y() * visible, 8.f);
+
+    NVGpaint paint = nvgBoxGradient(
+        ctx, mPos.x() + listWidth + 1, mPos.y() + 4 + 1, 8,
+        mSize.y() - 8, 3, 4, Color(0, 32), Color(0, 92));
+    nvgBeginPath(ctx);
+    nvgRoundedRect(ctx, mPos.x() + listWidth, mPos.y() + 4, 8,
+                   mSize.y() - 8, 3);
+    nvgFillPaint(ctx, paint);
+    nvgFill(ctx);
+
+    float handle = mPos.y() + 4 + (mSize.y() - 8 - scrollh) * scroll();
+    paint = nvgBoxGradient(
+        ctx, mPos.x() + listWidth - 1, handle - 1, 8, scrollh,
+        3, 4, Color(220, 100), Color(128, 100));
+
+    nvgBeginPath(ctx);
+    nvgRoundedRect(ctx, mPos.x() + listWidth + 1, handle + 1, 8 - 2,
+                   scrollh - 2, 2);
+    nvgFillPaint(ctx, paint);
+    nvgFill(ctx);
+}
+
+void VirtualList::save(Serializer &s) const {
+    Widget::save(s);
+    s.set("rowHeight", mRowHeight);
+    s.set("selectedIndex", mSelectedIndex);
+    s.set("offset", mOffset);
+}
+
+bool VirtualList::load(Serializer &s) {
+    if (!Widget::load(s)) return false;
+    if (!s.get("rowHeight", mRowHeight)) return false;
+    if (!s.get("selectedIndex", mSelectedIndex)) return false;
+    if (!s.get("offset", mOffset)) return false;
+    mRowHeight = std::max(mRowHeight, 1);
+    if (mSelectedIndex < -1 || mSelectedIndex >= mItemCount)
+        mSelectedIndex = -1;
+    /* Clamp the offset to the current items and bind the visible rows */
+    invalidateLayout();
+    refresh();
+    return true;
+}
+
+NAMESPACE_END(nanogui)
@@ -29,7 +29,7 @@ void VScrollPanel::performLayout(NVGcontext *ctx) {
         throw std::runtime_error("VScrollPanel should have one child.");
 
     Widget *child = mChildren[0];
-    mChildPreferredHeight = child->preferredSize(ctx).y();
+    mChildPreferredHeight = child->cachedPreferredSize(ctx).y();
 
     if (mChildPreferredHeight > mSize.y()) {
         child->setPosition(Vector2i(0, -mScroll*(mChildPreferredHeight - mSize.y())));
@@ -39,13 +39,13 @@ void VScrollPanel::performLayout(NVGcontext *ctx) {
         child->setSize(mSize);
         mScroll = 0;
     }
-    child->performLayout(ctx);
+    child->performLayoutIfNeeded(ctx);
 }
 
 Vector2i VScrollPanel::preferredSize(NVGcontext *ctx) const {
     if (mChildren.empty())
         return Vector2i::Zero();
-    return mChildren[0]->preferredSize(ctx) + Vector2i(12, 0);
+    return mChildren[0]->cachedPreferredSize(ctx) + Vector2i(12, 0);
 }
 
 bool VScrollPanel::mouseDragEvent(const Vector2i &p, const Vector2i &rel,
@@ -83,7 +83,7 @@ void VScrollPanel::draw(NVGcontext *ctx) {
         return;
     Widget *child = mChildren[0];
     child->setPosition(Vector2i(0, -mScroll*(mChildPreferredHeight - mSize.y())));
-    mChildPreferredHeight = child->preferredSize(ctx).y();
+    mChildPreferredHeight = child->cachedPreferredSize(ctx).y();
     float scrollh = height() *
         std::min(1.0f, height() / (float) mChildPreferredHeight);
 
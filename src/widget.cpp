@@ -15,25 +15,58 @@
 #include <nanogui/window.h>
 #include <nanogui/opengl.h>
 #include <nanogui/screen.h>
+#include <nanogui/drawcache.h>
+#include <nanogui/profiler.h>
+#include <nanogui/spatialindex.h>
+#include <nanogui/threadpool.h>
 #include <nanogui/serializer/core.h>
 
 NAMESPACE_BEGIN(nanogui)
 
+bool Widget::sParallelLayout = false;
+
+/* Root of the subtree that the current thread lays out during a parallel
+   layout. Changes are not propagated beyond it (see Widget::markDirty() and
+   Widget::invalidateLayout()). */
+static thread_local Widget *layoutBoundary = nullptr;
+
 Widget::Widget(Widget *parent)
     : mParent(nullptr), mTheme(nullptr), mLayout(nullptr),
       mPos(Vector2i::Zero()), mSize(Vector2i::Zero()),
       mFixedSize(Vector2i::Zero()), mVisible(true), mEnabled(true),
       mFocused(false), mMouseFocus(false), mTooltip(""), mFontSize(-1.0f),
-      mIconExtraScale(1.0f), mCursor(Cursor::Arrow) {
+      mIconExtraScale(1.0f), mCursor(Cursor::Arrow), mDirty(true),
+      mCulled(false), mCacheMode(CacheMode::Disabled), mDrawCache(nullptr),
+      mSpatialIndex(nullptr), mSpatialIndexValid(false),
+      mPreferredSize(Vector2i::Zero()), mPreferredSizeValid(false),
+      mLayoutValid(false) {
     if (parent)
         parent->addChild(this);
 }
 
 Widget::~Widget() {
+    setLayout(nullptr);
     for (auto child : mChildren) {
         if (child)
             child->decRef();
     }
+    delete mDrawCache;
+    delete mSpatialIndex;
+}
+
+void Widget::setLayout(Layout *layout) {
+    if (mLayout.get() == layout)
+        return;
+    /* Register with the layout, whose setters invalidate this widget */
+    if (mLayout) {
+        auto &widgets = mLayout->mWidgets;
+        widgets.erase(std::remove(widgets.begin(), widgets.end(), this), widgets.end());
+    }
+    mLayout = layout;
+    if (layout)
+        layout->mWidgets.push_back(this);
+    invalidateLayout();
+    markDirty();
 }
 
 void Widget::setTheme(Theme *theme) {
@@ -42,6 +75,8 @@ void Widget::setTheme(Theme *theme) {
     mTheme = theme;
     for (auto child : mChildren)
         child->setTheme(theme);
+    invalidateLayout();
+    markDirty();
 }
 
 int Widget::fontSize() const {
@@ -55,22 +90,124 @@ Vector2i Widget::preferredSize(NVGcontext *ctx) const {
         return mSize;
 }
 
+Vector2i Widget::cachedPreferredSize(NVGcontext *ctx) const {
+    if (!mPreferredSizeValid) {
+        mPreferredSize = preferredSize(ctx);
+        mPreferredSizeValid = true;
+    }
+    return mPreferredSize;
+}
+
 void Widget::performLayout(NVGcontext *ctx) {
     if (mLayout) {
         mLayout->performLayout(ctx, this);
     } else {
         for (auto c : mChildren) {
-            Vector2i pref = c->preferredSize(ctx), fix = c->fixedSize();
+            Vector2i pref = c->cachedPreferredSize(ctx), fix = c->fixedSize();
             c->setSize(Vector2i(
                 fix[0] ? fix[0] : pref[0],
                 fix[1] ? fix[1] : pref[1]
             ));
-            c->performLayout(ctx);
+            c->performLayoutIfNeeded(ctx);
+        }
+    }
+}
+
+void Widget::performLayoutIfNeeded(NVGcontext *ctx) {
+    if (mLayoutValid)
+        return;
+    performLayout(ctx);
+    /* Changes made by the layout itself (e.g. resized children) invalidate
+       this widget again, but are accounted for at this point */
+    mLayoutValid = true;
+}
+
+void Widget::parallelLayoutFor(const std::vector<Widget *> &widgets,
+                               const std::function<void(Widget *)> &func) {
+    /* Put the parents into the state that changes to their descendants
+       would produce. The concurrent tasks stop propagating changes at the
+       roots of their subtrees, hence the shared ancestors are only read. */
+    Widget *parent = nullptr;
+    for (auto widget : widgets) {
+        if (widget->mParent && widget->mParent != parent) {
+            parent = widget->mParent;
+            parent->invalidateLayout();
+            parent->markDirty();
         }
     }
+
+    ThreadPool::shared()->parallelFor(widgets.size(), [&](size_t i) {
+        Widget *boundary = layoutBoundary;
+        layoutBoundary = widgets[i];
+        try {
+            func(widgets[i]);
+        } catch (...) {
+            layoutBoundary = boundary;
+            throw;
+        }
+        layoutBoundary = boundary;
+    });
+}
+
+void Widget::cachePreferredSizes(NVGcontext *ctx, const std::vector<Widget *> &widgets) {
+    if (!sParallelLayout)
+        return;
+    parallelLayoutFor(widgets, [ctx](Widget *widget) {
+        widget->cachedPreferredSize(ctx);
+    });
+}
+
+void Widget::performLayouts(NVGcontext *ctx, const std::vector<Widget *> &widgets) {
+    if (!sParallelLayout) {
+        for (auto widget : widgets)
+            widget->performLayoutIfNeeded(ctx);
+        return;
+    }
+    parallelLayoutFor(widgets, [ctx](Widget *widget) {
+        widget->performLayoutIfNeeded(ctx);
+    });
+}
+
+void Widget::invalidateLayout() {
+    /* Always walk up to the root (or the subtree of a concurrent layout):
+       ancestors may have been laid out again in the meantime without
+       visiting this widget (e.g. while invisible) */
+    for (Widget *widget = this; widget; widget = widget->mParent) {
+        widget->mPreferredSizeValid = widget->mLayoutValid = false;
+        if (widget == layoutBoundary)
+            break;
+    }
+}
+
+void Widget::setSpatialIndex(bool enabled) {
+    if (enabled && !mSpatialIndex) {
+        mSpatialIndex = new SpatialIndex();
+        mSpatialIndexValid = false;
+    } else if (!enabled) {
+        delete mSpatialIndex;
+        mSpatialIndex = nullptr;
+    }
+}
+
+const SpatialIndex *Widget::updateSpatialIndex() {
+    if (mSpatialIndex && !mSpatialIndexValid) {
+        mSpatialIndex->build(mChildren);
+        mSpatialIndexValid = true;
+    }
+    return mSpatialIndex;
 }
 
 Widget *Widget::findWidget(const Vector2i &p) {
+    if (const SpatialIndex *index = updateSpatialIndex()) {
+        SpatialIndex::Range range = index->query(p - mPos);
+        for (const uint32_t *it = range.end(); it != range.begin(); ) {
+            Widget *child = mChildren[*--it];
+            if (child->visible() && child->contains(p - mPos))
+                return child->findWidget(p - mPos);
+        }
+        return contains(p) ? this : nullptr;
+    }
+
     for (auto it = mChildren.rbegin(); it != mChildren.rend(); ++it) {
         Widget *child = *it;
         if (child->visible() && child->contains(p - mPos))
@@ -80,11 +217,21 @@ Widget *Widget::findWidget(const Vector2i &p) {
 }
 
 bool Widget::mouseButtonEvent(const Vector2i &p, int button, bool down, int modifiers) {
-    for (auto it = mChildren.rbegin(); it != mChildren.rend(); ++it) {
-        Widget *child = *it;
-        if (child->visible() && child->contains(p - mPos) &&
-            child->mouseButtonEvent(p - mPos, button, down, modifiers))
-            return true;
+    if (const SpatialIndex *index = updateSpatialIndex()) {
+        SpatialIndex::Range range = index->query(p - mPos);
+        for (const uint32_t *it = range.end(); it != range.begin(); ) {
+            Widget *child = mChildren[*--it];
+            if (child->visible() && child->contains(p - mPos) &&
+                child->mouseButtonEvent(p - mPos, button, down, modifiers))
+                return true;
+        }
+    } else {
+        for (auto it = mChildren.rbegin(); it != mChildren.rend(); ++it) {
+            Widget *child = *it;
+            if (child->visible() && child->contains(p - mPos) &&
+                child->mouseButtonEvent(p - mPos, button, down, modifiers))
+                return true;
+        }
     }
     if (button == GLFW_MOUSE_BUTTON_1 && down && !mFocused)
         requestFocus();
@@ -92,21 +239,53 @@ bool Widget::mouseButtonEvent(const Vector2i &p, int button, bool down, int modi
 }
 
 bool Widget::mouseMotionEvent(const Vector2i &p, const Vector2i &rel, int button, int modifiers) {
-    for (auto it = mChildren.rbegin(); it != mChildren.rend(); ++it) {
-        Widget *child = *it;
+    auto visit = [&](Widget *child) {
         if (!child->visible())
-            continue;
+            return false;
         bool contained = child->contains(p - mPos), prevContained = child->contains(p - mPos - rel);
         if (contained != prevContained)
             child->mouseEnterEvent(p, contained);
-        if ((contained || prevContained) &&
-            child->mouseMotionEvent(p - mPos, rel, button, modifiers))
+        return (contained || prevContained) &&
+            child->mouseMotionEvent(p - mPos, rel, button, modifiers);
+    };
+
+    if (const SpatialIndex *index = updateSpatialIndex()) {
+        /* Children under the current or the previous position, front to back */
+        SpatialIndex::Range cur = index->query(p - mPos), prev = index->query(p - mPos - rel);
+        const uint32_t *a = cur.end(), *b = prev.end();
+        while (a != cur.begin() || b != prev.begin()) {
+            uint32_t i;
+            if (b == prev.begin() || (a != cur.begin() && a[-1] > b[-1]))
+                i = *--a;
+            else if (a == cur.begin() || b[-1] > a[-1])
+                i = *--b;
+            else
+                i = (--a, *--b);
+            if (visit(mChildren[i]))
+                return true;
+        }
+        return false;
+    }
+
+    for (auto it = mChildren.rbegin(); it != mChildren.rend(); ++it) {
+        if (visit(*it))
             return true;
     }
     return false;
 }
 
 bool Widget::scrollEvent(const Vector2i &p, const Vector2f &rel) {
+    if (const SpatialIndex *index = updateSpatialIndex()) {
+        SpatialIndex::Range range = index->query(p - mPos);
+        for (const uint32_t *it = range.end(); it != range.begin(); ) {
+            Widget *child = mChildren[*--it];
+            if (child->visible() && child->contains(p - mPos) &&
+                child->scrollEvent(p - mPos, rel))
+                return true;
+        }
+        return false;
+    }
+
     for (auto it = mChildren.rbegin(); it != mChildren.rend(); ++it) {
         Widget *child = *it;
         if (!child->visible())
@@ -123,11 +302,13 @@ bool Widget::mouseDragEvent(const Vector2i &, const Vector2i &, int, int) {
 
 bool Widget::mouseEnterEvent(const Vector2i &, bool enter) {
     mMouseFocus = enter;
+    markDirty();
     return false;
 }
 
 bool Widget::focusEvent(bool focused) {
     mFocused = focused;
+    markDirty();
     return false;
 }
 
@@ -142,9 +323,12 @@ bool Widget::keyboardCharacterEvent(unsigned int) {
 void Widget::addChild(int index, Widget * widget) {
     assert(index <= childCount());
     mChildren.insert(mChildren.begin() + index, widget);
+    mSpatialIndexValid = false;
     widget->incRef();
     widget->setParent(this);
     widget->setTheme(mTheme);
+    invalidateLayout();
+    markDirty();
 }
 
 void Widget::addChild(Widget * widget) {
@@ -153,13 +337,19 @@ void Widget::addChild(Widget * widget) {
 
 void Widget::removeChild(const Widget *widget) {
     mChildren.erase(std::remove(mChildren.begin(), mChildren.end(), widget), mChildren.end());
+    mSpatialIndexValid = false;
     widget->decRef();
+    invalidateLayout();
+    markDirty();
 }
 
 void Widget::removeChild(int index) {
     Widget *widget = mChildren[index];
     mChildren.erase(mChildren.begin() + index);
+    mSpatialIndexValid = false;
     widget->decRef();
+    invalidateLayout();
+    markDirty();
 }
 
 int Widget::childIndex(Widget *widget) const {
@@ -202,6 +392,110 @@ void Widget::requestFocus() {
     ((Screen *) widget)->updateFocus(this);
 }
 
+void Widget::markDirty() {
+    mDirty = true;
+    if (mDrawCache)
+        mDrawCache->clear();
+    markMoved();
+}
+
+void Widget::markMoved() {
+    /* Flag all ancestors while accumulating the absolute position */
+    Widget *widget = this;
+    Vector2i pos = mPos;
+    while (widget != layoutBoundary && widget->mParent) {
+        widget = widget->mParent;
+        widget->mDirty = true;
+        if (widget->mDrawCache)
+            widget->mDrawCache->clear();
+        pos += widget->mPos;
+    }
+
+    /* During a parallel layout, the ancestors beyond the subtree of this
+       thread were prepared beforehand (see parallelLayoutFor()), and the
+       whole screen is damaged */
+    if (widget == layoutBoundary)
+        return;
+
+    /* Report the damaged region if the widget is attached to a screen */
+    Screen *screen = dynamic_cast<Screen *>(widget);
+    if (screen)
+        screen->addDamage(this, pos);
+}
+
+void Widget::scheduleRedrawAt(double time) {
+    Widget *widget = this;
+    while (widget->mParent)
+        widget = widget->mParent;
+    Screen *screen = dynamic_cast<Screen *>(widget);
+    if (screen)
+        screen->scheduleRedraw(this, time);
+}
+
+void Widget::clearDirty() {
+    mDirty = false;
+    for (auto child : mChildren) {
+        if (child->mDirty)
+            child->clearDirty();
+    }
+}
+
+void Widget::setCacheMode(CacheMode mode) {
+    mCacheMode = mode;
+    if (mode == CacheMode::Disabled) {
+        delete mDrawCache;
+        mDrawCache = nullptr;
+    }
+    markDirty();
+}
+
+void Widget::drawCached(NVGcontext *ctx) {
+    /* The recorded vertices are in absolute coordinates, so the recording is
+       keyed on the current transform, the pixel ratio, and the clip region
+       (the bounds of this widget intersected with those of its ancestors,
+       see Widget::draw()) */
+    DrawCache::Key key;
+    nvgCurrentTransform(ctx, key.data());
+
+    Vector2i p0 = mPos, p1 = mPos + mSize;
+    Widget *widget = mParent;
+    while (widget && widget->mParent) {
+        p0 = (p0 + widget->mPos).cwiseMax(widget->mPos);
+        p1 = (p1 + widget->mPos).cwiseMin(widget->mPos + widget->mSize);
+        widget = widget->mParent;
+    }
+    Screen *screen = dynamic_cast<Screen *>(widget);
+    if (widget) {
+        p0 += widget->mPos;
+        p1 += widget->mPos;
+    }
+    key[6] = (float) p0.x(); key[7] = (float) p0.y();
+    key[8] = (float) p1.x(); key[9] = (float) p1.y();
+    key[10] = screen ? screen->pixelRatio() : 1.f;
+
+    if (!mDrawCache)
+        mDrawCache = new DrawCache();
+    if (mDrawCache->valid(key) && mDrawCache->replay(ctx))
+        return;
+
+    /* Don't record while the screen only redraws a part of itself (the output
+       would be clipped to that region), or after recording already failed */
+    if ((screen && screen->mRedrawRegion.tail<2>().prod() != 0) ||
+        mDrawCache->failed()) {
+        draw(ctx);
+        return;
+    }
+
+    mDrawCache->begin(ctx, key);
+    try {
+        draw(ctx);
+    } catch (...) {
+        mDrawCache->end();
+        throw;
+    }
+    mDrawCache->end();
+}
+
 void Widget::draw(NVGcontext *ctx) {
     #if NANOGUI_SHOW_WIDGET_BOUNDS
         nvgStrokeWidth(ctx, 1.0f);
@@ -214,13 +508,22 @@ void Widget::draw(NVGcontext *ctx) {
     if (mChildren.empty())
         return;
 
+    FrameProfiler *profiler = FrameProfiler::active();
+
     nvgSave(ctx);
     nvgTranslate(ctx, mPos.x(), mPos.y());
     for (auto child : mChildren) {
-        if (child->visible()) {
+        if (child->visible() && !child->mCulled) {
             nvgSave(ctx);
             nvgIntersectScissor(ctx, child->mPos.x(), child->mPos.y(), child->mSize.x(), child->mSize.y());
-            child->draw(ctx);
+            if (profiler)
+                profiler->beginWidget();
+            if (child->mCacheMode == CacheMode::Retained)
+                child->drawCached(ctx);
+            else
+                child->draw(ctx);
+            if (profiler)
+                profiler->endWidget(child);
             nvgRestore(ctx);
         }
     }
@@ -249,6 +552,8 @@ bool Widget::load(Serializer &s) {
     if (!s.get("tooltip", mTooltip)) return false;
     if (!s.get("fontSize", mFontSize)) return false;
     if (!s.get("cursor", mCursor)) return false;
+    invalidateLayout();
+    markDirty();
     return true;
 }
 
@@ -12,14 +12,24 @@
 #include <nanogui/window.h>
 #include <nanogui/theme.h>
 #include <nanogui/opengl.h>
+#include <nanogui/textmetrics.h>
 #include <nanogui/screen.h>
 #include <nanogui/layout.h>
 #include <nanogui/serializer/core.h>
+#include <nanovg_gl.h>
+#include <nanovg_gl_utils.h>
 
 NAMESPACE_BEGIN(nanogui)
 
 Window::Window(Widget *parent, const std::string &title)
-    : Widget(parent), mTitle(title), mButtonPanel(nullptr), mModal(false), mDrag(false) { }
+    : Widget(parent), mTitle(title), mButtonPanel(nullptr), mModal(false), mDrag(false),
+      mLayerCaching(false), mLayerValid(false), mDrawingLayer(false), mLayer(nullptr),
+      mLayerSize(Vector2i::Zero()), mLayerPixelRatio(0.f) { }
+
+Window::~Window() {
+    if (mLayer)
+        nvgluDeleteFramebuffer(mLayer);
+}
 
 Vector2i Window::preferredSize(NVGcontext *ctx) const {
     if (mButtonPanel)
@@ -28,10 +38,9 @@ Vector2i Window::preferredSize(NVGcontext *ctx) const {
     if (mButtonPanel)
         mButtonPanel->setVisible(true);
 
-    nvgFontSize(ctx, 18.0f);
-    nvgFontFace(ctx, "sans-bold");
     float bounds[4];
-    nvgTextBounds(ctx, 0, 0, mTitle.c_str(), nullptr, bounds);
+    textBounds(ctx, "sans-bold", 18.0f, NVG_ALIGN_LEFT | NVG_ALIGN_TOP, 0, 0,
+               mTitle, bounds);
 
     return result.cwiseMax(Vector2i(
         bounds[2]-bounds[0] + 20, bounds[3]-bounds[1]
@@ -58,8 +67,8 @@ void Window::performLayout(NVGcontext *ctx) {
         }
         mButtonPanel->setVisible(true);
         mButtonPanel->setSize(Vector2i(width(), 22));
-        mButtonPanel->setPosition(Vector2i(width() - (mButtonPanel->preferredSize(ctx).x() + 5), 3));
-        mButtonPanel->performLayout(ctx);
+        mButtonPanel->setPosition(Vector2i(width() - (mButtonPanel->cachedPreferredSize(ctx).x() + 5), 3));
+        mButtonPanel->performLayoutIfNeeded(ctx);
     }
 }
 
@@ -67,6 +76,23 @@ void Window::draw(NVGcontext *ctx) {
     int ds = mTheme->mWindowDropShadowSize, cr = mTheme->mWindowCornerRadius;
     int hh = mTheme->mWindowHeaderHeight;
 
+    if (mLayerCaching && mLayerValid && !mDrawingLayer) {
+        /* Composite the cached layer, which includes the drop shadow */
+        Vector2f extent = mLayerSize.cast<float>() / mLayerPixelRatio;
+        NVGpaint layerPaint = nvgImagePattern(
+            ctx, mPos.x() - ds, mPos.y() - ds, extent.x(), extent.y(), 0.f,
+            mLayer->image, 1.f);
+
+        nvgSave(ctx);
+        nvgResetScissor(ctx);
+        nvgBeginPath(ctx);
+        nvgRect(ctx, mPos.x() - ds, mPos.y() - ds, extent.x(), extent.y());
+        nvgFillPaint(ctx, layerPaint);
+        nvgFill(ctx);
+        nvgRestore(ctx);
+        return;
+    }
+
     /* Draw window */
     nvgSave(ctx);
     nvgBeginPath(ctx);
@@ -141,6 +167,68 @@ void Window::draw(NVGcontext *ctx) {
     Widget::draw(ctx);
 }
 
+void Window::setLayerCaching(bool layerCaching) {
+    mLayerCaching = layerCaching;
+    mLayerValid = false;
+    if (!layerCaching && mLayer) {
+        nvgluDeleteFramebuffer(mLayer);
+        mLayer = nullptr;
+    }
+    markDirty();
+}
+
+void Window::updateLayer(NVGcontext *ctx, float pixelRatio) {
+    if (!mLayerCaching)
+        return;
+
+    int ds = mTheme->mWindowDropShadowSize;
+    Vector2i size = ((mSize + Vector2i::Constant(2 * ds)).cast<float>() * pixelRatio)
+                        .array().ceil().cast<int>().matrix();
+
+    if (mLayerValid && size == mLayerSize && pixelRatio == mLayerPixelRatio)
+        return;
+
+    if (mLayer && size != mLayerSize) {
+        nvgluDeleteFramebuffer(mLayer);
+        mLayer = nullptr;
+    }
+    if (!mLayer) {
+        mLayer = nvgluCreateFramebuffer(ctx, size.x(), size.y(), 0);
+        if (!mLayer)
+            throw std::runtime_error("Window::updateLayer(): could not create framebuffer!");
+        mLayerSize = size;
+    }
+    mLayerPixelRatio = pixelRatio;
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    nvgluBindFramebuffer(mLayer);
+    glViewport(0, 0, size.x(), size.y());
+    glDisable(GL_SCISSOR_TEST);
+    glClearColor(0.f, 0.f, 0.f, 0.f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+    /* Draw as usual, but shifted so that the drop shadow fits into the layer */
+    Vector2f extent = size.cast<float>() / pixelRatio;
+    nvgBeginFrame(ctx, extent.x(), extent.y(), pixelRatio);
+    nvgTranslate(ctx, ds - mPos.x(), ds - mPos.y());
+    nvgScissor(ctx, mPos.x(), mPos.y(), mSize.x(), mSize.y());
+    mDrawingLayer = true;
+    draw(ctx);
+    mDrawingLayer = false;
+    nvgEndFrame(ctx);
+
+    nvgluBindFramebuffer(nullptr);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    mLayerValid = true;
+}
+
+void Window::clearDirty() {
+    /* Something in this window changed, so the layer must be rendered again */
+    mLayerValid = false;
+    Widget::clearDirty();
+}
+
 void Window::dispose() {
     Widget *widget = this;
     while (widget->parent())
@@ -158,9 +246,9 @@ void Window::center() {
 bool Window::mouseDragEvent(const Vector2i &, const Vector2i &rel,
                             int button, int /* modifiers */) {
     if (mDrag && (button & (1 << GLFW_MOUSE_BUTTON_1)) != 0) {
-        mPos += rel;
-        mPos = mPos.cwiseMax(Vector2i::Zero());
-        mPos = mPos.cwiseMin(parent()->size() - mSize);
+        /* Only damages the old and new bounds, the layer remains valid */
+        Vector2i pos = (mPos + rel).cwiseMax(Vector2i::Zero());
+        setPosition(pos.cwiseMin(parent()->size() - mSize));
         return true;
     }
     return false;